@@ -0,0 +1,890 @@
+/** @file
+ * Program mierzący wydajność wybranych operacji na mapie dróg krajowych.
+ *
+ * Użycie: benchmark NAZWA [PARAMETRY...], gdzie NAZWA wybiera pomiar. Każdy
+ * pomiar, oprócz czasu, sprawdza zgodność wyników z implementacją wzorcową
+ * i kończy program z kodem 1, jeśli wyniki się różnią.
+ *
+ * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
+ * @date 01.09.2019
+ */
+
+#ifdef _STDC_ALLOC_LIB_
+#define _STDC_WANT_LIB_EXT2_ 1
+#else
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "map.h"
+#include "input.h"
+#include "scan.h"
+#include "binary.h"
+
+#define NAME_LENGTH 16 ///< Długość bufora na nazwę miasta.
+
+/**
+ * Podaje bieżący czas w milisekundach.
+ * @return Zwraca czas od nieokreślonego momentu w przeszłości.
+ */
+static double now(void) {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+}
+
+/**
+ * Odczytuje liczbę z parametrów programu.
+ * @param argc - liczba parametrów;
+ * @param argv - tablica parametrów;
+ * @param index - numer parametru;
+ * @param value - wartość domyślna.
+ * @return Zwraca wartość parametru lub wartość domyślną, jeśli go nie ma.
+ */
+static unsigned argument(int argc, char **argv, int index, unsigned value) {
+  if (index < argc) {
+    return (unsigned) strtoul(argv[index], NULL, 10);
+  }
+  return value;
+}
+
+/**
+ * Generator liczb pseudolosowych, niezależny od implementacji rand().
+ * @param state - wskaźnik na stan generatora.
+ * @return Zwraca kolejną liczbę pseudolosową.
+ */
+static unsigned random32(unsigned long long *state) {
+  *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return (unsigned) (*state >> 33);
+}
+
+/**
+ * Zapisuje nazwę miasta o podanym numerze.
+ * @param name - bufor na nazwę;
+ * @param number - numer miasta.
+ */
+static void cityName(char *name, unsigned number) {
+  snprintf(name, NAME_LENGTH, "m%u", number);
+}
+
+/**
+ * Tworzy mapę w kształcie kwadratowej siatki z losowymi długościami i latami
+ * budowy odcinków dróg oraz podaną liczbą dłuższych odcinków między losowymi
+ * miastami.
+ * @param side - długość boku siatki;
+ * @param shortcuts - liczba dłuższych odcinków;
+ * @param seed - ziarno generatora liczb losowych.
+ * @return Zwraca utworzoną mapę lub NULL, jeśli nie udało się zaalokować
+ * pamięci.
+ */
+static Map *gridMap(unsigned side, unsigned shortcuts,
+                    unsigned long long seed) {
+  Map *map = newMap();
+  if (!map) {
+    return NULL;
+  }
+  char name1[NAME_LENGTH], name2[NAME_LENGTH];
+  for (unsigned i = 0; i < side * side; i++) {
+    cityName(name1, i);
+    if (i % side + 1 < side) {
+      cityName(name2, i + 1);
+      addRoad(map, name1, name2, 1 + random32(&seed) % 100,
+              1900 + (int) (random32(&seed) % 120));
+    }
+    if (i + side < side * side) {
+      cityName(name2, i + side);
+      addRoad(map, name1, name2, 1 + random32(&seed) % 100,
+              1900 + (int) (random32(&seed) % 120));
+    }
+  }
+  for (unsigned i = 0; i < shortcuts; i++) {
+    cityName(name1, random32(&seed) % (side * side));
+    cityName(name2, random32(&seed) % (side * side));
+    addRoad(map, name1, name2, 100 + random32(&seed) % 5000,
+            1900 + (int) (random32(&seed) % 120));
+  }
+  return map;
+}
+
+/**
+ * Porównuje dwa wyniki wyszukiwania z jednego miasta: zbiory osiągniętych
+ * miast, odległości i daty najstarszych remontów oraz poprawność poprzednich
+ * miast w drugim wyniku.
+ * @param expected - wynik wzorcowy;
+ * @param actual - wynik sprawdzany;
+ * @param cities - liczba miast na mapie.
+ * @return Zwraca liczbę różnic.
+ */
+static unsigned compareReachable(ReachableCities *expected,
+        ReachableCities *actual, unsigned cities) {
+  ReachedCity **byIndex = calloc(cities, sizeof(ReachedCity *));
+  if (!byIndex) {
+    return 1;
+  }
+  unsigned errors = (expected->number != actual->number);
+  for (unsigned i = 0; i < expected->number; i++) {
+    byIndex[expected->cities[i].city->citiesArrayIndex] = &(expected->cities[i]);
+  }
+  for (unsigned i = 0; i < actual->number; i++) {
+    ReachedCity *reached = &(actual->cities[i]);
+    ReachedCity *reference = byIndex[reached->city->citiesArrayIndex];
+    if (!reference || reference->distance != reached->distance ||
+        reference->oldestRoad != reached->oldestRoad) {
+      errors++;
+      continue;
+    }
+    if (i > 0 && (reached->distance < actual->cities[i - 1].distance)) {
+      errors++;
+    }
+    if (reached->previous) {
+      ReachedCity *previous = byIndex[reached->previous->citiesArrayIndex];
+      if (!previous || previous->distance + reached->connection->length !=
+          reached->distance) {
+        errors++;
+      }
+    }
+  }
+  free(byIndex);
+  return errors;
+}
+
+/**
+ * Pomiar wyszukiwań z jednego miasta do wszystkich oraz między zbiorami miast:
+ * algorytm Dijkstry w porównaniu z równoległym algorytmem delta-stepping.
+ * Parametry: długość boku siatki, liczba wątków, liczba miast początkowych.
+ * @param argc - liczba parametrów;
+ * @param argv - tablica parametrów.
+ * @return Zwraca 0, jeśli wyniki są zgodne, a 1 w przeciwnym razie.
+ */
+static int benchmarkSearch(int argc, char **argv) {
+  unsigned side = argument(argc, argv, 2, 60);
+  unsigned threads = argument(argc, argv, 3, 4);
+  unsigned sources = argument(argc, argv, 4, 4);
+  unsigned long long seed = 2019;
+  Map *map = gridMap(side, side * side / 10, seed);
+  ReachableCities *expected = newReachableCities();
+  ReachableCities *actual = newReachableCities();
+  char **names = malloc(sources * sizeof(char *));
+  ReachedCity *distances = malloc(sources * sources * sizeof(ReachedCity));
+  if (!map || !expected || !actual || !names || !distances) {
+    fprintf(stderr, "memory error\n");
+    return 1;
+  }
+  unsigned cities = side * side;
+  for (unsigned i = 0; i < sources; i++) {
+    names[i] = malloc(NAME_LENGTH);
+    cityName(names[i], random32(&seed) % cities);
+  }
+  double sequential = 0, parallel = 0;
+  unsigned errors = 0;
+  for (unsigned i = 0; i < sources; i++) {
+    setSearchThreads(map, 0);
+    double time = now();
+    reachableCities(map, names[i], 0, expected);
+    sequential += now() - time;
+    if (!setSearchThreads(map, threads)) {
+      fprintf(stderr, "cannot start threads\n");
+      return 1;
+    }
+    time = now();
+    reachableCities(map, names[i], 0, actual);
+    parallel += now() - time;
+    errors += compareReachable(expected, actual, cities);
+  }
+  double manyToMany = now();
+  routeDistances(map, (const char **) names, sources, (const char **) names,
+                 sources, distances);
+  manyToMany = now() - manyToMany;
+  setSearchThreads(map, 0);
+  for (unsigned i = 0; i < sources; i++) {
+    reachableCities(map, names[i], 0, expected);
+    for (unsigned j = 0; j < sources; j++) {
+      ReachedCity *reached = &(distances[i * sources + j]);
+      bool found = false;
+      for (unsigned k = 0; k < expected->number && !found; k++) {
+        ReachedCity *reference = &(expected->cities[k]);
+        if (strcmp(reference->city->name, names[j]) == 0) {
+          found = true;
+          errors += (!reached->city || reference->distance != reached->distance ||
+                     reference->oldestRoad != reached->oldestRoad);
+        }
+      }
+      errors += (!found && reached->city);
+    }
+  }
+  printf("cities: %u, sources: %u, threads: %u\n", cities, sources, threads);
+  printf("one-to-all dijkstra:       %10.3f ms/search\n", sequential / sources);
+  printf("one-to-all delta-stepping: %10.3f ms/search\n", parallel / sources);
+  printf("many-to-many %ux%u:         %10.3f ms\n", sources, sources,
+         manyToMany);
+  printf("mismatches: %u\n", errors);
+  for (unsigned i = 0; i < sources; i++) {
+    free(names[i]);
+  }
+  free(names);
+  free(distances);
+  freeReachableCities(expected);
+  freeReachableCities(actual);
+  deleteMap(map);
+  return errors > 0;
+}
+
+/**
+ * Pomiar wyszukiwań między parami miast za pomocą nakładki podziału mapy
+ * w porównaniu z przeszukiwaniem całej mapy, razem z kosztem przeliczania
+ * komórek po remontach i usunięciach odcinków dróg. Parametry: długość boku
+ * siatki, liczba zapytań, liczba zmian odcinków dróg, liczba dłuższych
+ * odcinków między losowymi miastami.
+ * @param argc - liczba parametrów;
+ * @param argv - tablica parametrów.
+ * @return Zwraca 0, jeśli wyniki są zgodne, a 1 w przeciwnym razie.
+ */
+static int benchmarkOverlay(int argc, char **argv) {
+  unsigned side = argument(argc, argv, 2, 100);
+  unsigned queries = argument(argc, argv, 3, 200);
+  unsigned updates = argument(argc, argv, 4, 50);
+  unsigned shortcuts = argument(argc, argv, 5, 0);
+  unsigned long long seed = 2019;
+  Map *map = gridMap(side, shortcuts, seed);
+  if (!map || side < 2 || !enableOverlay(map, true)) {
+    fprintf(stderr, "memory error\n");
+    return 1;
+  }
+  unsigned cities = side * side;
+  char name1[NAME_LENGTH], name2[NAME_LENGTH];
+  const char *source[1] = {name1}, *target[1] = {name2};
+  ReachedCity expected, actual;
+  double build = now();
+  cityName(name1, 0);
+  overlayRouteDistance(map, name1, name1, &actual);
+  build = now() - build;
+  double full = 0, overlay = 0, update = 0;
+  unsigned errors = 0;
+  int year = 2020;
+  for (unsigned i = 0; i < queries + updates; i++) {
+    if (i >= queries) {
+      unsigned city = random32(&seed) % cities;
+      if (city % side + 1 == side) {
+        city--;
+      }
+      cityName(name1, city);
+      cityName(name2, city + 1);
+      double time = now();
+      if (i % 2) {
+        repairRoad(map, name1, name2, year++);
+      }
+      else {
+        removeRoad(map, name1, name2);
+      }
+      cityName(name1, random32(&seed) % cities);
+      cityName(name2, random32(&seed) % cities);
+      overlayRouteDistance(map, name1, name2, &actual);
+      update += now() - time;
+    }
+    cityName(name1, random32(&seed) % cities);
+    cityName(name2, random32(&seed) % cities);
+    double time = now();
+    routeDistances(map, source, 1, target, 1, &expected);
+    full += now() - time;
+    time = now();
+    if (!overlayRouteDistance(map, name1, name2, &actual)) {
+      errors++;
+    }
+    overlay += now() - time;
+    errors += (!expected.city != !actual.city ||
+               (expected.city && (expected.distance != actual.distance ||
+                                  expected.oldestRoad != actual.oldestRoad)));
+  }
+  OverlayStatistics statistics = partitionStatistics(map);
+  printf("cities: %u, levels: %u, cells: %u\n", cities, statistics.levels,
+         statistics.cells);
+  printf("overlay build:           %10.3f ms\n", build);
+  printf("full search:             %10.3f ms/query\n",
+         full / (queries + updates));
+  printf("overlay search:          %10.3f ms/query\n",
+         overlay / (queries + updates));
+  printf("update and query:        %10.3f ms/update (%llu cells customized)\n",
+         updates ? update / updates : 0.0, statistics.customized);
+  printf("mismatches: %u\n", errors);
+  deleteMap(map);
+  return errors > 0;
+}
+
+///Liczba rodzajów linii w pomiarze wczytywania poleceń.
+#define LINE_KINDS 9
+///Długość bufora na linię bez miast drogi krajowej.
+#define LINE_LENGTH 256
+///Długość bufora na jedno miasto drogi krajowej razem z odcinkiem drogi.
+#define ROUTE_CITY_LENGTH 40
+
+/**
+ * Opis linii wygenerowanej w pomiarze wczytywania poleceń.
+ */
+typedef struct GeneratedLine {
+  size_t start; ///< Początek linii w buforze.
+  size_t size; ///< Długość linii bez znaku '\n'.
+  int type; ///< Oczekiwany rodzaj polecenia.
+  unsigned city; ///< Numer pierwszego miasta polecenia.
+  long long sum; ///< Oczekiwana suma liczb polecenia.
+} GeneratedLine;
+
+/**
+ * Zapisuje losową linię wejścia i oczekiwany wynik jej rozpoznania.
+ * @param text - bufor na linię;
+ * @param line - wskaźnik na opis linii;
+ * @param routeCities - liczba miast w opisach dróg krajowych, co najmniej 2;
+ * @param seed - wskaźnik na stan generatora liczb losowych.
+ * @return Zwraca długość linii.
+ */
+static int generateLine(char *text, GeneratedLine *line, unsigned routeCities,
+                        unsigned long long *seed) {
+  unsigned kind = random32(seed) % LINE_KINDS;
+  unsigned city1 = random32(seed) % 100000, city2 = random32(seed) % 100000;
+  unsigned id = random32(seed) % 999 + 1;
+  unsigned length = random32(seed) % 1000 + 1;
+  int year = (int) (random32(seed) % 4000) - 1999;
+  year = year ? year : 1;
+  line->city = city1;
+  line->sum = 0;
+  switch (kind) {
+    case 0:
+      line->type = ADD_ROAD;
+      line->sum = (long long) length + year;
+      return sprintf(text, "addRoad;m%u;m%u;%u;%d", city1, city2, length,
+                     year);
+    case 1:
+      line->type = REPAIR_ROAD;
+      line->sum = year;
+      return sprintf(text, "repairRoad;m%u;m%u;%d", city1, city2, year);
+    case 2:
+      line->type = GET_ROUTE_DESCR;
+      line->sum = id;
+      return sprintf(text, "getRouteDescription;%u", id);
+    case 3:
+      line->type = NEW_ROUTE;
+      line->sum = id;
+      return sprintf(text, "newRoute;%u;m%u;m%u", id, city1, city2);
+    case 4:
+      line->type = EXTEND_ROUTE;
+      line->sum = id;
+      return sprintf(text, "extendRoute;%u;m%u", id, city1);
+    case 5:
+      line->type = REMOVE_ROAD;
+      return sprintf(text, "removeRoad;m%u;m%u", city1, city2);
+    case 6:
+      line->type = REMOVE_ROUTE;
+      line->sum = id;
+      return sprintf(text, "removeRoute;%u", id);
+    case 7: {
+      line->type = GET_ROUTE;
+      line->sum = id + (routeCities - 1) * ((long long) length + year);
+      int size = sprintf(text, "%u;m%u", id, city1);
+      for (unsigned i = 1; i < routeCities; i++) {
+        size += sprintf(text + size, ";%u;%d;m%u", length, year, city2 + i);
+      }
+      return size;
+    }
+    default:
+      line->type = IGNORE;
+      return sprintf(text, "# komentarz m%u", city1);
+  }
+}
+
+/**
+ * Sprawdza, czy rozpoznane polecenie jest zgodne z opisem linii.
+ * @param command - wskaźnik na rozpoznane polecenie;
+ * @param line - wskaźnik na opis linii.
+ * @return Zwraca @p true, jeśli polecenie jest zgodne z opisem.
+ */
+static bool sameCommand(Command *command, GeneratedLine *line) {
+  if (command->commandType != line->type || !validCommand(*command)) {
+    return false;
+  }
+  long long sum = 0;
+  const char *city = NULL;
+  switch (command->commandType) {
+    case ADD_ROAD:
+      sum = command->length + (long long) command->lastRepair;
+      city = command->city1.name;
+      break;
+    case REPAIR_ROAD:
+      sum = command->lastRepair;
+      city = command->city1.name;
+      break;
+    case REMOVE_ROAD:
+      city = command->city1.name;
+      break;
+    case NEW_ROUTE:
+    case EXTEND_ROUTE:
+      sum = command->routeID;
+      city = command->city1.name;
+      break;
+    case GET_ROUTE_DESCR:
+    case REMOVE_ROUTE:
+      sum = command->routeID;
+      break;
+    case GET_ROUTE: {
+      sum = command->routeID;
+      SegmentCursor cursor = routeSegments(command);
+      RouteSegment segment;
+      while (nextSegment(&cursor, &segment)) {
+        sum += segment.length + (long long) segment.lastRepair;
+        if (!city) {
+          city = segment.city1.name;
+        }
+      }
+      break;
+    }
+  }
+  char name[NAME_LENGTH];
+  cityName(name, line->city);
+  return sum == line->sum && (!city || strcmp(city, name) == 0);
+}
+
+/**
+ * Pomiar przepustowości rozpoznawania poleceń bez czytania wejścia: linie
+ * są generowane w pamięci, a mierzone jest tylko ich rozpoznanie i sprawdzenie
+ * poprawności, z wektorowym przeglądaniem linii i bez niego. Parametry:
+ * liczba linii, liczba powtórzeń, liczba miast w opisach dróg krajowych.
+ * @param argc - liczba parametrów;
+ * @param argv - tablica parametrów.
+ * @return Zwraca 0, jeśli wyniki są zgodne, a 1 w przeciwnym razie.
+ */
+static int benchmarkParser(int argc, char **argv) {
+  unsigned number = argument(argc, argv, 2, 1000000);
+  unsigned repeats = argument(argc, argv, 3, 5);
+  unsigned routeCities = argument(argc, argv, 4, 3);
+  size_t lineLength = LINE_LENGTH + (size_t) routeCities * ROUTE_CITY_LENGTH;
+  GeneratedLine *lines = malloc(number * sizeof(GeneratedLine));
+  char *line = malloc(lineLength);
+  size_t capacity = lineLength;
+  char *text = malloc(capacity);
+  if (!lines || !line || !text || routeCities < 2) {
+    fprintf(stderr, "memory error\n");
+    return 1;
+  }
+  unsigned long long seed = 2019;
+  size_t size = 0;
+  for (unsigned i = 0; i < number; i++) {
+    lines[i].start = size;
+    lines[i].size = (size_t) generateLine(line, &lines[i], routeCities,
+                                          &seed);
+    while (size + lines[i].size + 1 > capacity) {
+      capacity *= 2;
+      if (!(text = realloc(text, capacity))) {
+        fprintf(stderr, "memory error\n");
+        return 1;
+      }
+    }
+    memcpy(text + size, line, lines[i].size + 1);
+    size += lines[i].size + 1;
+  }
+  char *work = malloc(size);
+  if (!work) {
+    fprintf(stderr, "memory error\n");
+    return 1;
+  }
+  printf("lines: %u, bytes: %zu, cities per route: %u\n", number, size,
+         routeCities);
+  unsigned errors = 0;
+  Command command;
+  initCommand(&command);
+  for (int vector = 0; vector < 2; vector++) {
+    bool available = setVectorScanning(vector);
+    double total = 0;
+    for (unsigned r = 0; r < repeats; r++) {
+      memcpy(work, text, size);
+      double time = now();
+      for (unsigned i = 0; i < number; i++) {
+        parseCommand(&command, work + lines[i].start, lines[i].size);
+        errors += (r == 0 && !sameCommand(&command, &lines[i]));
+      }
+      total += now() - time;
+    }
+    printf("parse and validate (%s): %10.3f ms/pass, %8.1f MB/s\n",
+           available ? "vector" : "scalar", repeats ? total / repeats : 0.0,
+           total > 0 ? size * (double) repeats / (total * 1000.0) : 0.0);
+  }
+  printf("mismatches: %u\n", errors);
+  deleteCommand(&command);
+  finishBlockInput();
+  free(lines);
+  free(line);
+  free(text);
+  free(work);
+  return errors > 0;
+}
+
+///Długości linii sprawdzane w pomiarze przeglądania linii.
+static const unsigned scanLengths[] = {8, 16, 24, 32, 48, 64, 96, 128, 256};
+
+/**
+ * Przegląda linie tak jak podział linii na pola: po SCAN_BLOCK znaków naraz.
+ * @param scan - funkcja wyznaczająca maski;
+ * @param text - wskaźnik na linie zapisane jedna po drugiej;
+ * @param number - liczba linii;
+ * @param length - długość każdej linii.
+ * @return Zwraca łączną liczbę znalezionych średników i znaków sterujących.
+ */
+static unsigned long long scanLines(ScanKernel scan, const char *text,
+                                    unsigned number, unsigned length) {
+  unsigned long long found = 0;
+  for (unsigned i = 0; i < number; i++) {
+    const char *line = text + (size_t) i * length;
+    for (unsigned j = 0; j < length; j += SCAN_BLOCK) {
+      unsigned block = length - j < SCAN_BLOCK ? length - j : SCAN_BLOCK;
+      uint64_t semicolons, controls;
+      scan(line + j, block, &semicolons, &controls);
+      found += (unsigned) __builtin_popcountll(semicolons) +
+               (unsigned) __builtin_popcountll(controls);
+    }
+  }
+  return found;
+}
+
+/**
+ * Pomiar przeglądania linii o stałej długości zwykłą pętlą i wersją wektorową
+ * dla kolejnych długości, bez rozpoznawania poleceń. Służy do wyznaczenia
+ * stałej VECTOR_SCAN_MIN. Podaje najkrótszy czas z kolejnych powtórzeń.
+ * Parametry: liczba linii każdej długości, liczba powtórzeń.
+ * @param argc - liczba parametrów;
+ * @param argv - tablica parametrów.
+ * @return Zwraca 0, jeśli wyniki są zgodne, a 1 w przeciwnym razie.
+ */
+static int benchmarkScan(int argc, char **argv) {
+  unsigned number = argument(argc, argv, 2, 1000000);
+  unsigned repeats = argument(argc, argv, 3, 9);
+  unsigned lengths = sizeof(scanLengths) / sizeof(unsigned);
+  unsigned maxLength = scanLengths[lengths - 1];
+  char *text = malloc((size_t) number * maxLength);
+  if (!text) {
+    fprintf(stderr, "memory error\n");
+    return 1;
+  }
+  unsigned long long seed = 2019;
+  for (size_t i = 0; i < (size_t) number * maxLength; i++) {
+    unsigned value = random32(&seed) % 16;
+    text[i] = value == 0 ? ';' : (char) ('a' + value);
+  }
+  if (!setVectorScanning(true)) {
+    printf("vector scanning is not available\n");
+  }
+  ScanKernel kernels[2] = {NULL, chooseScanKernel(SIZE_MAX)};
+  setVectorScanning(false);
+  kernels[0] = chooseScanKernel(SIZE_MAX);
+  setVectorScanning(true);
+  printf("lines: %u, best of %u passes\n", number, repeats);
+  unsigned errors = 0;
+  for (unsigned l = 0; l < lengths; l++) {
+    unsigned length = scanLengths[l];
+    double best[2] = {0, 0};
+    unsigned long long found[2] = {0, 0};
+    for (unsigned r = 0; r < repeats; r++) {
+      for (int vector = 0; vector < 2; vector++) {
+        double time = now();
+        found[vector] = scanLines(kernels[vector], text, number, length);
+        time = now() - time;
+        if (r == 0 || time < best[vector]) {
+          best[vector] = time;
+        }
+      }
+    }
+    errors += found[0] != found[1];
+    printf("length %3u: scalar %8.3f ms, vector %8.3f ms, speedup %5.2fx\n",
+           length, best[0], best[1], best[1] > 0 ? best[0] / best[1] : 0.0);
+  }
+  printf("mismatches: %u\n", errors);
+  free(text);
+  return errors > 0;
+}
+
+/**
+ * Pomiar przepustowości rozpoznawania poleceń w formacie binarnym w porównaniu
+ * z tekstowym: te same polecenia są zapisywane w obu formatach w pamięci,
+ * a mierzone jest tylko ich rozpoznanie i sprawdzenie poprawności. Parametry:
+ * liczba linii, liczba powtórzeń, liczba miast w opisach dróg krajowych.
+ * @param argc - liczba parametrów;
+ * @param argv - tablica parametrów.
+ * @return Zwraca 0, jeśli wyniki są zgodne, a 1 w przeciwnym razie.
+ */
+static int benchmarkBinary(int argc, char **argv) {
+  unsigned number = argument(argc, argv, 2, 1000000);
+  unsigned repeats = argument(argc, argv, 3, 5);
+  unsigned routeCities = argument(argc, argv, 4, 3);
+  size_t lineLength = LINE_LENGTH + (size_t) routeCities * ROUTE_CITY_LENGTH;
+  GeneratedLine *lines = malloc(number * sizeof(GeneratedLine));
+  char *line = malloc(lineLength);
+  char *text = NULL, *binary = NULL;
+  size_t size = 0, binarySize = 0;
+  FILE *textFile = open_memstream(&text, &size);
+  FILE *binaryFile = open_memstream(&binary, &binarySize);
+  BinaryWriter *writer = binaryFile ?
+                         newBinaryWriter(binaryFile, COMMAND_MAGIC) : NULL;
+  if (!lines || !line || !textFile || !writer || routeCities < 2) {
+    fprintf(stderr, "memory error\n");
+    return 1;
+  }
+  unsigned long long seed = 2019;
+  Command command;
+  initCommand(&command);
+  for (unsigned i = 0; i < number; i++) {
+    lines[i].start = (size_t) ftell(textFile);
+    lines[i].size = (size_t) generateLine(line, &lines[i], routeCities,
+                                          &seed);
+    fwrite(line, 1, lines[i].size + 1, textFile);
+    parseCommand(&command, line, lines[i].size);
+    if (!writeCommand(writer, &command)) {
+      fprintf(stderr, "memory error\n");
+      return 1;
+    }
+  }
+  fclose(textFile);
+  deleteBinaryWriter(writer);
+  fclose(binaryFile);
+  char *work = malloc(size);
+  if (!work) {
+    fprintf(stderr, "memory error\n");
+    return 1;
+  }
+  printf("lines: %u, text bytes: %zu, binary bytes: %zu\n", number, size,
+         binarySize);
+  unsigned errors = 0;
+  double textTotal = 0, binaryTotal = 0;
+  for (unsigned r = 0; r < repeats; r++) {
+    memcpy(work, text, size);
+    double time = now();
+    for (unsigned i = 0; i < number; i++) {
+      parseCommand(&command, work + lines[i].start, lines[i].size);
+      errors += (r == 0 && !sameCommand(&command, &lines[i]));
+    }
+    textTotal += now() - time;
+    freeBinaryCities();
+    time = now();
+    size_t position = MAGIC_LENGTH;
+    for (unsigned i = 0; i < number; i++) {
+      size_t record;
+      do {
+        record = recordSize(binary + position, binarySize - position);
+        position += record;
+      } while (!parseRecord(&command, binary + position - record, record));
+      errors += (r == 0 && !sameCommand(&command, &lines[i]));
+    }
+    binaryTotal += now() - time;
+  }
+  printf("text:   %10.3f ms/pass, %8.1f Mlines/s\n",
+         repeats ? textTotal / repeats : 0.0,
+         textTotal > 0 ?
+         number * (double) repeats / (textTotal * 1000.0) : 0.0);
+  printf("binary: %10.3f ms/pass, %8.1f Mlines/s\n",
+         repeats ? binaryTotal / repeats : 0.0,
+         binaryTotal > 0 ?
+         number * (double) repeats / (binaryTotal * 1000.0) : 0.0);
+  printf("mismatches: %u\n", errors);
+  deleteCommand(&command);
+  finishBlockInput();
+  free(lines);
+  free(line);
+  free(text);
+  free(binary);
+  free(work);
+  return errors > 0;
+}
+
+/**
+ * Wypełnia tablicę odcinków drogi krajowej przechodzącej przez kolejne miasta
+ * pierścienia. Odcinek między miastami @p k i @p k + 1 ma zawsze tę samą
+ * długość, a jego data remontu zależy od numeru drogi krajowej.
+ * @param segments - tablica odcinków;
+ * @param keys - tablica sprawdzonych nazw miast pierścienia;
+ * @param cities - liczba miast pierścienia;
+ * @param start - numer pierwszego miasta drogi krajowej;
+ * @param length - liczba odcinków drogi krajowej;
+ * @param route - numer drogi krajowej w kolejności tworzenia, od 0.
+ */
+static void ringSegments(RouteSegment *segments, const CityKey *keys,
+                         unsigned cities, unsigned start, unsigned length,
+                         unsigned route) {
+  for (unsigned i = 0; i < length; i++) {
+    unsigned city = (start + i) % cities;
+    segments[i].city1 = keys[city];
+    segments[i].city2 = keys[(city + 1) % cities];
+    segments[i].length = 1 + city % 97;
+    segments[i].lastRepair = 1900 + (int) route;
+  }
+}
+
+/**
+ * Sprawdza opis drogi krajowej utworzonej przez pomiar importu.
+ * @param map - wskaźnik na mapę;
+ * @param routeId - numer drogi krajowej;
+ * @param names - tablica nazw miast pierścienia;
+ * @param cities - liczba miast pierścienia;
+ * @param start - numer pierwszego miasta drogi krajowej;
+ * @param length - liczba odcinków drogi krajowej;
+ * @param lastRoute - tablica numerów ostatnich dróg krajowych przechodzących
+ * przez kolejne odcinki pierścienia.
+ * @return Zwraca @p true, jeśli opis jest zgodny z oczekiwanym.
+ */
+static bool checkRingRoute(Map *map, unsigned routeId,
+                           char (*names)[NAME_LENGTH], unsigned cities,
+                           unsigned start, unsigned length,
+                           const unsigned *lastRoute) {
+  const char *description = getRouteDescription(map, routeId);
+  if (!description) {
+    return false;
+  }
+  char field[3 * NAME_LENGTH];
+  const char *position = description;
+  bool same = true;
+  snprintf(field, sizeof(field), "%u", routeId);
+  for (unsigned i = 0; same && i <= length; i++) {
+    unsigned city = (start + i) % cities;
+    size_t size = strlen(field);
+    same = strncmp(position, field, size) == 0 && position[size] == ';';
+    position += size + 1;
+    if (i < length) {
+      snprintf(field, sizeof(field), "%s;%u;%d", names[city], 1 + city % 97,
+               1900 + (int) lastRoute[city]);
+    }
+    else {
+      snprintf(field, sizeof(field), "%s", names[city]);
+    }
+  }
+  same = same && strcmp(position, field) == 0;
+  free((void *) description);
+  return same;
+}
+
+/**
+ * Pomiar tworzenia dróg krajowych z opisu odcinków. Drogi krajowe przechodzą
+ * przez kolejne miasta pierścienia, więc część ich odcinków jest nowa,
+ * a część już istnieje, z wcześniejszą lub tą samą datą remontu. Porównuje
+ * dodawanie kolejnych odcinków funkcjami addRoad i repairRoad, ich
+ * odpowiednikami przyjmującymi sprawdzone nazwy miast i funkcję
+ * importRouteSegments, podając czas i liczbę wyszukań po nazwie na odcinek,
+ * i sprawdza opisy utworzonych dróg krajowych. Parametry: liczba miast, liczba
+ * dróg krajowych, liczba odcinków drogi krajowej.
+ * @param argc - liczba parametrów;
+ * @param argv - tablica parametrów.
+ * @return Zwraca 0, jeśli wyniki są zgodne, a 1 w przeciwnym razie.
+ */
+static int benchmarkImport(int argc, char **argv) {
+  unsigned cities = argument(argc, argv, 2, 1000);
+  unsigned routes = argument(argc, argv, 3, 500);
+  unsigned length = argument(argc, argv, 4, 100);
+  if (length == 0 || length >= cities || routes == 0 || routes > 999) {
+    fprintf(stderr, "invalid parameters\n");
+    return 1;
+  }
+  char (*names)[NAME_LENGTH] = malloc(cities * sizeof(*names));
+  CityKey *keys = malloc(cities * sizeof(CityKey));
+  unsigned *starts = malloc(routes * sizeof(unsigned));
+  unsigned *lastRoute = calloc(cities, sizeof(unsigned));
+  RouteSegment *segments = malloc(length * sizeof(RouteSegment));
+  Map *maps[3] = {newMap(), newMap(), newMap()};
+  if (!names || !keys || !starts || !lastRoute || !segments || !maps[0] ||
+      !maps[1] || !maps[2]) {
+    fprintf(stderr, "memory error\n");
+    return 1;
+  }
+  for (unsigned i = 0; i < cities; i++) {
+    cityName(names[i], i);
+    makeCityKey(names[i], &(keys[i]));
+  }
+  unsigned long long seed = 2019;
+  for (unsigned r = 0; r < routes; r++) {
+    starts[r] = random32(&seed) % cities;
+    for (unsigned i = 0; i < length; i++) {
+      lastRoute[(starts[r] + i) % cities] = r;
+    }
+  }
+  printf("cities: %u, routes: %u, segments per route: %u\n", cities, routes,
+         length);
+  unsigned errors = 0;
+  const char *methods[3] = {"addRoad/repairRoad", "addRoadByKeys",
+                            "importRouteSegments"};
+  for (int method = 0; method < 3; method++) {
+    Map *map = maps[method];
+    double time = now();
+    for (unsigned r = 0; r < routes; r++) {
+      ringSegments(segments, keys, cities, starts[r], length, r);
+      if (method == 2) {
+        errors += !importRouteSegments(map, r + 1, segments, length);
+        continue;
+      }
+      for (unsigned i = 0; i < length; i++) {
+        const CityKey *city1 = &(segments[i].city1);
+        const CityKey *city2 = &(segments[i].city2);
+        if (method == 0) {
+          errors += !addRoad(map, city1->name, city2->name, segments[i].length,
+                             segments[i].lastRepair) &&
+                    !repairRoad(map, city1->name, city2->name,
+                                segments[i].lastRepair);
+        }
+        else {
+          errors += !addRoadByKeys(map, city1, city2, segments[i].length,
+                                   segments[i].lastRepair) &&
+                    !repairRoadByKeys(map, city1, city2,
+                                      segments[i].lastRepair);
+        }
+      }
+    }
+    time = now() - time;
+    double total = (double) routes * length;
+    LookupStatistics lookups = lookupStatistics(map);
+    printf("%-20s %8.3f us/segment, %5.2f city and %5.2f road lookups/segment\n",
+           methods[method], time * 1000.0 / total, lookups.cities / total,
+           lookups.roads / total);
+  }
+  for (unsigned r = 0; r < routes; r++) {
+    errors += !checkRingRoute(maps[2], r + 1, names, cities, starts[r], length,
+                              lastRoute);
+  }
+  printf("mismatches: %u\n", errors);
+  deleteMap(maps[0]);
+  deleteMap(maps[1]);
+  deleteMap(maps[2]);
+  free(names);
+  free(keys);
+  free(starts);
+  free(lastRoute);
+  free(segments);
+  return errors > 0;
+}
+
+/**
+ * Opis dostępnego pomiaru.
+ */
+typedef struct Benchmark {
+  const char *name; ///< Nazwa pomiaru podawana w parametrach.
+  int (*run)(int argc, char **argv); ///< Funkcja wykonująca pomiar.
+} Benchmark;
+
+///Dostępne pomiary.
+static const Benchmark benchmarks[] = {
+  {"search", benchmarkSearch},
+  {"overlay", benchmarkOverlay},
+  {"parser", benchmarkParser},
+  {"scan", benchmarkScan},
+  {"import", benchmarkImport},
+  {"binary", benchmarkBinary},
+};
+
+int main(int argc, char **argv) {
+  unsigned number = sizeof(benchmarks) / sizeof(Benchmark);
+  for (unsigned i = 0; i < number && argc > 1; i++) {
+    if (strcmp(argv[1], benchmarks[i].name) == 0) {
+      return benchmarks[i].run(argc, argv);
+    }
+  }
+  fprintf(stderr, "usage: %s NAME [PARAMETERS...]\navailable:", argv[0]);
+  for (unsigned i = 0; i < number; i++) {
+    fprintf(stderr, " %s", benchmarks[i].name);
+  }
+  fprintf(stderr, "\n");
+  return 2;
+}
@@ -0,0 +1,775 @@
+/** @file
+ * Implementacja binary.h
+ *
+ * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
+ * @date 01.09.2019
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "binary.h"
+#include "city_hashmap.h"
+#include "scan.h"
+
+#define MORE_BYTES 0x80 ///< Bit oznaczający, że liczba ma kolejne bajty.
+#define NUMBER_BITS 0x7F ///< Bity liczby zapisane w jednym bajcie.
+#define INITIAL_CITIES 64 ///< Początkowy rozmiar tablicy nazw miast.
+#define INITIAL_RECORD 256 ///< Początkowy rozmiar bufora treści rekordu.
+
+/**
+ * Struktura przechowująca nazwy miast, którym nadano numery.
+ */
+typedef struct CityTable {
+  CityKey *keys; ///< Nazwy miast w kolejności nadania numerów.
+  unsigned number; ///< Liczba nazw.
+  unsigned capacity; ///< Rozmiar tablicy nazw.
+} CityTable;
+
+///Nazwy miast strumienia poleceń.
+static CityTable binaryCities = {NULL, 0, 0};
+
+/**
+ * Struktura przechowująca stan zapisywania strumienia binarnego.
+ */
+struct BinaryWriter {
+  FILE *file; ///< Plik, do którego zapisywane są rekordy.
+  unsigned char *record; ///< Treść zapisywanego rekordu.
+  size_t size; ///< Długość treści zapisywanego rekordu.
+  size_t capacity; ///< Rozmiar bufora treści rekordu.
+  char **names; ///< Tablica z adresowaniem otwartym zapisanych nazw miast.
+  unsigned *numbers; ///< Numery nazw miast z tablicy @p names.
+  size_t slots; ///< Rozmiar tablicy nazw, będący potęgą dwójki.
+  unsigned cities; ///< Liczba zapisanych nazw miast.
+};
+
+/**@brief Odczytuje liczbę o zmiennej długości.
+ * @param position - wskaźnik na początek zapisu liczby, przesuwany za zapis;
+ * @param end - wskaźnik na koniec dostępnych danych;
+ * @param value - wskaźnik, pod który zostanie zapisana liczba.
+ * @return Zwraca @p false, jeśli zapis liczby nie kończy się przed @p end,
+ * jest dłuższy niż MAX_NUMBER_LENGTH lub liczba nie mieści się w 64 bitach.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool readNumber(const char **position, const char *end,
+                       uint64_t *value) {
+  uint64_t result = 0;
+  for (unsigned i = 0; i < MAX_NUMBER_LENGTH && *position < end; i++) {
+    unsigned char byte = (unsigned char) *((*position)++);
+    if (i == MAX_NUMBER_LENGTH - 1 && byte > 1) {
+      return false;
+    }
+    result |= (uint64_t) (byte & NUMBER_BITS) << (7 * i);
+    if (!(byte & MORE_BYTES)) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**@brief Odczytuje liczbę o zmiennej długości ze sprawdzonego rekordu.
+ * @param position - wskaźnik na początek zapisu liczby, przesuwany za zapis.
+ * @return Zwraca odczytaną liczbę.
+ */
+static uint64_t nextNumber(const char **position) {
+  uint64_t result = 0;
+  unsigned shift = 0;
+  unsigned char byte;
+  do {
+    byte = (unsigned char) *((*position)++);
+    result |= (uint64_t) (byte & NUMBER_BITS) << shift;
+    shift += 7;
+  } while (byte & MORE_BYTES);
+  return result;
+}
+
+/**
+ * Zamienia zapisaną datę remontu na liczbę całkowitą.
+ * @param value - zapisana data remontu, nie większa niż UINT32_MAX.
+ * @return Zwraca datę remontu.
+ */
+static int yearValue(uint64_t value) {
+  uint32_t bits = (uint32_t) value;
+  return (int) (int32_t) ((bits >> 1) ^ (~(bits & 1) + 1));
+}
+
+/**
+ * Odczytuje liczbę nieujemną mieszczącą się w typie unsigned.
+ * @param position - wskaźnik na początek zapisu liczby, przesuwany za zapis;
+ * @param end - wskaźnik na koniec treści rekordu;
+ * @param value - wskaźnik, pod który zostanie zapisana liczba.
+ * @return Zwraca @p true, jeśli liczba jest poprawna.
+ */
+static bool readUnsignedNumber(const char **position, const char *end,
+                               unsigned *value) {
+  uint64_t number;
+  if (!readNumber(position, end, &number) || number > UINT_MAX) {
+    return false;
+  }
+  *value = (unsigned) number;
+  return true;
+}
+
+/**
+ * Odczytuje datę remontu.
+ * @param position - wskaźnik na początek zapisu daty, przesuwany za zapis;
+ * @param end - wskaźnik na koniec treści rekordu;
+ * @param year - wskaźnik, pod który zostanie zapisana data.
+ * @return Zwraca @p true, jeśli data jest poprawna.
+ */
+static bool readYear(const char **position, const char *end, int *year) {
+  uint64_t number;
+  if (!readNumber(position, end, &number) || number > UINT32_MAX) {
+    return false;
+  }
+  *year = yearValue(number);
+  return true;
+}
+
+/**
+ * Odczytuje numer nazwy miasta.
+ * @param position - wskaźnik na początek zapisu numeru, przesuwany za zapis;
+ * @param end - wskaźnik na koniec treści rekordu;
+ * @param city - wskaźnik, pod który zostanie zapisana nazwa miasta.
+ * @return Zwraca @p true, jeśli nazwie o odczytanym numerze nadano już numer.
+ */
+static bool readCity(const char **position, const char *end, CityKey *city) {
+  uint64_t number;
+  if (!readNumber(position, end, &number) || number >= binaryCities.number) {
+    return false;
+  }
+  *city = binaryCities.keys[number];
+  return true;
+}
+
+/**@brief Nadaje numer nazwie miasta.
+ * Kopiuje nazwę i wyznacza jej indeks. Nazwa, która nie mogłaby pojawić się
+ * w poleceniu tekstowym, dostaje numer, ale ma długość 0.
+ * @param name - wskaźnik na nazwę miasta;
+ * @param length - długość nazwy.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool addBinaryCity(const char *name, size_t length) {
+  if (binaryCities.number == binaryCities.capacity) {
+    unsigned capacity = binaryCities.capacity ? 2 * binaryCities.capacity :
+                        INITIAL_CITIES;
+    CityKey *keys = realloc(binaryCities.keys, capacity * sizeof(CityKey));
+    if (!keys) {
+      return false;
+    }
+    binaryCities.keys = keys;
+    binaryCities.capacity = capacity;
+  }
+  char *copy = malloc(length + 1);
+  if (!copy) {
+    return false;
+  }
+  memcpy(copy, name, length);
+  copy[length] = '\0';
+  CityKey key = {copy, 0, 0};
+  if (length > 0 && length <= UINT_MAX && plainText(copy, length) &&
+      !memchr(copy, '\n', length)) {
+    key.length = (unsigned) length;
+    key.index = cityIndex(copy, length);
+  }
+  binaryCities.keys[(binaryCities.number)++] = key;
+  return true;
+}
+
+size_t recordSize(const char *data, size_t size) {
+  const char *position = data;
+  uint64_t length;
+  if (!readNumber(&position, data + size, &length)) {
+    return position - data < MAX_NUMBER_LENGTH ? 0 : MAX_NUMBER_LENGTH;
+  }
+  size_t header = (size_t) (position - data);
+  return length > SIZE_MAX - header ? SIZE_MAX : header + (size_t) length;
+}
+
+bool commandComplete(const char *data, size_t size) {
+  const char *position = data;
+  const char *end = data + size;
+  while (true) {
+    const char *start = position;
+    uint64_t length;
+    if (!readNumber(&position, end, &length)) {
+      return position - start == MAX_NUMBER_LENGTH;
+    }
+    if (length > (uint64_t) (end - position)) {
+      return false;
+    }
+    if (length == 0 || (unsigned char) *position != BINARY_CITY) {
+      return true;
+    }
+    position += length;
+  }
+}
+
+/**@brief Rozpoznaje treść rekordu polecenia GET_ROUTE.
+ * Sprawdza cały opis drogi krajowej. Niepoprawne nazwy miast oznaczają
+ * polecenie jako niepoprawne tak jak znaki o kodach od 1 do 31 w linii.
+ * @param command - wskaźnik na strukturę komendy;
+ * @param data - wskaźnik na treść rekordu za jego rodzajem;
+ * @param end - wskaźnik na koniec treści rekordu.
+ * @return Zwraca GET_ROUTE lub WRONG_COMMAND, jeśli opis ma niewłaściwy format.
+ */
+static int decodeRoute(Command *command, char *data, const char *end) {
+  const char *position = data;
+  unsigned cities;
+  if (!readUnsignedNumber(&position, end, &(command->routeID)) ||
+      command->routeID == 0 ||
+      !readUnsignedNumber(&position, end, &cities) || cities < 2 ||
+      cities > INT_MAX) {
+    return WRONG_COMMAND;
+  }
+  command->routeFields = data + (position - data);
+  for (unsigned i = 0; i < cities; i++) {
+    unsigned length;
+    int year;
+    CityKey city;
+    if (i > 0 && (!readUnsignedNumber(&position, end, &length) ||
+                  length == 0 || !readYear(&position, end, &year) ||
+                  year == 0)) {
+      return WRONG_COMMAND;
+    }
+    if (!readCity(&position, end, &city)) {
+      return WRONG_COMMAND;
+    }
+    if (city.length == 0) {
+      command->invalidBytes = true;
+    }
+  }
+  command->citiesNumber = (int) cities;
+  command->binary = true;
+  return position == end ? GET_ROUTE : WRONG_COMMAND;
+}
+
+int decodeRecord(Command *command, char *data, size_t size) {
+  const char *position = data;
+  const char *end = data + size;
+  uint64_t length;
+  if (!readNumber(&position, end, &length) ||
+      length != (uint64_t) (end - position) || position == end) {
+    return WRONG_COMMAND;
+  }
+  int type = (unsigned char) *(position++);
+  bool valid = true;
+  switch (type) {
+    case BINARY_CITY:
+      return addBinaryCity(position, (size_t) (end - position)) ?
+             BINARY_CITY : MEMORY_ERROR;
+    case BINARY_IGNORE:
+      return IGNORE;
+    case GET_ROUTE:
+      return decodeRoute(command, data + (position - data), end);
+    case ADD_ROAD:
+      valid = readCity(&position, end, &(command->city1)) &&
+              readCity(&position, end, &(command->city2)) &&
+              readUnsignedNumber(&position, end, &(command->length)) &&
+              readYear(&position, end, &(command->lastRepair));
+      break;
+    case REPAIR_ROAD:
+      valid = readCity(&position, end, &(command->city1)) &&
+              readCity(&position, end, &(command->city2)) &&
+              readYear(&position, end, &(command->lastRepair));
+      break;
+    case GET_ROUTE_DESCR:
+    case REMOVE_ROUTE:
+      valid = readUnsignedNumber(&position, end, &(command->routeID));
+      break;
+    case NEW_ROUTE:
+      valid = readUnsignedNumber(&position, end, &(command->routeID)) &&
+              readCity(&position, end, &(command->city1)) &&
+              readCity(&position, end, &(command->city2));
+      break;
+    case EXTEND_ROUTE:
+      valid = readUnsignedNumber(&position, end, &(command->routeID)) &&
+              readCity(&position, end, &(command->city1));
+      break;
+    case REMOVE_ROAD:
+      valid = readCity(&position, end, &(command->city1)) &&
+              readCity(&position, end, &(command->city2));
+      break;
+    default:
+      return WRONG_COMMAND;
+  }
+  return valid && position == end ? type : WRONG_COMMAND;
+}
+
+void startSegments(SegmentCursor *cursor, const char *fields) {
+  cursor->next = fields;
+  cursor->city = binaryCities.keys[nextNumber(&(cursor->next))];
+}
+
+void decodeSegment(SegmentCursor *cursor, RouteSegment *segment) {
+  segment->city1 = cursor->city;
+  segment->length = (unsigned) nextNumber(&(cursor->next));
+  segment->lastRepair = yearValue(nextNumber(&(cursor->next)));
+  segment->city2 = binaryCities.keys[nextNumber(&(cursor->next))];
+  cursor->city = segment->city2;
+}
+
+void freeBinaryCities(void) {
+  for (unsigned i = 0; i < binaryCities.number; i++) {
+    free((void *) binaryCities.keys[i].name);
+  }
+  free(binaryCities.keys);
+  binaryCities.keys = NULL;
+  binaryCities.number = 0;
+  binaryCities.capacity = 0;
+}
+
+BinaryWriter *newBinaryWriter(FILE *file, const char *magic) {
+  BinaryWriter *writer = malloc(sizeof(BinaryWriter));
+  if (!writer) {
+    return NULL;
+  }
+  writer->file = file;
+  writer->size = 0;
+  writer->capacity = INITIAL_RECORD;
+  writer->slots = INITIAL_CITIES;
+  writer->cities = 0;
+  writer->record = malloc(writer->capacity);
+  writer->names = calloc(writer->slots, sizeof(char *));
+  writer->numbers = malloc(writer->slots * sizeof(unsigned));
+  if (!writer->record || !writer->names || !writer->numbers ||
+      fwrite(magic, 1, MAGIC_LENGTH, file) != MAGIC_LENGTH) {
+    free(writer->record);
+    free(writer->names);
+    free(writer->numbers);
+    free(writer);
+    return NULL;
+  }
+  return writer;
+}
+
+bool deleteBinaryWriter(BinaryWriter *writer) {
+  if (!writer) {
+    return true;
+  }
+  bool written = fflush(writer->file) == 0 && !ferror(writer->file);
+  for (size_t i = 0; i < writer->slots; i++) {
+    free(writer->names[i]);
+  }
+  free(writer->names);
+  free(writer->numbers);
+  free(writer->record);
+  free(writer);
+  return written;
+}
+
+/**
+ * Dopisuje bajt do treści rekordu.
+ * @param writer - wskaźnik na strukturę zapisującą strumień;
+ * @param byte - dopisywany bajt.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ */
+static bool putByte(BinaryWriter *writer, unsigned char byte) {
+  if (writer->size == writer->capacity) {
+    unsigned char *record = realloc(writer->record, 2 * writer->capacity);
+    if (!record) {
+      return false;
+    }
+    writer->record = record;
+    writer->capacity *= 2;
+  }
+  writer->record[(writer->size)++] = byte;
+  return true;
+}
+
+/**
+ * Zapisuje liczbę o zmiennej długości.
+ * @param bytes - bufor na co najmniej MAX_NUMBER_LENGTH bajtów;
+ * @param value - liczba.
+ * @return Zwraca długość zapisu.
+ */
+static unsigned numberBytes(unsigned char *bytes, uint64_t value) {
+  unsigned length = 0;
+  while (value >= MORE_BYTES) {
+    bytes[length++] = (unsigned char) (value | MORE_BYTES);
+    value >>= 7;
+  }
+  bytes[length++] = (unsigned char) value;
+  return length;
+}
+
+/**
+ * Dopisuje liczbę o zmiennej długości do treści rekordu.
+ * @param writer - wskaźnik na strukturę zapisującą strumień;
+ * @param value - liczba.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ */
+static bool putNumber(BinaryWriter *writer, uint64_t value) {
+  unsigned char bytes[MAX_NUMBER_LENGTH];
+  unsigned length = numberBytes(bytes, value);
+  for (unsigned i = 0; i < length; i++) {
+    if (!putByte(writer, bytes[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Dopisuje datę remontu do treści rekordu.
+ * @param writer - wskaźnik na strukturę zapisującą strumień;
+ * @param year - data remontu.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ */
+static bool putYear(BinaryWriter *writer, int year) {
+  uint32_t bits = (uint32_t) year;
+  return putNumber(writer, (bits << 1) ^ (year < 0 ? UINT32_MAX : 0));
+}
+
+/**
+ * Zapisuje do pliku rekord o zgromadzonej treści i zaczyna nowy rekord.
+ * @param writer - wskaźnik na strukturę zapisującą strumień.
+ */
+static void flushRecord(BinaryWriter *writer) {
+  unsigned char bytes[MAX_NUMBER_LENGTH];
+  unsigned length = numberBytes(bytes, writer->size);
+  fwrite(bytes, 1, length, writer->file);
+  fwrite(writer->record, 1, writer->size, writer->file);
+  writer->size = 0;
+}
+
+/**
+ * Wyznacza skrót nazwy miasta.
+ * @param name - wskaźnik na nazwę miasta;
+ * @param length - długość nazwy.
+ * @return Zwraca skrót FNV-1a nazwy.
+ */
+static uint64_t nameHash(const char *name, size_t length) {
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  for (size_t i = 0; i < length; i++) {
+    hash = (hash ^ (unsigned char) name[i]) * 0x100000001B3ULL;
+  }
+  return hash;
+}
+
+/**
+ * Podaje miejsce nazwy miasta w tablicy zapisanych nazw.
+ * @param writer - wskaźnik na strukturę zapisującą strumień;
+ * @param name - wskaźnik na nazwę miasta;
+ * @param length - długość nazwy.
+ * @return Zwraca indeks nazwy w tablicy lub pustego miejsca, w którym należy ją
+ * wstawić.
+ */
+static size_t nameSlot(BinaryWriter *writer, const char *name, size_t length) {
+  size_t index = (size_t) nameHash(name, length) & (writer->slots - 1);
+  while (writer->names[index] &&
+         (strncmp(writer->names[index], name, length) != 0 ||
+          writer->names[index][length] != '\0')) {
+    index = (index + 1) & (writer->slots - 1);
+  }
+  return index;
+}
+
+/**
+ * Podwaja rozmiar tablicy zapisanych nazw miast.
+ * @param writer - wskaźnik na strukturę zapisującą strumień.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ */
+static bool growNames(BinaryWriter *writer) {
+  char **names = writer->names;
+  unsigned *numbers = writer->numbers;
+  size_t slots = writer->slots;
+  writer->slots *= 2;
+  writer->names = calloc(writer->slots, sizeof(char *));
+  writer->numbers = malloc(writer->slots * sizeof(unsigned));
+  if (!writer->names || !writer->numbers) {
+    free(writer->names);
+    free(writer->numbers);
+    writer->names = names;
+    writer->numbers = numbers;
+    writer->slots = slots;
+    return false;
+  }
+  for (size_t i = 0; i < slots; i++) {
+    if (names[i]) {
+      size_t index = nameSlot(writer, names[i], strlen(names[i]));
+      writer->names[index] = names[i];
+      writer->numbers[index] = numbers[i];
+    }
+  }
+  free(names);
+  free(numbers);
+  return true;
+}
+
+/**@brief Dopisuje numer nazwy miasta do treści rekordu.
+ * Jeśli nazwa nie ma jeszcze numeru, zapisuje do pliku rekord BINARY_CITY
+ * nadający jej kolejny numer. Treść bieżącego rekordu jest zapisywana do pliku
+ * dopiero w całości, więc rekord z nazwą poprzedza polecenie.
+ * @param writer - wskaźnik na strukturę zapisującą strumień;
+ * @param name - wskaźnik na nazwę miasta;
+ * @param length - długość nazwy.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ */
+static bool putCity(BinaryWriter *writer, const char *name, size_t length) {
+  size_t index = nameSlot(writer, name, length);
+  if (!writer->names[index]) {
+    if (2 * (writer->cities + 1) > writer->slots) {
+      if (!growNames(writer)) {
+        return false;
+      }
+      index = nameSlot(writer, name, length);
+    }
+    char *copy = malloc(length + 1);
+    if (!copy) {
+      return false;
+    }
+    memcpy(copy, name, length);
+    copy[length] = '\0';
+    writer->names[index] = copy;
+    writer->numbers[index] = (writer->cities)++;
+    unsigned char bytes[MAX_NUMBER_LENGTH];
+    unsigned header = numberBytes(bytes, length + 1);
+    fwrite(bytes, 1, header, writer->file);
+    fputc(BINARY_CITY, writer->file);
+    fwrite(name, 1, length, writer->file);
+  }
+  return putNumber(writer, writer->numbers[index]);
+}
+
+/**
+ * Dopisuje do treści rekordu opis drogi krajowej polecenia GET_ROUTE.
+ * @param writer - wskaźnik na strukturę zapisującą strumień;
+ * @param command - wskaźnik na poprawne polecenie GET_ROUTE.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ */
+static bool putRoute(BinaryWriter *writer, const Command *command) {
+  SegmentCursor cursor = routeSegments(command);
+  RouteSegment segment;
+  bool success = putNumber(writer, command->routeID) &&
+                 putNumber(writer, (unsigned) command->citiesNumber) &&
+                 putCity(writer, cursor.city.name, cursor.city.length);
+  while (success && nextSegment(&cursor, &segment)) {
+    success = putNumber(writer, segment.length) &&
+              putYear(writer, segment.lastRepair) &&
+              putCity(writer, segment.city2.name, segment.city2.length);
+  }
+  return success;
+}
+
+bool writeCommand(BinaryWriter *writer, const Command *command) {
+  int type = command->commandType;
+  if (type == IGNORE) {
+    type = BINARY_IGNORE;
+  }
+  else if (type < 0 || !validCommand(*command)) {
+    type = BINARY_WRONG;
+  }
+  const CityKey *city1 = &(command->city1);
+  const CityKey *city2 = &(command->city2);
+  bool success = putByte(writer, (unsigned char) type);
+  switch (type) {
+    case GET_ROUTE:
+      success = success && putRoute(writer, command);
+      break;
+    case ADD_ROAD:
+      success = success && putCity(writer, city1->name, city1->length) &&
+                putCity(writer, city2->name, city2->length) &&
+                putNumber(writer, command->length) &&
+                putYear(writer, command->lastRepair);
+      break;
+    case REPAIR_ROAD:
+      success = success && putCity(writer, city1->name, city1->length) &&
+                putCity(writer, city2->name, city2->length) &&
+                putYear(writer, command->lastRepair);
+      break;
+    case GET_ROUTE_DESCR:
+    case REMOVE_ROUTE:
+      success = success && putNumber(writer, command->routeID);
+      break;
+    case NEW_ROUTE:
+      success = success && putNumber(writer, command->routeID) &&
+                putCity(writer, city1->name, city1->length) &&
+                putCity(writer, city2->name, city2->length);
+      break;
+    case EXTEND_ROUTE:
+      success = success && putNumber(writer, command->routeID) &&
+                putCity(writer, city1->name, city1->length);
+      break;
+    case REMOVE_ROAD:
+      success = success && putCity(writer, city1->name, city1->length) &&
+                putCity(writer, city2->name, city2->length);
+      break;
+  }
+  if (!success) {
+    writer->size = 0;
+    return false;
+  }
+  flushRecord(writer);
+  return true;
+}
+
+/**
+ * Podaje długość pola opisu drogi krajowej.
+ * @param field - wskaźnik na początek pola.
+ * @return Zwraca liczbę znaków do najbliższego średnika lub końca napisu.
+ */
+static size_t descriptionField(const char *field) {
+  return strcspn(field, ";");
+}
+
+bool writeDescription(BinaryWriter *writer, const char *description) {
+  unsigned fields = description[0] != '\0';
+  for (const char *c = description; *c != '\0'; c++) {
+    fields += (*c == ';');
+  }
+  bool success = putByte(writer, GET_ROUTE_DESCR) &&
+                 putNumber(writer, fields > 0 ? (fields - 2) / 3 + 1 : 0);
+  const char *field = description;
+  for (unsigned i = 0; success && i < fields; i++) {
+    size_t length = descriptionField(field);
+    if (i % 3 == 1) {
+      success = putCity(writer, field, length);
+    }
+    else if (i % 3 == 0 && i > 0) {
+      success = putYear(writer, (int) strtol(field, NULL, 10));
+    }
+    else {
+      success = putNumber(writer, strtoul(field, NULL, 10));
+    }
+    field += length + 1;
+  }
+  if (!success) {
+    writer->size = 0;
+    return false;
+  }
+  flushRecord(writer);
+  return true;
+}
+
+bool writeError(BinaryWriter *writer, int line) {
+  if (!putByte(writer, BINARY_WRONG) ||
+      !putNumber(writer, (unsigned) line)) {
+    writer->size = 0;
+    return false;
+  }
+  flushRecord(writer);
+  return true;
+}
+
+/**
+ * Struktura opisująca nazwę miasta w strumieniu odpowiedzi.
+ */
+typedef struct ResponseName {
+  const char *name; ///< Początek nazwy w strumieniu.
+  size_t length; ///< Długość nazwy.
+} ResponseName;
+
+/**
+ * Wypisuje nazwę miasta o numerze odczytanym ze strumienia odpowiedzi.
+ * @param position - wskaźnik na zapis numeru, przesuwany za zapis;
+ * @param end - wskaźnik na koniec treści rekordu;
+ * @param names - tablica nazw miast;
+ * @param number - liczba nazw miast;
+ * @param output - plik na opisy dróg krajowych.
+ * @return Zwraca @p false, jeśli numer jest niepoprawny.
+ */
+static bool printName(const char **position, const char *end,
+                      const ResponseName *names, uint64_t number,
+                      FILE *output) {
+  uint64_t city;
+  if (!readNumber(position, end, &city) || city >= number) {
+    return false;
+  }
+  fwrite(names[city].name, 1, names[city].length, output);
+  return true;
+}
+
+/**
+ * Wypisuje opis drogi krajowej z rekordu GET_ROUTE_DESCR.
+ * @param position - wskaźnik na treść rekordu za jego rodzajem;
+ * @param end - wskaźnik na koniec treści rekordu;
+ * @param names - tablica nazw miast;
+ * @param number - liczba nazw miast;
+ * @param output - plik na opisy dróg krajowych.
+ * @return Zwraca @p false, jeśli rekord ma niepoprawny format.
+ */
+static bool printRouteRecord(const char *position, const char *end,
+                             const ResponseName *names, uint64_t number,
+                             FILE *output) {
+  uint64_t cities, value;
+  if (!readNumber(&position, end, &cities)) {
+    return false;
+  }
+  if (cities > 0) {
+    if (!readNumber(&position, end, &value)) {
+      return false;
+    }
+    fprintf(output, "%llu;", (unsigned long long) value);
+    if (!printName(&position, end, names, number, output)) {
+      return false;
+    }
+  }
+  for (uint64_t i = 1; i < cities; i++) {
+    int year;
+    if (!readNumber(&position, end, &value) ||
+        !readYear(&position, end, &year)) {
+      return false;
+    }
+    fprintf(output, ";%llu;%d;", (unsigned long long) value, year);
+    if (!printName(&position, end, names, number, output)) {
+      return false;
+    }
+  }
+  fputc('\n', output);
+  return position == end;
+}
+
+bool printResponses(const char *data, size_t size, FILE *output,
+                    FILE *errors) {
+  if (size < MAGIC_LENGTH || memcmp(data, RESPONSE_MAGIC, MAGIC_LENGTH) != 0) {
+    return false;
+  }
+  const char *end = data + size;
+  const char *position = data + MAGIC_LENGTH;
+  ResponseName *names = NULL;
+  size_t number = 0, capacity = 0;
+  bool valid = true;
+  while (valid && position < end) {
+    uint64_t length, line;
+    valid = readNumber(&position, end, &length) && length > 0 &&
+            length <= (uint64_t) (end - position);
+    if (!valid) {
+      break;
+    }
+    const char *record = position + 1;
+    position += length;
+    switch ((unsigned char) record[-1]) {
+      case BINARY_CITY:
+        if (number == capacity) {
+          capacity = capacity ? 2 * capacity : INITIAL_CITIES;
+          ResponseName *grown = realloc(names, capacity * sizeof(ResponseName));
+          if (!grown) {
+            valid = false;
+            break;
+          }
+          names = grown;
+        }
+        names[number].name = record;
+        names[number++].length = (size_t) (position - record);
+        break;
+      case GET_ROUTE_DESCR:
+        valid = printRouteRecord(record, position, names, number, output);
+        break;
+      case BINARY_WRONG:
+        valid = readNumber(&record, position, &line) && record == position;
+        if (valid) {
+          fprintf(errors, "ERROR %llu\n", (unsigned long long) line);
+        }
+        break;
+      default:
+        valid = false;
+    }
+  }
+  free(names);
+  return valid;
+}
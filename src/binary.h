@@ -0,0 +1,177 @@
+/** @file
+ * Interfejs binarnego formatu poleceń i odpowiedzi.
+ *
+ * Strumień poleceń zaczyna się nagłówkiem COMMAND_MAGIC, a strumień odpowiedzi
+ * nagłówkiem RESPONSE_MAGIC. Dalej następują rekordy: długość treści rekordu
+ * zapisana jako liczba o zmiennej długości, a następnie treść, której pierwszy
+ * bajt określa rodzaj rekordu.
+ *
+ * Liczby o zmiennej długości zapisywane są po 7 bitów w bajcie, od najmniej
+ * znaczących, a najstarszy bit bajtu oznacza, że liczba ma kolejne bajty.
+ * Daty remontu, które mogą być ujemne, są przed zapisaniem przekształcane tak,
+ * aby liczby o małej wartości bezwzględnej miały krótki zapis: 0, -1, 1, -2, 2,
+ * ... stają się liczbami 0, 1, 2, 3, 4, ...
+ *
+ * Nazwy miast nie są powtarzane w poleceniach. Rekord BINARY_CITY, którego
+ * treścią poza rodzajem jest nazwa miasta, nadaje jej kolejny numer od 0,
+ * a polecenia podają numery nazw. Treści rekordów poleceń są następujące
+ * (N - numer nazwy miasta, L - liczba, R - data remontu):
+ * - GET_ROUTE: L numer drogi krajowej, L liczba miast, N pierwsze miasto, a dla
+ *   każdego kolejnego miasta: L długość odcinka, R data remontu, N miasto;
+ * - ADD_ROAD: N, N, L długość odcinka, R rok budowy;
+ * - REPAIR_ROAD: N, N, R data remontu;
+ * - GET_ROUTE_DESCR i REMOVE_ROUTE: L numer drogi krajowej;
+ * - NEW_ROUTE: L numer drogi krajowej, N, N;
+ * - EXTEND_ROUTE: L numer drogi krajowej, N;
+ * - REMOVE_ROAD: N, N;
+ * - BINARY_IGNORE: pusta, odpowiada pustej linii lub komentarzowi;
+ * - BINARY_WRONG: pusta, odpowiada niepoprawnej linii.
+ *
+ * Każdy rekord poza BINARY_CITY odpowiada jednej linii wejścia tekstowego
+ * i jest uwzględniany w numeracji linii w komunikatach o błędach.
+ *
+ * W strumieniu odpowiedzi rekord BINARY_CITY również nadaje numery nazwom
+ * miast, rekord GET_ROUTE_DESCR zawiera L liczbę miast drogi krajowej (0, gdy
+ * jej nie ma), a dalej L numer drogi krajowej i jej przebieg zapisany tak jak
+ * w poleceniu GET_ROUTE, a rekord BINARY_WRONG zawiera L numer linii, której
+ * polecenie zakończyło się błędem.
+ *
+ * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
+ * @date 01.09.2019
+ */
+
+#ifndef DROGI_BINARY_H
+#define DROGI_BINARY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "input.h"
+
+#define COMMAND_MAGIC "\0DROGI-C" ///< Nagłówek strumienia poleceń.
+#define RESPONSE_MAGIC "\0DROGI-R" ///< Nagłówek strumienia odpowiedzi.
+#define MAGIC_LENGTH 8 ///< Długość nagłówka strumienia.
+#define MAX_NUMBER_LENGTH 10 ///< Największa długość zapisu liczby.
+#define BINARY_CITY 8 ///< Rodzaj rekordu nadającego numer nazwie miasta.
+#define BINARY_IGNORE 9 ///< Rodzaj rekordu pustej linii lub komentarza.
+#define BINARY_WRONG 10 ///< Rodzaj rekordu niepoprawnej linii lub błędu.
+
+/**
+ * Struktura przechowująca stan zapisywania strumienia binarnego.
+ */
+typedef struct BinaryWriter BinaryWriter;
+
+/**@brief Podaje długość rekordu.
+ * @param data - wskaźnik na początek rekordu;
+ * @param size - liczba dostępnych bajtów.
+ * @return Zwraca długość całego rekordu razem z zapisem długości treści lub 0,
+ * jeśli dostępne bajty nie zawierają całego zapisu długości. Długość może być
+ * większa niż @p size.
+ */
+size_t recordSize(const char *data, size_t size);
+
+/**@brief Sprawdza, czy dane zawierają cały rekord polecenia.
+ * Poprzedzające polecenie rekordy BINARY_CITY muszą być kompletne.
+ * @param data - wskaźnik na początek rekordu;
+ * @param size - liczba dostępnych bajtów.
+ * @return Zwraca @p true, jeśli do rozpoznania polecenia nie trzeba czytać
+ * dalszych bajtów. W przeciwnym razie zwraca @p false.
+ */
+bool commandComplete(const char *data, size_t size);
+
+/**@brief Rozpoznaje rekord strumienia poleceń.
+ * Rekordy BINARY_CITY zapamiętują nazwę miasta i nie są poleceniami. Nazwy
+ * poleceń wskazują na zapamiętane nazwy, a pole @p routeFields polecenia
+ * GET_ROUTE na opis drogi krajowej w treści rekordu. Nazwy, które nie mogłyby
+ * wystąpić w poleceniu tekstowym, mają długość 0.
+ * @param command - wskaźnik na wyzerowaną strukturę komendy, wypełnianą tak
+ * jak w readLine();
+ * @param data - wskaźnik na cały rekord;
+ * @param size - długość rekordu podana przez recordSize().
+ * @return Zwraca rodzaj rozpoznanego polecenia, IGNORE, WRONG_COMMAND,
+ * MEMORY_ERROR albo BINARY_CITY.
+ */
+int decodeRecord(Command *command, char *data, size_t size);
+
+/**@brief Zaczyna przeglądanie odcinków drogi krajowej zapisanej binarnie.
+ * @param cursor - wskaźnik na strukturę przeglądania odcinków, której pola
+ * @p city i @p next zostaną ustawione;
+ * @param fields - wskaźnik na numer nazwy pierwszego miasta w rekordzie
+ * GET_ROUTE sprawdzonym przez decodeRecord().
+ */
+void startSegments(SegmentCursor *cursor, const char *fields);
+
+/**@brief Odczytuje kolejny odcinek drogi krajowej zapisanej binarnie.
+ * @param cursor - wskaźnik na strukturę przeglądania odcinków, której pole
+ * @p next wskazuje na zapis odcinka;
+ * @param segment - wskaźnik na strukturę, do której zostanie zapisany
+ * odcinek.
+ */
+void decodeSegment(SegmentCursor *cursor, RouteSegment *segment);
+
+/**@brief Usuwa zapamiętane nazwy miast.
+ * Należy wywołać po zwolnieniu wszystkich poleceń rozpoznanych funkcją
+ * decodeRecord().
+ */
+void freeBinaryCities(void);
+
+/**@brief Zaczyna zapisywanie strumienia binarnego.
+ * Zapisuje nagłówek strumienia.
+ * @param file - plik, do którego zapisywane są rekordy;
+ * @param magic - nagłówek: COMMAND_MAGIC lub RESPONSE_MAGIC.
+ * @return Zwraca wskaźnik na utworzoną strukturę lub NULL, jeśli nie udało
+ * się zaalokować pamięci lub zapisać nagłówka.
+ */
+BinaryWriter *newBinaryWriter(FILE *file, const char *magic);
+
+/**@brief Kończy zapisywanie strumienia binarnego.
+ * Opróżnia bufor pliku i zwalnia pamięć struktury.
+ * @param writer - wskaźnik na strukturę lub NULL.
+ * @return Zwraca @p false, jeśli nie udało się zapisać danych.
+ * W przeciwnym razie zwraca @p true.
+ */
+bool deleteBinaryWriter(BinaryWriter *writer);
+
+/**@brief Zapisuje polecenie.
+ * Polecenia niepoprawne (zob. validCommand()) są zapisywane jako rekord
+ * BINARY_WRONG, a pominięte linie jako BINARY_IGNORE. Nazwy miast, które nie
+ * zostały jeszcze zapisane, są zapisywane przed poleceniem.
+ * @param writer - wskaźnik na strukturę zapisującą strumień poleceń;
+ * @param command - wskaźnik na rozpoznane polecenie, różne od EOF_FOUND.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+bool writeCommand(BinaryWriter *writer, const Command *command);
+
+/**@brief Zapisuje opis drogi krajowej.
+ * @param writer - wskaźnik na strukturę zapisującą strumień odpowiedzi;
+ * @param description - opis drogi krajowej w formacie podanym przy
+ * getRouteDescription() albo pusty napis.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+bool writeDescription(BinaryWriter *writer, const char *description);
+
+/**@brief Zapisuje informację o błędzie.
+ * @param writer - wskaźnik na strukturę zapisującą strumień odpowiedzi;
+ * @param line - numer linii polecenia.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+bool writeError(BinaryWriter *writer, int line);
+
+/**@brief Zamienia strumień odpowiedzi na tekst.
+ * Opisy dróg krajowych są wypisywane do pliku @p output, a komunikaty ERROR n
+ * do pliku @p errors, tak jak przy wejściu tekstowym.
+ * @param data - wskaźnik na strumień odpowiedzi razem z nagłówkiem;
+ * @param size - długość strumienia;
+ * @param output - plik na opisy dróg krajowych;
+ * @param errors - plik na komunikaty o błędach.
+ * @return Zwraca @p false, jeśli strumień ma niepoprawny format lub nie udało
+ * się zaalokować pamięci. W przeciwnym razie zwraca @p true.
+ */
+bool printResponses(const char *data, size_t size, FILE *output,
+                    FILE *errors);
+
+#endif //DROGI_BINARY_H
@@ -20,37 +20,29 @@
 struct CityHashMap {
   unsigned length; ///< Długość tablicy list miast.
   CityList **cities; ///< Tablica przechowująca wskaźniki na początki list miast
-  int *hashTable; ///< Tablica hashująca.
   unsigned numberOfCities; ///< Liczba miast w hashmapie.
 };
 
-/**@brief Tworzy tablicę.
- * Tworzy nową tablicę hashującą o długości zdefiniowanej stałą TABLE_LENGTH.
- * Wypełnia kolejne jej komórki kolejnymi liczbami pierwszymi.
- * @return Zwraca wskaźnik na utworzoną strukturę lub NULL, jeśli nie udało się
- * zaalokować pamięci.
+/**
+ * Kolejne liczby pierwsze, przez które mnożone są znaki nazwy miasta.
  */
-static int *createHashTable() {
-  int *array;
-  if (!(array = malloc(TABLE_LENGTH * sizeof(int)))) {
-    return NULL;
+static const int hashTable[TABLE_LENGTH] = {11, 13, 17, 19, 23, 29, 31, 37,
+                                            41, 43};
+
+unsigned cityIndex(const char *cityName, size_t length) {
+  unsigned index = 0;
+  for (size_t i = 0; i < length; i++) {
+    index += (unsigned) abs((int) (cityName[i] - '0') *
+                            hashTable[i % TABLE_LENGTH]) % CITIES_NUMBER;
+    if (index >= CITIES_NUMBER) {
+      index -= CITIES_NUMBER;
+    }
   }
-  array[0] = 11;
-  array[1] = 13;
-  array[2] = 17;
-  array[3] = 19;
-  array[4] = 23;
-  array[5] = 29;
-  array[6] = 31;
-  array[7] = 37;
-  array[8] = 41;
-  array[9] = 43;
-  return array;
+  return index;
 }
 
 /**@brief Generuje indeks.
- * Na podstawie nazwy miasta i stałych CITIES_NUMBER, TABLE_LENGTH generuje nowy
- * indeks określający potencjalną pozycję miasta w hashmapie.
+ * Wyznacza funkcją cityIndex() potencjalną pozycję miasta w hashmapie.
  * @param cityName - wskaźnik na napis będący nazwą miasta;
  * @param hashMap - wskaźnik na hashmapę.
  * @return Zwraca wygenerowany indeks lub -1, jeśli któryś z parametrów wskazuje
@@ -60,16 +52,7 @@ static int generateIndex(const char *cityName, CityHashMap *hashMap) {
   if (!cityName || !hashMap) {
     return -1;
   }
-  int index = 0;
-  unsigned i = 0;
-  unsigned length = strlen(cityName);
-  while (i < length) {
-    index += abs((int)(cityName[i] - '0') * hashMap->hashTable[i % TABLE_LENGTH]) %
-            CITIES_NUMBER;
-    index = abs (index % CITIES_NUMBER);
-    i++;
-  }
-  return index;
+  return (int) cityIndex(cityName, strlen(cityName));
 }
 
 CityHashMap *newCityHashMap() {
@@ -85,25 +68,12 @@ CityHashMap *newCityHashMap() {
   for (int i = 0; i < CITIES_NUMBER; i++) {
     new->cities[i] = NULL;
   }
-  if (!(new->hashTable = createHashTable())) {
-    free(new->cities);
-    free(new);
-    return NULL;
-  }
   new->numberOfCities = 0;
   return new;
 }
 
-City *findCity(const char *cityName, CityHashMap *hashMap) {
-  int index = generateIndex(cityName, hashMap);
-  if (index == -1) {
-    return NULL;
-  }
+City *findCityAt(const char *cityName, unsigned index, CityHashMap *hashMap) {
   CityList *temp = hashMap->cities[index];
-
-  if (!temp) {
-    return NULL;
-  }
   while (temp != NULL && strcmp(temp->city->name, cityName) != 0) {
     temp = temp->next;
   }
@@ -113,6 +83,14 @@ City *findCity(const char *cityName, CityHashMap *hashMap) {
   return temp->city;
 }
 
+City *findCity(const char *cityName, CityHashMap *hashMap) {
+  int index = generateIndex(cityName, hashMap);
+  if (index == -1) {
+    return NULL;
+  }
+  return findCityAt(cityName, (unsigned) index, hashMap);
+}
+
 /**@brief Kopiuje napis.
  * Alokuje potrzebną pamięć i kopiuje podaną nazwę miasta.
  * @param cityName - napis reprezentujący nazwę miasta.
@@ -150,6 +128,10 @@ static City *newCity(const char *name) {
   }
   new->roads = newRoadHashMap(new);
   new->index = 0;
+  new->citiesArrayIndex = 0;
+  new->adjacent = NULL;
+  new->degree = 0;
+  new->adjacentSize = 0;
   if (!(new->routesPassing = malloc(ROUTES_NUMBER * sizeof(bool)))) {
     free((void *) new->name);
     free(new);
@@ -161,12 +143,11 @@ static City *newCity(const char *name) {
   return new;
 }
 
-City *addCity(const char *cityName, CityHashMap *hashMap) {
-  City *city = findCity(cityName, hashMap);
+City *addCityAt(const char *cityName, unsigned index, CityHashMap *hashMap) {
+  City *city = findCityAt(cityName, index, hashMap);
   if (city != NULL) {
     return city;
   }
-  int index = generateIndex(cityName, hashMap);
   CityList *temp = hashMap->cities[index];
   CityList *newNode = newCityNode();
   if (!newNode) {
@@ -178,6 +159,7 @@ City *addCity(const char *cityName, CityHashMap *hashMap) {
     return NULL;
   }
   city->index = index;
+  city->citiesArrayIndex = hashMap->numberOfCities;
   newNode->city = city;
   if (!temp) {
     hashMap->cities[index] = newNode;
@@ -192,6 +174,14 @@ City *addCity(const char *cityName, CityHashMap *hashMap) {
   return newNode->city;
 }
 
+City *addCity(const char *cityName, CityHashMap *hashMap) {
+  int index = generateIndex(cityName, hashMap);
+  if (index == -1) {
+    return NULL;
+  }
+  return addCityAt(cityName, (unsigned) index, hashMap);
+}
+
 /**@brief Usuwa strukturę.
  * Usuwa strukturę miasta zwalniając całą zaalokowaną pamięć.
  * @param city - wskaźnik na strukturę miasta.
@@ -205,6 +195,7 @@ static void deleteCity(City *city) {
     if (city->routesPassing) {
       free(city->routesPassing);
     }
+    free(city->adjacent);
     free(city);
   }
 }
@@ -225,9 +216,6 @@ static void deleteCityList(CityList *head) {
 
 void freeCityHashMap(CityHashMap *cityHashMap) {
   if (cityHashMap) {
-    if (cityHashMap->hashTable) {
-      free(cityHashMap->hashTable);
-    }
     if (cityHashMap->cities) {
       for (unsigned i = 0; i < cityHashMap->length; i++) {
         deleteCityList(cityHashMap->cities[i]);
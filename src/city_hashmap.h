@@ -9,6 +9,7 @@
 #define DROGI_CITY_HASHMAP_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include "structures.h"
 
 #define CITIES_NUMBER 6113 ///< Stała wyznaczająca długość tablicy w hashmapie.
@@ -25,6 +26,17 @@ typedef struct CityHashMap CityHashMap;
  */
 CityHashMap *newCityHashMap();
 
+/**@brief Wyznacza indeks nazwy miasta.
+ * Ten sam indeks określa pozycję miasta w hashmapie miast i pozycję odcinka
+ * drogi prowadzącego do tego miasta w hashmapie odcinków dróg, więc można go
+ * wyznaczyć raz i przekazywać do funkcji findCityAt(), addCityAt()
+ * i findRoadAt().
+ * @param cityName - wskaźnik na nazwę miasta;
+ * @param length - długość nazwy.
+ * @return Zwraca indeks z przedziału od 0 do CITIES_NUMBER - 1.
+ */
+unsigned cityIndex(const char *cityName, size_t length);
+
 /**@brief Dodaje miasto do hashmapy.
  * Tworzy nową struktuę miasta o podanej nazwie, alokując potrzebną pamięć.
  * Następnie umieszcza ją w hashmapie.
@@ -35,6 +47,16 @@ CityHashMap *newCityHashMap();
  */
 City *addCity(const char *cityName, CityHashMap *hashMap);
 
+/**@brief Dodaje miasto o wyznaczonym indeksie do hashmapy.
+ * Działa tak jak addCity(), ale nie wyznacza indeksu nazwy.
+ * @param cityName - wskaźnik na nazwę miasta, które ma być dodane;
+ * @param index - indeks nazwy wyznaczony funkcją cityIndex();
+ * @param hashMap - wskaźnik na strukturę przechowującą hashmapę.
+ * @return Zwraca wskaźnik na dodaną lub już istniejącą trukturę lub NULL jeśli
+ * wystąpił błąd alokacji pamięci.
+ */
+City *addCityAt(const char *cityName, unsigned index, CityHashMap *hashMap);
+
 /**@brief Szuka miasta w hashmapie.
  * Szuka miasta o podanej nazwie w hashmapie.
  * @param cityName - nazwa szukanego miasta;
@@ -45,6 +67,16 @@ City *addCity(const char *cityName, CityHashMap *hashMap);
  */
 City *findCity(const char *cityName, CityHashMap *hashMap);
 
+/**@brief Szuka miasta o wyznaczonym indeksie w hashmapie.
+ * Działa tak jak findCity(), ale nie wyznacza indeksu nazwy.
+ * @param cityName - nazwa szukanego miasta;
+ * @param index - indeks nazwy wyznaczony funkcją cityIndex();
+ * @param hashMap - hashmapa, w której będzie szukane.
+ * @return wskaźnik na strukturę City znajdującą się w hashmapie lub NULL, jeśli
+ * miasto o podanej nazwie nie istnieje.
+ */
+City *findCityAt(const char *cityName, unsigned index, CityHashMap *hashMap);
+
 /**@brief Usuwa hashmapę.
  * Zwalnia całą zaalokowaną pamięć - miasta oraz łączące je drogi i samą
  * hashmapę.
@@ -0,0 +1,425 @@
+/**@file
+ * Implementacja connectivity.h.
+ *
+ * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
+ * @date 01.09.2019
+ */
+
+#include <stdlib.h>
+#include <limits.h>
+
+#include "connectivity.h"
+
+///Numer składowej miasta, które nie zostało jeszcze dodane do struktury.
+#define NO_COMPONENT UINT_MAX
+
+/**
+ * Struktura przechowująca jedną spójną składową.
+ */
+typedef struct Component {
+  City **members; ///< Tablica miast należących do składowej.
+  unsigned size; ///< Liczba miast w składowej.
+  unsigned capacity; ///< Rozmiar tablicy miast.
+} Component;
+
+/**
+ * Struktura przechowująca podział miast na spójne składowe.
+ */
+struct Connectivity {
+  unsigned *label; ///< Numer składowej dla każdego indeksu miasta.
+  unsigned *position; ///< Pozycja miasta w tablicy jego składowej.
+  unsigned *mark; ///< Znaczniki odwiedzenia miast w przeszukiwaniu.
+  City **queue1; ///< Kolejka przeszukiwania z pierwszego końca odcinka.
+  City **queue2; ///< Kolejka przeszukiwania z drugiego końca odcinka.
+  unsigned citiesSize; ///< Rozmiar tablic indeksowanych numerami miast.
+  unsigned markNumber; ///< Znacznik pierwszego przeszukiwania w bieżącym sprawdzeniu.
+  Component *components; ///< Tablica składowych.
+  unsigned componentsSize; ///< Liczba utworzonych składowych.
+  unsigned *freeComponents; ///< Stos numerów pustych składowych.
+  unsigned freeNumber; ///< Liczba elementów na stosie pustych składowych.
+  bool stale; ///< Czy składowe wymagają przeliczenia.
+};
+
+Connectivity *newConnectivity(void) {
+  Connectivity *new = calloc(1, sizeof(Connectivity));
+  if (!new) {
+    return NULL;
+  }
+  new->markNumber = 2;
+  return new;
+}
+
+void freeConnectivity(Connectivity *connectivity) {
+  if (connectivity) {
+    for (unsigned i = 0; i < connectivity->componentsSize; i++) {
+      free(connectivity->components[i].members);
+    }
+    free(connectivity->components);
+    free(connectivity->freeComponents);
+    free(connectivity->label);
+    free(connectivity->position);
+    free(connectivity->mark);
+    free(connectivity->queue1);
+    free(connectivity->queue2);
+    free(connectivity);
+  }
+}
+
+/**
+ * Powiększa tablicę, jeśli jest za mała.
+ * @param array - wskaźnik na powiększaną tablicę;
+ * @param elementSize - rozmiar elementu tablicy;
+ * @param size - nowy rozmiar tablicy.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool resize(void **array, size_t elementSize, unsigned size) {
+  void *new = realloc(*array, size * elementSize);
+  if (!new) {
+    return false;
+  }
+  *array = new;
+  return true;
+}
+
+/**
+ * Powiększa tablice indeksowane numerami miast tak, aby mieściły miasto
+ * o podanym indeksie.
+ * @param connectivity - wskaźnik na strukturę składowych;
+ * @param index - indeks miasta.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool reserveCities(Connectivity *connectivity, unsigned index) {
+  if (index < connectivity->citiesSize) {
+    return true;
+  }
+  unsigned size = 2 * connectivity->citiesSize;
+  if (size <= index) {
+    size = index + 1;
+  }
+  if (!resize((void **) &(connectivity->label), sizeof(unsigned), size) ||
+      !resize((void **) &(connectivity->position), sizeof(unsigned), size) ||
+      !resize((void **) &(connectivity->mark), sizeof(unsigned), size) ||
+      !resize((void **) &(connectivity->queue1), sizeof(City *), size) ||
+      !resize((void **) &(connectivity->queue2), sizeof(City *), size)) {
+    return false;
+  }
+  for (unsigned i = connectivity->citiesSize; i < size; i++) {
+    connectivity->label[i] = NO_COMPONENT;
+    connectivity->mark[i] = 0;
+  }
+  connectivity->citiesSize = size;
+  return true;
+}
+
+/**
+ * Powiększa tablicę miast składowej tak, aby mieściła podaną liczbę miast.
+ * @param component - wskaźnik na składową;
+ * @param capacity - wymagany rozmiar tablicy.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool reserveMembers(Component *component, unsigned capacity) {
+  if (component->capacity >= capacity) {
+    return true;
+  }
+  if (capacity < 2 * component->capacity) {
+    capacity = 2 * component->capacity;
+  }
+  if (!resize((void **) &(component->members), sizeof(City *), capacity)) {
+    return false;
+  }
+  component->capacity = capacity;
+  return true;
+}
+
+/**
+ * Tworzy puste składowe tak, aby było ich łącznie podana liczba, i odkłada je
+ * na stos pustych składowych.
+ * @param connectivity - wskaźnik na strukturę składowych;
+ * @param number - wymagana liczba składowych.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool addComponents(Connectivity *connectivity, unsigned number) {
+  if (!resize((void **) &(connectivity->components), sizeof(Component),
+              number) ||
+      !resize((void **) &(connectivity->freeComponents), sizeof(unsigned),
+              number)) {
+    return false;
+  }
+  for (unsigned i = connectivity->componentsSize; i < number; i++) {
+    Component *component = &(connectivity->components[i]);
+    component->members = NULL;
+    component->size = 0;
+    component->capacity = 0;
+    connectivity->freeComponents[(connectivity->freeNumber)++] = i;
+  }
+  connectivity->componentsSize = number;
+  return true;
+}
+
+/**
+ * Zapewnia, że na stosie pustych składowych znajduje się składowa mogąca
+ * pomieścić podaną liczbę miast. Nie zdejmuje jej ze stosu.
+ * @param connectivity - wskaźnik na strukturę składowych;
+ * @param capacity - wymagana liczba miast.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool prepareComponent(Connectivity *connectivity, unsigned capacity) {
+  if (connectivity->freeNumber == 0 &&
+      !addComponents(connectivity, connectivity->componentsSize + 1)) {
+    return false;
+  }
+  unsigned top = connectivity->freeComponents[connectivity->freeNumber - 1];
+  return reserveMembers(&(connectivity->components[top]), capacity);
+}
+
+/**
+ * Dodaje miasto na koniec tablicy składowej i zapamiętuje jego położenie.
+ * Zakłada, że tablica składowej jest wystarczająco duża.
+ * @param connectivity - wskaźnik na strukturę składowych;
+ * @param label - numer składowej;
+ * @param city - wskaźnik na dodawane miasto.
+ */
+static void appendMember(Connectivity *connectivity, unsigned label,
+                         City *city) {
+  Component *component = &(connectivity->components[label]);
+  connectivity->label[city->citiesArrayIndex] = label;
+  connectivity->position[city->citiesArrayIndex] = component->size;
+  component->members[(component->size)++] = city;
+}
+
+/**
+ * Dodaje do struktury miasto jako osobną składową, jeśli jeszcze go w niej
+ * nie ma.
+ * @param connectivity - wskaźnik na strukturę składowych;
+ * @param city - wskaźnik na miasto.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool registerCity(Connectivity *connectivity, City *city) {
+  if (!reserveCities(connectivity, city->citiesArrayIndex)) {
+    return false;
+  }
+  if (connectivity->label[city->citiesArrayIndex] != NO_COMPONENT) {
+    return true;
+  }
+  if (!prepareComponent(connectivity, 1)) {
+    return false;
+  }
+  appendMember(connectivity,
+          connectivity->freeComponents[--(connectivity->freeNumber)], city);
+  return true;
+}
+
+bool reserveJoin(Connectivity *connectivity, City *city1, City *city2) {
+  if (!connectivity || !registerCity(connectivity, city1) ||
+      !registerCity(connectivity, city2)) {
+    return false;
+  }
+  unsigned label1 = connectivity->label[city1->citiesArrayIndex];
+  unsigned label2 = connectivity->label[city2->citiesArrayIndex];
+  if (label1 == label2) {
+    return true;
+  }
+  Component *component1 = &(connectivity->components[label1]);
+  Component *component2 = &(connectivity->components[label2]);
+  Component *larger = component1->size < component2->size ? component2 :
+                      component1;
+  return reserveMembers(larger, component1->size + component2->size);
+}
+
+void joinComponents(Connectivity *connectivity, City *city1, City *city2) {
+  if (!connectivity) {
+    return;
+  }
+  unsigned label1 = connectivity->label[city1->citiesArrayIndex];
+  unsigned label2 = connectivity->label[city2->citiesArrayIndex];
+  if (label1 == label2) {
+    return;
+  }
+  if (connectivity->components[label1].size <
+      connectivity->components[label2].size) {
+    unsigned temp = label1;
+    label1 = label2;
+    label2 = temp;
+  }
+  Component *smaller = &(connectivity->components[label2]);
+  for (unsigned i = 0; i < smaller->size; i++) {
+    appendMember(connectivity, label1, smaller->members[i]);
+  }
+  smaller->size = 0;
+  connectivity->freeComponents[(connectivity->freeNumber)++] = label2;
+}
+
+void invalidateComponents(Connectivity *connectivity) {
+  if (connectivity) {
+    connectivity->stale = true;
+  }
+}
+
+/**
+ * Wykonuje krok przeszukiwania wszerz: sprawdza sąsiadów pierwszego miasta
+ * w kolejce, pomijając podany odcinek drogi.
+ * @param connectivity - wskaźnik na strukturę składowych;
+ * @param queue - kolejka przeszukiwania;
+ * @param head - wskaźnik na indeks początku kolejki;
+ * @param tail - wskaźnik na indeks końca kolejki;
+ * @param own - znacznik miast odwiedzonych przez to przeszukiwanie;
+ * @param other - znacznik miast odwiedzonych przez drugie przeszukiwanie;
+ * @param road - pomijany odcinek drogi.
+ * @return Zwraca @p true, jeśli przeszukiwania się spotkały. W przeciwnym
+ * razie zwraca @p false.
+ */
+static bool searchStep(Connectivity *connectivity, City **queue,
+        unsigned *head, unsigned *tail, unsigned own, unsigned other,
+        Road *road) {
+  City *city = queue[(*head)++];
+  for (unsigned i = 0; i < city->degree; i++) {
+    Road *next = city->adjacent[i];
+    if (next == road) {
+      continue;
+    }
+    City *neighbour = isEqual(city, next->city1) ? next->city2 : next->city1;
+    unsigned *mark = &(connectivity->mark[neighbour->citiesArrayIndex]);
+    if (*mark == other) {
+      return true;
+    }
+    if (*mark != own) {
+      *mark = own;
+      queue[(*tail)++] = neighbour;
+    }
+  }
+  return false;
+}
+
+/**
+ * Przydziela dwa nowe znaczniki odwiedzenia miast. Gdy zabraknie numerów,
+ * zeruje znaczniki wszystkich miast.
+ * @param connectivity - wskaźnik na strukturę składowych.
+ * @return Zwraca pierwszy z przydzielonych znaczników. Drugi jest o jeden
+ * większy.
+ */
+static unsigned takeMarks(Connectivity *connectivity) {
+  if (connectivity->markNumber > UINT_MAX - 2) {
+    for (unsigned i = 0; i < connectivity->citiesSize; i++) {
+      connectivity->mark[i] = 0;
+    }
+    connectivity->markNumber = 2;
+  }
+  unsigned mark = connectivity->markNumber;
+  connectivity->markNumber += 2;
+  return mark;
+}
+
+/**@brief Przelicza składowe od nowa.
+ * Przeszukuje wszerz graf miast dodanych do struktury i numeruje jego spójne
+ * składowe. Całą pamięć alokuje przed zmianą składowych, więc w razie błędu
+ * struktura pozostaje niezmieniona.
+ * @param connectivity - wskaźnik na strukturę składowych.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool rebuildComponents(Connectivity *connectivity) {
+  City **cities = connectivity->queue2;
+  City **order = connectivity->queue1;
+  unsigned number = 0;
+  for (unsigned i = 0; i < connectivity->componentsSize; i++) {
+    Component *component = &(connectivity->components[i]);
+    for (unsigned j = 0; j < component->size; j++) {
+      cities[number++] = component->members[j];
+    }
+  }
+  unsigned *sizes = malloc((number + 1) * sizeof(unsigned));
+  if (!sizes) {
+    return false;
+  }
+  unsigned mark = takeMarks(connectivity);
+  unsigned count = 0, head = 0, tail = 0;
+  for (unsigned i = 0; i < number; i++) {
+    unsigned *cityMark = &(connectivity->mark[cities[i]->citiesArrayIndex]);
+    if (*cityMark == mark) {
+      continue;
+    }
+    *cityMark = mark;
+    unsigned start = tail;
+    order[tail++] = cities[i];
+    while (head < tail) {
+      searchStep(connectivity, order, &head, &tail, mark, mark + 1, NULL);
+    }
+    sizes[count++] = tail - start;
+  }
+  bool success = count <= connectivity->componentsSize ||
+                 addComponents(connectivity, count);
+  for (unsigned i = 0; success && i < count; i++) {
+    success = reserveMembers(&(connectivity->components[i]), sizes[i]);
+  }
+  if (!success) {
+    free(sizes);
+    return false;
+  }
+  for (unsigned i = 0; i < connectivity->componentsSize; i++) {
+    connectivity->components[i].size = 0;
+  }
+  unsigned position = 0;
+  for (unsigned i = 0; i < count; i++) {
+    for (unsigned j = 0; j < sizes[i]; j++) {
+      appendMember(connectivity, i, order[position++]);
+    }
+  }
+  connectivity->freeNumber = 0;
+  for (unsigned i = connectivity->componentsSize; i > count; i--) {
+    connectivity->freeComponents[(connectivity->freeNumber)++] = i - 1;
+  }
+  connectivity->stale = false;
+  free(sizes);
+  return true;
+}
+
+bool sameComponent(Connectivity *connectivity, City *city1, City *city2) {
+  if (isEqual(city1, city2)) {
+    return true;
+  }
+  if (!connectivity) {
+    return false;
+  }
+  if (connectivity->stale && !rebuildComponents(connectivity)) {
+    return true;
+  }
+  if (city1->citiesArrayIndex >= connectivity->citiesSize ||
+      city2->citiesArrayIndex >= connectivity->citiesSize) {
+    return false;
+  }
+  unsigned label = connectivity->label[city1->citiesArrayIndex];
+  return label != NO_COMPONENT &&
+         label == connectivity->label[city2->citiesArrayIndex];
+}
+
+int checkRemoval(Connectivity *connectivity, Road *road) {
+  if (!connectivity || !road) {
+    return CONNECTIVITY_ERROR;
+  }
+  if (!registerCity(connectivity, road->city1) ||
+      !registerCity(connectivity, road->city2)) {
+    return CONNECTIVITY_ERROR;
+  }
+  unsigned mark1 = takeMarks(connectivity);
+  unsigned mark2 = mark1 + 1;
+  unsigned head1 = 0, tail1 = 0, head2 = 0, tail2 = 0;
+  connectivity->queue1[tail1++] = road->city1;
+  connectivity->mark[road->city1->citiesArrayIndex] = mark1;
+  connectivity->queue2[tail2++] = road->city2;
+  connectivity->mark[road->city2->citiesArrayIndex] = mark2;
+  while (head1 < tail1 && head2 < tail2) {
+    if (searchStep(connectivity, connectivity->queue1, &head1, &tail1, mark1,
+                   mark2, road) ||
+        searchStep(connectivity, connectivity->queue2, &head2, &tail2, mark2,
+                   mark1, road)) {
+      return CONNECTED;
+    }
+  }
+  return SEPARATED;
+}
@@ -0,0 +1,92 @@
+/** @file
+ * Interfejs struktury przechowującej spójne składowe mapy dróg.
+ *
+ * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
+ * @date 01.09.2019
+ */
+
+#ifndef DROGI_CONNECTIVITY_H
+#define DROGI_CONNECTIVITY_H
+
+#include <stdbool.h>
+#include "structures.h"
+
+#define CONNECTED 0 ///< Wynik sprawdzenia: miasta pozostaną połączone.
+#define SEPARATED 1 ///< Wynik sprawdzenia: miasta zostaną rozdzielone.
+#define CONNECTIVITY_ERROR 2 ///< Wynik sprawdzenia: błąd alokacji pamięci.
+
+/**
+ * Struktura przechowująca podział miast na spójne składowe.
+ */
+typedef struct Connectivity Connectivity;
+
+/**@brief Tworzy nową strukturę.
+ * Tworzy strukturę, w której nie ma jeszcze żadnych miast. Miasta są dodawane
+ * przy pierwszym połączeniu ich odcinkiem drogi.
+ * @return Zwraca wskaźnik na utworzoną strukturę lub NULL, jeśli nie udało się
+ * zaalokować pamięci.
+ */
+Connectivity *newConnectivity(void);
+
+/**@brief Usuwa strukturę.
+ * Zwalnia całą pamięć zaalokowaną przez strukturę.
+ * @param connectivity - wskaźnik na usuwaną strukturę.
+ */
+void freeConnectivity(Connectivity *connectivity);
+
+/**@brief Przygotowuje połączenie składowych dwóch miast.
+ * Należy wywołać przed dodaniem odcinka drogi między podanymi miastami.
+ * Dodaje do struktury brakujące miasta jako osobne składowe i rezerwuje
+ * pamięć potrzebną funkcji @ref joinComponents.
+ * @param connectivity - wskaźnik na strukturę składowych;
+ * @param city1 - wskaźnik na pierwsze miasto;
+ * @param city2 - wskaźnik na drugie miasto.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci. W przeciwnym
+ * razie zwraca @p true.
+ */
+bool reserveJoin(Connectivity *connectivity, City *city1, City *city2);
+
+/**@brief Łączy składowe dwóch miast.
+ * Należy wywołać po dodaniu odcinka drogi między podanymi miastami, zaraz po
+ * udanym wywołaniu funkcji @ref reserveJoin dla tych miast. Jeśli miasta
+ * należą do różnych składowych, przenosi miasta mniejszej składowej do
+ * większej. Nie alokuje pamięci.
+ * @param connectivity - wskaźnik na strukturę składowych;
+ * @param city1 - wskaźnik na pierwsze miasto;
+ * @param city2 - wskaźnik na drugie miasto.
+ */
+void joinComponents(Connectivity *connectivity, City *city1, City *city2);
+
+/**@brief Oznacza składowe jako nieaktualne.
+ * Należy wywołać po usunięciu odcinka drogi, które nie zostało sprawdzone
+ * funkcją @ref checkRemoval. Składowe zostaną przeliczone przy następnym
+ * wywołaniu funkcji @ref sameComponent.
+ * @param connectivity - wskaźnik na strukturę składowych.
+ */
+void invalidateComponents(Connectivity *connectivity);
+
+/**@brief Sprawdza, czy miasta należą do tej samej składowej.
+ * Działa w czasie stałym, chyba że składowe są nieaktualne - wtedy najpierw
+ * przelicza je w czasie liniowym względem rozmiaru mapy.
+ * @param connectivity - wskaźnik na strukturę składowych;
+ * @param city1 - wskaźnik na pierwsze miasto;
+ * @param city2 - wskaźnik na drugie miasto.
+ * @return Zwraca @p true, jeśli między miastami istnieje droga. W przeciwnym
+ * razie zwraca @p false. Zwraca też @p true, jeśli nie udało się przeliczyć
+ * nieaktualnych składowych.
+ */
+bool sameComponent(Connectivity *connectivity, City *city1, City *city2);
+
+/**@brief Sprawdza, czy usunięcie odcinka drogi rozspójni mapę.
+ * Przeszukuje graf naprzemiennie z obu końców odcinka drogi, pomijając ten
+ * odcinek, aż przeszukiwania się spotkają lub któreś z nich wyczerpie swoją
+ * część grafu. Nie zmienia składowych.
+ * @param connectivity - wskaźnik na strukturę składowych;
+ * @param road - wskaźnik na odcinek drogi.
+ * @return Zwraca CONNECTED, jeśli końce odcinka drogi pozostaną połączone;
+ * SEPARATED, jeśli zostaną rozdzielone lub CONNECTIVITY_ERROR, jeśli nie
+ * udało się zaalokować pamięci.
+ */
+int checkRemoval(Connectivity *connectivity, Road *road);
+
+#endif //DROGI_CONNECTIVITY_H
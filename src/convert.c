@@ -0,0 +1,108 @@
+/** @file
+ * Program zamieniający polecenia i odpowiedzi między formatem tekstowym
+ * a binarnym opisanym w binary.h.
+ *
+ * Użycie: convert TRYB, gdzie TRYB to:
+ * - binary - zamienia polecenia ze standardowego wejścia na strumień binarny;
+ * - text - zamienia polecenia ze standardowego wejścia na linie tekstowe;
+ * - responses - zamienia binarny strumień odpowiedzi na opisy dróg krajowych
+ *   wypisywane na standardowe wyjście i komunikaty o błędach wypisywane na
+ *   standardowe wyjście diagnostyczne.
+ *
+ * Polecenia wejściowe mogą być w dowolnym z formatów. Polecenia niepoprawne
+ * zamieniane są na polecenia niepoprawne, a pominięte linie na pominięte
+ * linie, więc numeracja linii w komunikatach o błędach się nie zmienia.
+ *
+ * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
+ * @date 01.09.2019
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "input.h"
+#include "binary.h"
+
+#define READ_SIZE (1 << 20) ///< Rozmiar fragmentu czytanego naraz.
+
+/**@brief Zamienia polecenia ze standardowego wejścia.
+ * @param binary - informacja, czy polecenia mają być zapisane binarnie.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool convertCommands(bool binary) {
+  BinaryWriter *writer = NULL;
+  if (!startBlockInput() ||
+      (binary && !(writer = newBinaryWriter(stdout, COMMAND_MAGIC)))) {
+    finishBlockInput();
+    return false;
+  }
+  Command command;
+  initCommand(&command);
+  bool success = true;
+  while (success) {
+    readLine(&command);
+    if (command.commandType == EOF_FOUND) {
+      break;
+    }
+    if (command.commandType == MEMORY_ERROR) {
+      success = false;
+    }
+    else if (binary) {
+      success = writeCommand(writer, &command);
+    }
+    else {
+      printCommand(&command, stdout);
+    }
+  }
+  deleteCommand(&command);
+  finishBlockInput();
+  return deleteBinaryWriter(writer) && success;
+}
+
+/**@brief Zamienia binarny strumień odpowiedzi ze standardowego wejścia.
+ * @return Zwraca @p false, jeśli strumień ma niepoprawny format lub nie udało
+ * się zaalokować pamięci. W przeciwnym razie zwraca @p true.
+ */
+static bool convertResponses(void) {
+  char *data = NULL;
+  size_t size = 0, capacity = 0;
+  while (!feof(stdin) && !ferror(stdin)) {
+    if (capacity - size < READ_SIZE) {
+      capacity = capacity ? 2 * capacity : READ_SIZE;
+      char *grown = realloc(data, capacity);
+      if (!grown) {
+        free(data);
+        return false;
+      }
+      data = grown;
+    }
+    size += fread(data + size, 1, capacity - size, stdin);
+  }
+  bool success = printResponses(data, size, stdout, stderr);
+  free(data);
+  return success;
+}
+
+int main(int argc, char **argv) {
+  bool success;
+  if (argc == 2 && strcmp(argv[1], "binary") == 0) {
+    success = convertCommands(true);
+  }
+  else if (argc == 2 && strcmp(argv[1], "text") == 0) {
+    success = convertCommands(false);
+  }
+  else if (argc == 2 && strcmp(argv[1], "responses") == 0) {
+    success = convertResponses();
+  }
+  else {
+    fprintf(stderr, "usage: %s binary|text|responses\n", argv[0]);
+    return 2;
+  }
+  if (!success) {
+    fprintf(stderr, "%s: conversion failed\n", argv[0]);
+    return 1;
+  }
+  return 0;
+}
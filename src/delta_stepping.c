@@ -0,0 +1,704 @@
+/**@file
+ * Implementacja delta_stepping.h.
+ *
+ * Odległości miast są przechowywane jako 64-bitowe klucze (odległość w
+ * starszej połowie, odwrócona data najstarszego remontu w młodszej), więc
+ * lepsza droga ma zawsze mniejszy klucz i relaksacja sprowadza się do
+ * atomowego minimum. Miasta są rozdzielane do kubełków o szerokości delta
+ * według odległości; kubełki są przetwarzane po kolei, a w obrębie kubełka
+ * wszystkie wątki relaksują równolegle najpierw krótkie (nie dłuższe niż
+ * delta), a potem długie odcinki dróg. Poprzednie miasta na najlepszych
+ * drogach są wyznaczane dopiero po zakończeniu wyszukiwania.
+ *
+ * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
+ * @date 01.09.2019
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stdatomic.h>
+
+#include "delta_stepping.h"
+
+///Liczba kubełków przechowywanych w tablicy cyklicznej.
+#define WINDOW 64
+
+///Liczba odcinków dróg branych pod uwagę przy automatycznym wyborze delty.
+#define DELTA_SAMPLE 256
+
+///Klucz miasta, które nie zostało osiągnięte.
+#define UNREACHED UINT64_MAX
+
+///Numer kubełka oznaczający jego brak.
+#define NO_BUCKET UINT64_MAX
+
+/**
+ * Tablica miast powiększana w razie potrzeby.
+ */
+typedef struct Buffer {
+  City **items; ///< Elementy tablicy.
+  unsigned size; ///< Liczba elementów.
+  unsigned capacity; ///< Rozmiar zaalokowanej pamięci.
+} Buffer;
+
+/**
+ * Stan pojedynczego wątku.
+ */
+typedef struct ThreadState {
+  Buffer next; ///< Miasta do przetworzenia w kolejnej rundzie kubełka.
+  Buffer settled; ///< Miasta przetworzone przez wątek w bieżącym wyszukiwaniu.
+  Buffer buckets[WINDOW]; ///< Kubełki cykliczne wątku.
+  Buffer far; ///< Miasta z kubełków spoza tablicy cyklicznej.
+  uint64_t farMin; ///< Najmniejszy numer kubełka miast z tablicy @p far.
+  bool error; ///< Informacja, czy wystąpił błąd alokacji pamięci.
+  char padding[64]; ///< Odstęp zapobiegający współdzieleniu linii pamięci.
+} ThreadState;
+
+/**
+ * Miasto razem z kluczem, używane do sortowania wyniku.
+ */
+typedef struct SortedCity {
+  uint64_t key; ///< Klucz miasta.
+  City *city; ///< Wskaźnik na miasto.
+} SortedCity;
+
+/**
+ * Struktura przechowująca stan algorytmu.
+ */
+struct DeltaStepping {
+  ThreadPool *pool; ///< Pula wątków lub NULL.
+  unsigned threads; ///< Liczba wątków.
+  ThreadState *states; ///< Stany wątków.
+  unsigned fixedDelta; ///< Szerokość kubełka podana przy tworzeniu lub 0.
+  unsigned size; ///< Rozmiar tablic indeksowanych numerami miast.
+  unsigned citiesNumber; ///< Liczba miast w bieżącym wyszukiwaniu.
+  atomic_uint_least64_t *keys; ///< Klucze miast.
+  atomic_uint *frontierMark; ///< Numer rundy, w której miasto dodano do frontu.
+  atomic_uint *settledMark; ///< Numer wyszukiwania, w którym miasto przetworzono.
+  City **frontier; ///< Miasta przetwarzane w bieżącej rundzie.
+  unsigned frontierSize; ///< Liczba miast w bieżącej rundzie.
+  SortedCity *order; ///< Tablica do sortowania wyniku.
+  unsigned orderSize; ///< Liczba elementów tablicy do sortowania.
+  unsigned round; ///< Numer rundy używany do oznaczania frontu.
+  unsigned search; ///< Numer wyszukiwania używany do oznaczania miast.
+  City *start; ///< Miasto początkowe.
+  unsigned maxDistance; ///< Największa odległość od startu lub 0.
+  unsigned delta; ///< Szerokość kubełka w bieżącym wyszukiwaniu.
+  uint64_t bucket; ///< Numer bieżącego kubełka.
+  bool done; ///< Informacja, czy wyszukiwanie się zakończyło.
+  bool redistribute; ///< Informacja, czy trzeba rozdzielić miasta z @p far.
+  ReachableCities *result; ///< Struktura wyniku lub NULL.
+};
+
+DeltaStepping *newDeltaStepping(ThreadPool *pool, unsigned delta) {
+  DeltaStepping *new = calloc(1, sizeof(DeltaStepping));
+  if (!new) {
+    return NULL;
+  }
+  new->pool = pool;
+  new->threads = threadsNumber(pool);
+  new->fixedDelta = delta;
+  new->states = calloc(new->threads, sizeof(ThreadState));
+  if (!new->states) {
+    free(new);
+    return NULL;
+  }
+  return new;
+}
+
+/**
+ * Zwalnia pamięć tablicy miast.
+ * @param buffer - wskaźnik na tablicę.
+ */
+static void freeBuffer(Buffer *buffer) {
+  free(buffer->items);
+  buffer->items = NULL;
+  buffer->size = 0;
+  buffer->capacity = 0;
+}
+
+void freeDeltaStepping(DeltaStepping *engine) {
+  if (engine) {
+    for (unsigned i = 0; i < engine->threads; i++) {
+      ThreadState *state = &(engine->states[i]);
+      freeBuffer(&(state->next));
+      freeBuffer(&(state->settled));
+      freeBuffer(&(state->far));
+      for (unsigned j = 0; j < WINDOW; j++) {
+        freeBuffer(&(state->buckets[j]));
+      }
+    }
+    free(engine->states);
+    free(engine->keys);
+    free(engine->frontierMark);
+    free(engine->settledMark);
+    free(engine->frontier);
+    free(engine->order);
+    free(engine);
+  }
+}
+
+/**
+ * Dodaje miasto na koniec tablicy, powiększając ją w razie potrzeby.
+ * @param buffer - wskaźnik na tablicę;
+ * @param city - wskaźnik na dodawane miasto.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool pushCity(Buffer *buffer, City *city) {
+  if (buffer->size == buffer->capacity) {
+    unsigned capacity = buffer->capacity ? 2 * buffer->capacity : 16;
+    City **new = realloc(buffer->items, capacity * sizeof(City *));
+    if (!new) {
+      return false;
+    }
+    buffer->items = new;
+    buffer->capacity = capacity;
+  }
+  buffer->items[(buffer->size)++] = city;
+  return true;
+}
+
+/**
+ * Przygotowuje tablice indeksowane numerami miast na podaną liczbę miast.
+ * @param engine - wskaźnik na strukturę algorytmu;
+ * @param number - liczba miast.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool reserveCities(DeltaStepping *engine, unsigned number) {
+  if (engine->size >= number) {
+    return true;
+  }
+  atomic_uint_least64_t *keys = malloc(number * sizeof(*keys));
+  atomic_uint *frontierMark = malloc(number * sizeof(*frontierMark));
+  atomic_uint *settledMark = malloc(number * sizeof(*settledMark));
+  City **frontier = malloc(number * sizeof(City *));
+  SortedCity *order = malloc(number * sizeof(SortedCity));
+  if (!keys || !frontierMark || !settledMark || !frontier || !order) {
+    free(keys);
+    free(frontierMark);
+    free(settledMark);
+    free(frontier);
+    free(order);
+    return false;
+  }
+  for (unsigned i = 0; i < number; i++) {
+    atomic_init(&(frontierMark[i]), 0);
+    atomic_init(&(settledMark[i]), 0);
+  }
+  free(engine->keys);
+  free(engine->frontierMark);
+  free(engine->settledMark);
+  free(engine->frontier);
+  free(engine->order);
+  engine->keys = keys;
+  engine->frontierMark = frontierMark;
+  engine->settledMark = settledMark;
+  engine->frontier = frontier;
+  engine->order = order;
+  engine->size = number;
+  engine->round = 0;
+  engine->search = 0;
+  return true;
+}
+
+/**
+ * Tworzy klucz z odległości i daty najstarszego remontu.
+ * @param distance - odległość od startu;
+ * @param oldestRoad - data remontu najdawniej remontowanego odcinka.
+ * @return Zwraca klucz, mniejszy dla lepszej drogi.
+ */
+static uint64_t packKey(unsigned distance, int oldestRoad) {
+  return ((uint64_t) distance << 32) |
+         (uint32_t) ((int64_t) INT_MAX - oldestRoad);
+}
+
+/**
+ * Odczytuje odległość z klucza.
+ * @param key - klucz miasta.
+ * @return Zwraca odległość od startu.
+ */
+static unsigned keyDistance(uint64_t key) {
+  return (unsigned) (key >> 32);
+}
+
+/**
+ * Odczytuje z klucza datę remontu najdawniej remontowanego odcinka.
+ * @param key - klucz miasta.
+ * @return Zwraca datę remontu.
+ */
+static int keyOldestRoad(uint64_t key) {
+  return (int) ((int64_t) INT_MAX - (int64_t) (key & UINT32_MAX));
+}
+
+/**
+ * Podaje drugi koniec odcinka drogi.
+ * @param city - wskaźnik na jeden z końców odcinka;
+ * @param road - wskaźnik na odcinek drogi.
+ * @return Zwraca wskaźnik na drugi koniec odcinka.
+ */
+static City *otherEnd(City *city, Road *road) {
+  return isEqual(city, road->city1) ? road->city2 : road->city1;
+}
+
+/**
+ * Wybiera szerokość kubełka: średnią długość odcinków dróg w pobliżu miasta
+ * początkowego, jeśli nie została podana przy tworzeniu struktury.
+ * @param engine - wskaźnik na strukturę algorytmu.
+ * @return Zwraca szerokość kubełka.
+ */
+static unsigned chooseDelta(DeltaStepping *engine) {
+  if (engine->fixedDelta > 0) {
+    return engine->fixedDelta;
+  }
+  uint64_t sum = 0;
+  unsigned number = 0;
+  City *start = engine->start;
+  for (unsigned i = 0; i < start->degree && number < DELTA_SAMPLE; i++) {
+    City *neighbour = otherEnd(start, start->adjacent[i]);
+    for (unsigned j = 0; j < neighbour->degree && number < DELTA_SAMPLE; j++) {
+      sum += neighbour->adjacent[j]->length;
+      number++;
+    }
+  }
+  if (number == 0 || sum / number == 0) {
+    return 1;
+  }
+  return sum / number > UINT_MAX ? UINT_MAX : (unsigned) (sum / number);
+}
+
+/**
+ * Zapisuje, że miasto ma zostać przetworzone w podanym kubełku.
+ * @param engine - wskaźnik na strukturę algorytmu;
+ * @param state - wskaźnik na stan wątku;
+ * @param city - wskaźnik na miasto;
+ * @param bucket - numer kubełka.
+ */
+static void schedule(DeltaStepping *engine, ThreadState *state, City *city,
+                     uint64_t bucket) {
+  bool success;
+  if (bucket == engine->bucket) {
+    if (atomic_exchange_explicit(&(engine->frontierMark[city->citiesArrayIndex]),
+            engine->round, memory_order_relaxed) == engine->round) {
+      return;
+    }
+    success = pushCity(&(state->next), city);
+  }
+  else if (bucket < engine->bucket + WINDOW) {
+    success = pushCity(&(state->buckets[bucket % WINDOW]), city);
+  }
+  else {
+    success = pushCity(&(state->far), city);
+    if (bucket < state->farMin) {
+      state->farMin = bucket;
+    }
+  }
+  if (!success) {
+    state->error = true;
+  }
+}
+
+/**
+ * Relaksuje krótkie albo długie odcinki dróg wychodzące z miasta.
+ * @param engine - wskaźnik na strukturę algorytmu;
+ * @param state - wskaźnik na stan wątku;
+ * @param city - wskaźnik na miasto;
+ * @param light - @p true dla odcinków nie dłuższych niż delta, @p false dla
+ * pozostałych.
+ */
+static void relaxRoads(DeltaStepping *engine, ThreadState *state, City *city,
+                       bool light) {
+  uint64_t key = atomic_load_explicit(&(engine->keys[city->citiesArrayIndex]),
+          memory_order_relaxed);
+  unsigned distance = keyDistance(key);
+  int oldestRoad = keyOldestRoad(key);
+  for (unsigned i = 0; i < city->degree; i++) {
+    Road *road = city->adjacent[i];
+    if ((road->length <= engine->delta) != light) {
+      continue;
+    }
+    uint64_t newDistance = (uint64_t) distance + road->length;
+    if (newDistance > UINT_MAX ||
+        (engine->maxDistance != 0 && newDistance > engine->maxDistance)) {
+      continue;
+    }
+    int newOldest = road->lastRepair < oldestRoad ? road->lastRepair :
+                    oldestRoad;
+    uint64_t newKey = packKey((unsigned) newDistance, newOldest);
+    City *neighbour = otherEnd(city, road);
+    atomic_uint_least64_t *place = &(engine->keys[neighbour->citiesArrayIndex]);
+    uint64_t oldKey = atomic_load_explicit(place, memory_order_relaxed);
+    while (newKey < oldKey) {
+      if (atomic_compare_exchange_weak_explicit(place, &oldKey, newKey,
+              memory_order_relaxed, memory_order_relaxed)) {
+        schedule(engine, state, neighbour,
+                 (unsigned) (newDistance / engine->delta));
+        break;
+      }
+    }
+  }
+}
+
+/**
+ * Podaje numer kubełka miasta według jego bieżącego klucza.
+ * @param engine - wskaźnik na strukturę algorytmu;
+ * @param city - wskaźnik na miasto.
+ * @return Zwraca numer kubełka.
+ */
+static uint64_t bucketOf(DeltaStepping *engine, City *city) {
+  return keyDistance(atomic_load_explicit(
+          &(engine->keys[city->citiesArrayIndex]), memory_order_relaxed)) /
+          engine->delta;
+}
+
+/**
+ * Przenosi do tablicy frontu miasta zebrane przez wątki w tablicach @p next.
+ * Wykonywana przez jeden wątek.
+ * @param engine - wskaźnik na strukturę algorytmu.
+ */
+static void mergeFrontier(DeltaStepping *engine) {
+  engine->frontierSize = 0;
+  for (unsigned i = 0; i < engine->threads; i++) {
+    Buffer *next = &(engine->states[i].next);
+    for (unsigned j = 0; j < next->size; j++) {
+      engine->frontier[(engine->frontierSize)++] = next->items[j];
+    }
+    next->size = 0;
+  }
+  if (++(engine->round) == 0) {
+    for (unsigned i = 0; i < engine->size; i++) {
+      atomic_store(&(engine->frontierMark[i]), 0);
+    }
+    engine->round = 1;
+  }
+}
+
+/**
+ * Wybiera kolejny niepusty kubełek. Wykonywana przez jeden wątek.
+ * @param engine - wskaźnik na strukturę algorytmu.
+ */
+static void nextBucket(DeltaStepping *engine) {
+  uint64_t next = NO_BUCKET;
+  for (uint64_t k = 1; k < WINDOW && next == NO_BUCKET; k++) {
+    unsigned place = (engine->bucket + k) % WINDOW;
+    for (unsigned i = 0; i < engine->threads; i++) {
+      if (engine->states[i].buckets[place].size > 0) {
+        next = engine->bucket + k;
+        break;
+      }
+    }
+  }
+  uint64_t farMin = NO_BUCKET;
+  for (unsigned i = 0; i < engine->threads; i++) {
+    if (engine->states[i].farMin < farMin) {
+      farMin = engine->states[i].farMin;
+    }
+  }
+  if (farMin < next) {
+    next = farMin;
+  }
+  if (next == NO_BUCKET) {
+    engine->done = true;
+    return;
+  }
+  engine->redistribute = (farMin != NO_BUCKET && farMin < next + WINDOW);
+  engine->bucket = next;
+}
+
+/**
+ * Przenosi miasta z tablicy @p far wątku, które mieszczą się w tablicy
+ * cyklicznej, do odpowiednich kubełków.
+ * @param engine - wskaźnik na strukturę algorytmu;
+ * @param state - wskaźnik na stan wątku.
+ */
+static void redistribute(DeltaStepping *engine, ThreadState *state) {
+  Buffer *far = &(state->far);
+  unsigned kept = 0;
+  state->farMin = NO_BUCKET;
+  for (unsigned i = 0; i < far->size; i++) {
+    City *city = far->items[i];
+    uint64_t bucket = bucketOf(engine, city);
+    if (bucket < engine->bucket) {
+      continue;
+    }
+    if (bucket < engine->bucket + WINDOW) {
+      if (!pushCity(&(state->buckets[bucket % WINDOW]), city)) {
+        state->error = true;
+      }
+      continue;
+    }
+    far->items[kept++] = city;
+    if (bucket < state->farMin) {
+      state->farMin = bucket;
+    }
+  }
+  far->size = kept;
+}
+
+/**
+ * Podaje fragment tablicy przypadający na wątek.
+ * @param size - rozmiar tablicy;
+ * @param thread - numer wątku;
+ * @param threads - liczba wątków;
+ * @param begin - wskaźnik, pod który zostanie zapisany początek fragmentu;
+ * @param end - wskaźnik, pod który zostanie zapisany koniec fragmentu.
+ */
+static void slice(unsigned size, unsigned thread, unsigned threads,
+                  unsigned *begin, unsigned *end) {
+  *begin = (unsigned) ((uint64_t) size * thread / threads);
+  *end = (unsigned) ((uint64_t) size * (thread + 1) / threads);
+}
+
+/**
+ * Zadanie wykonywane przez każdy wątek: całe wyszukiwanie z miasta
+ * początkowego.
+ * @param thread - numer wątku;
+ * @param threads - liczba wątków;
+ * @param data - wskaźnik na strukturę algorytmu.
+ */
+static void searchTask(unsigned thread, unsigned threads, void *data) {
+  DeltaStepping *engine = data;
+  ThreadState *state = &(engine->states[thread]);
+  unsigned begin, end;
+  slice(engine->citiesNumber, thread, threads, &begin, &end);
+  for (unsigned i = begin; i < end; i++) {
+    atomic_store_explicit(&(engine->keys[i]), UNREACHED, memory_order_relaxed);
+  }
+  state->next.size = 0;
+  state->settled.size = 0;
+  state->far.size = 0;
+  state->farMin = NO_BUCKET;
+  state->error = false;
+  for (unsigned i = 0; i < WINDOW; i++) {
+    state->buckets[i].size = 0;
+  }
+  waitForThreads(engine->pool);
+  if (thread == 0) {
+    atomic_store(&(engine->keys[engine->start->citiesArrayIndex]), 0);
+    if (!pushCity(&(state->buckets[0]), engine->start)) {
+      state->error = true;
+    }
+  }
+  waitForThreads(engine->pool);
+  while (true) {
+    Buffer *bucket = &(state->buckets[engine->bucket % WINDOW]);
+    for (unsigned i = 0; i < bucket->size; i++) {
+      if (bucketOf(engine, bucket->items[i]) == engine->bucket) {
+        schedule(engine, state, bucket->items[i], engine->bucket);
+      }
+    }
+    bucket->size = 0;
+    unsigned bucketStart = state->settled.size;
+    waitForThreads(engine->pool);
+    if (thread == 0) {
+      mergeFrontier(engine);
+    }
+    waitForThreads(engine->pool);
+    while (engine->frontierSize > 0) {
+      slice(engine->frontierSize, thread, threads, &begin, &end);
+      for (unsigned i = begin; i < end; i++) {
+        City *city = engine->frontier[i];
+        if (atomic_exchange_explicit(
+                &(engine->settledMark[city->citiesArrayIndex]), engine->search,
+                memory_order_relaxed) != engine->search &&
+            !pushCity(&(state->settled), city)) {
+          state->error = true;
+        }
+        relaxRoads(engine, state, city, true);
+      }
+      waitForThreads(engine->pool);
+      if (thread == 0) {
+        mergeFrontier(engine);
+      }
+      waitForThreads(engine->pool);
+    }
+    for (unsigned i = bucketStart; i < state->settled.size; i++) {
+      relaxRoads(engine, state, state->settled.items[i], false);
+    }
+    waitForThreads(engine->pool);
+    if (thread == 0) {
+      nextBucket(engine);
+    }
+    waitForThreads(engine->pool);
+    if (engine->done) {
+      break;
+    }
+    if (engine->redistribute) {
+      redistribute(engine, state);
+    }
+  }
+}
+
+/**
+ * Przeprowadza wyszukiwanie z podanego miasta.
+ * @param engine - wskaźnik na strukturę algorytmu;
+ * @param start - miasto początkowe;
+ * @param hashMap - hashmapa miast;
+ * @param maxDistance - największa odległość od startu lub 0.
+ * @return Zwraca @p false, jeśli wystąpił błąd alokacji pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool runSearch(DeltaStepping *engine, City *start, CityHashMap *hashMap,
+                      unsigned maxDistance) {
+  unsigned number = numberOfCities(hashMap);
+  if (number == 0 || !reserveCities(engine, number)) {
+    return false;
+  }
+  if (++(engine->search) == 0) {
+    for (unsigned i = 0; i < engine->size; i++) {
+      atomic_store(&(engine->settledMark[i]), 0);
+    }
+    engine->search = 1;
+  }
+  if (++(engine->round) == 0) {
+    for (unsigned i = 0; i < engine->size; i++) {
+      atomic_store(&(engine->frontierMark[i]), 0);
+    }
+    engine->round = 1;
+  }
+  engine->citiesNumber = number;
+  engine->start = start;
+  engine->maxDistance = maxDistance;
+  engine->delta = chooseDelta(engine);
+  engine->bucket = 0;
+  engine->done = false;
+  engine->redistribute = false;
+  runParallel(engine->pool, searchTask, engine);
+  for (unsigned i = 0; i < engine->threads; i++) {
+    if (engine->states[i].error) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Porównuje miasta według klucza, a przy równych kluczach według kolejności
+ * dodania do mapy.
+ * @param first - wskaźnik na pierwszy element;
+ * @param second - wskaźnik na drugi element.
+ * @return Zwraca liczbę ujemną, zero lub dodatnią, jeśli pierwszy element jest
+ * odpowiednio mniejszy, równy lub większy od drugiego.
+ */
+static int compareCities(const void *first, const void *second) {
+  const SortedCity *city1 = first;
+  const SortedCity *city2 = second;
+  if (city1->key != city2->key) {
+    return city1->key < city2->key ? -1 : 1;
+  }
+  unsigned index1 = city1->city->citiesArrayIndex;
+  unsigned index2 = city2->city->citiesArrayIndex;
+  return (index1 > index2) - (index1 < index2);
+}
+
+/**
+ * Wypełnia opis osiągniętego miasta, wyznaczając poprzednie miasto na
+ * najlepszej drodze.
+ * @param engine - wskaźnik na strukturę algorytmu;
+ * @param city - wskaźnik na osiągnięte miasto;
+ * @param reached - wskaźnik na wypełniany opis.
+ */
+static void describeCity(DeltaStepping *engine, City *city,
+                         ReachedCity *reached) {
+  uint64_t key = atomic_load_explicit(&(engine->keys[city->citiesArrayIndex]),
+          memory_order_relaxed);
+  reached->city = city;
+  reached->distance = keyDistance(key);
+  reached->oldestRoad = keyOldestRoad(key);
+  reached->previous = NULL;
+  reached->connection = NULL;
+  if (isEqual(city, engine->start)) {
+    reached->oldestRoad = 0;
+    return;
+  }
+  for (unsigned i = 0; i < city->degree; i++) {
+    Road *road = city->adjacent[i];
+    City *neighbour = otherEnd(city, road);
+    uint64_t previous = atomic_load_explicit(
+            &(engine->keys[neighbour->citiesArrayIndex]), memory_order_relaxed);
+    if (previous == UNREACHED) {
+      continue;
+    }
+    int oldestRoad = keyOldestRoad(previous);
+    if (road->lastRepair < oldestRoad) {
+      oldestRoad = road->lastRepair;
+    }
+    uint64_t distance = (uint64_t) keyDistance(previous) + road->length;
+    if (distance <= UINT_MAX &&
+        packKey((unsigned) distance, oldestRoad) == key) {
+      reached->previous = neighbour;
+      reached->connection = road;
+      return;
+    }
+  }
+}
+
+/**
+ * Zadanie wykonywane przez każdy wątek: wypełnianie wyniku wyszukiwania.
+ * @param thread - numer wątku;
+ * @param threads - liczba wątków;
+ * @param data - wskaźnik na strukturę algorytmu.
+ */
+static void describeTask(unsigned thread, unsigned threads, void *data) {
+  DeltaStepping *engine = data;
+  unsigned begin, end;
+  slice(engine->orderSize, thread, threads, &begin, &end);
+  for (unsigned i = begin; i < end; i++) {
+    describeCity(engine, engine->order[i].city, &(engine->result->cities[i]));
+  }
+}
+
+bool parallelReachableCities(DeltaStepping *engine, City *start,
+        CityHashMap *hashMap, unsigned maxDistance, ReachableCities *result) {
+  if (!engine || !start || !result ||
+      !reserveReachableCities(result, numberOfCities(hashMap)) ||
+      !runSearch(engine, start, hashMap, maxDistance)) {
+    return false;
+  }
+  engine->orderSize = 0;
+  for (unsigned i = 0; i < engine->threads; i++) {
+    Buffer *settled = &(engine->states[i].settled);
+    for (unsigned j = 0; j < settled->size; j++) {
+      SortedCity *sorted = &(engine->order[(engine->orderSize)++]);
+      sorted->city = settled->items[j];
+      sorted->key = atomic_load_explicit(
+              &(engine->keys[sorted->city->citiesArrayIndex]),
+              memory_order_relaxed);
+    }
+  }
+  qsort(engine->order, engine->orderSize, sizeof(SortedCity), compareCities);
+  engine->result = result;
+  runParallel(engine->pool, describeTask, engine);
+  result->number = engine->orderSize;
+  return true;
+}
+
+bool parallelDistances(DeltaStepping *engine, City **sources,
+        unsigned sourcesNumber, City **targets, unsigned targetsNumber,
+        CityHashMap *hashMap, ReachedCity *result) {
+  if (!engine || !sources || !targets || !result) {
+    return false;
+  }
+  for (unsigned i = 0; i < sourcesNumber; i++) {
+    if (!runSearch(engine, sources[i], hashMap, 0)) {
+      return false;
+    }
+    for (unsigned j = 0; j < targetsNumber; j++) {
+      ReachedCity *reached = &(result[i * targetsNumber + j]);
+      if (atomic_load(&(engine->keys[targets[j]->citiesArrayIndex])) ==
+          UNREACHED) {
+        reached->city = NULL;
+        reached->distance = 0;
+        reached->oldestRoad = 0;
+        reached->previous = NULL;
+        reached->connection = NULL;
+      }
+      else {
+        describeCity(engine, targets[j], reached);
+      }
+    }
+  }
+  return true;
+}
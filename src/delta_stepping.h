@@ -0,0 +1,80 @@
+/** @file
+ * Interfejs równoległego algorytmu delta-stepping wyznaczającego najlepsze
+ * drogi z jednego miasta do wszystkich pozostałych.
+ *
+ * Drogi są porównywane tak samo jak w findBestRoute(): najpierw długość,
+ * a przy równej długości późniejsza data remontu najdawniej remontowanego
+ * odcinka.
+ *
+ * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
+ * @date 01.09.2019
+ */
+
+#ifndef DROGI_DELTA_STEPPING_H
+#define DROGI_DELTA_STEPPING_H
+
+#include <stdbool.h>
+#include "structures.h"
+#include "city_hashmap.h"
+#include "thread_pool.h"
+
+/**
+ * Struktura przechowująca stan algorytmu, zachowywany pomiędzy kolejnymi
+ * wyszukiwaniami.
+ */
+typedef struct DeltaStepping DeltaStepping;
+
+/**@brief Tworzy nową strukturę.
+ * @param pool - wskaźnik na pulę wątków, na której będą wykonywane
+ * wyszukiwania, lub NULL dla wyszukiwań jednowątkowych. Pula nie jest
+ * zwalniana razem ze strukturą;
+ * @param delta - szerokość kubełka w kilometrach lub 0, jeśli ma zostać
+ * dobrana automatycznie.
+ * @return Zwraca wskaźnik na utworzoną strukturę lub NULL, jeśli nie udało się
+ * zaalokować pamięci.
+ */
+DeltaStepping *newDeltaStepping(ThreadPool *pool, unsigned delta);
+
+/**@brief Usuwa strukturę.
+ * Zwalnia całą pamięć zaalokowaną przez strukturę.
+ * @param engine - wskaźnik na usuwaną strukturę.
+ */
+void freeDeltaStepping(DeltaStepping *engine);
+
+/**@brief Wyznacza drzewo najlepszych dróg z podanego miasta.
+ * Działa tak jak findReachableCities(). Miasta o tej samej odległości i dacie
+ * najstarszego remontu są uporządkowane według kolejności dodania do mapy,
+ * a przy kilku równie dobrych drogach poprzednie miasto jest wybierane
+ * dowolnie spośród nich.
+ * @param engine - wskaźnik na strukturę algorytmu;
+ * @param start - miasto początkowe;
+ * @param hashMap - hashmapa miast;
+ * @param maxDistance - największa odległość od startu lub 0, jeśli odległość
+ * nie jest ograniczona;
+ * @param result - wskaźnik na strukturę, do której zostanie zapisany wynik.
+ * @return Zwraca @p false, jeśli wystąpił błąd alokacji pamięci lub któryś
+ * z parametrów jest niepoprawny. W przeciwnym razie zwraca @p true.
+ */
+bool parallelReachableCities(DeltaStepping *engine, City *start,
+        CityHashMap *hashMap, unsigned maxDistance, ReachableCities *result);
+
+/**@brief Wyznacza najlepsze drogi między dwoma zbiorami miast.
+ * Dla każdej pary miasta z pierwszej i drugiej tablicy wyznacza długość
+ * i datę remontu najstarszego odcinka najlepszej drogi. Wynik dla pary
+ * (@p sources[i], @p targets[j]) jest zapisywany pod indeksem
+ * i * @p targetsNumber + j; pole @p city ma wartość NULL, jeśli drogi nie ma.
+ * @param engine - wskaźnik na strukturę algorytmu;
+ * @param sources - tablica miast początkowych;
+ * @param sourcesNumber - liczba miast początkowych;
+ * @param targets - tablica miast końcowych;
+ * @param targetsNumber - liczba miast końcowych;
+ * @param hashMap - hashmapa miast;
+ * @param result - tablica o rozmiarze @p sourcesNumber * @p targetsNumber.
+ * @return Zwraca @p false, jeśli wystąpił błąd alokacji pamięci lub któryś
+ * z parametrów jest niepoprawny. W przeciwnym razie zwraca @p true.
+ */
+bool parallelDistances(DeltaStepping *engine, City **sources,
+        unsigned sourcesNumber, City **targets, unsigned targetsNumber,
+        CityHashMap *hashMap, ReachedCity *result);
+
+#endif //DROGI_DELTA_STEPPING_H
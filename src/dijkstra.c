@@ -4,14 +4,24 @@
  * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
  * @date 01.09.2019
  */
+#ifdef _STDC_ALLOC_LIB_
+#define _STDC_WANT_LIB_EXT2_ 1
+#else
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
 
 #include "dijkstra.h"
 #include "structures.h"
 #include "priority_queue.h"
-#include "road_hashmap.h"
 
 #define INFINITY 0 ///< Stała traktowana jako nieskończenie duża.
+///Numer miasta początkowego oznaczający, że nie ma takiego miasta.
+#define NO_SOURCE UINT_MAX
 
 /**
  * Struktura tablicy miast.
@@ -21,99 +31,135 @@ typedef struct CitiesArray {
   unsigned distance; ///< Odległość miasta od startu.
   int oldestRoad; ///< Data remontu najstarszego aktualnie odcinka drogi.
   bool checked; ///< Informacja, czy dane miasto zostało sprawdzone.
+  ///Informacja, czy najlepsza droga do miasta jest wyznaczona jednoznacznie.
+  bool explicit;
+  ///Informacja, czy cała najlepsza droga od startu jest wyznaczona jednoznacznie.
+  bool unique;
   unsigned previousCity; ///< Poprzednie maisto w ścieżce wyznaczonej od startu.
+  unsigned source; ///< Numer miasta początkowego, od którego prowadzi droga.
+  ///Inne miasto początkowe, od którego prowadzi droga tej samej długości.
+  unsigned rivalSource;
+  int rivalOldest; ///< Data remontu najstarszego odcinka takiej drogi.
   Road *connection; ///< Wskaźnik na odcinek drogi łączący miasto z poprzednim.
+  unsigned search; ///< Numer wyszukiwania, w którym komórka była wypełniona.
 } CitiesArray;
 
 /**
- * Tablica, do której zostaną wpisane miasta pod odpowiednimi indeksami.
+ * Struktura przechowująca stan wyszukiwania. Pamięć jest zachowywana pomiędzy
+ * kolejnymi wyszukiwaniami.
  */
-static CitiesArray *citiesArray = NULL;
-
-/**@brief Tworzy tablicę miast.
- * Alokuje potrzebną pamięć i przepisuje miasta z hashmapy do tablicy dodając
- * pola zawierające potrzebne informacje: odległość od startu, data budowy
- * najstarszego odcinka drogi, informację na temat tego, czy miasto zostało już
- * sprawdzone. Umieszcza miasto początkowe pod indeksem 0 a miasto końcowe pod
- * indeksem 1.
- * @param start - wskaźnik na strukturę przechowującą miasto początkowe;
- * @param finish - wskaźnik na strukturę przechowującą miasto końcowe;
+struct SearchState {
+  ///Tablica, w której miasta znajdują się pod indeksami citiesArrayIndex.
+  CitiesArray *citiesArray;
+  unsigned citiesArraySize; ///< Rozmiar tablicy miast.
+  PriorityQueue *queue; ///< Kolejka priorytetowa.
+  ///Numer bieżącego wyszukiwania. Komórki z innym numerem są nieaktualne.
+  unsigned searchNumber;
+  ///Informacja, czy w bieżącym wyszukiwaniu pominięto miasto z powodu odległości.
+  bool distanceExceeded;
+};
+
+///Stan wyszukiwań wykonywanych przez funkcje bez jawnie podanego stanu.
+static SearchState sharedState = {NULL, 0, NULL, 0, false};
+
+SearchState *newSearchState(void) {
+  return calloc(1, sizeof(SearchState));
+}
+
+void freeSearchState(SearchState *state) {
+  if (state) {
+    free(state->citiesArray);
+    if (state->queue) {
+      freePriorityQueue(state->queue);
+    }
+    free(state);
+  }
+}
+
+///Co ile sprawdzonych miast jest sprawdzany limit czasu.
+#define DEADLINE_CHECK_PERIOD 64
+
+/**@brief Powiększa tablicę miast i kolejkę.
+ * Powiększa tablicę miast i kolejkę priorytetową, jeśli mapa urosła od
+ * poprzedniego wyszukiwania, zachowując ich zawartość. Nie alokuje pamięci,
+ * jeśli liczba miast się nie zmieniła.
+ * @param state - stan wyszukiwania;
  * @param hashMap - hashmapa zawierająca miasta.
- * @return Zwraca NULL, jeśli wystąpi błąd alokacji pamięci lub parametr jest
- * niepoprawny. W przeciwnym wypadku zwraca wypełnioną tablicę miast.
+ * @return Zwraca @p false, jeśli wystąpi błąd alokacji pamięci lub mapa jest
+ * pusta. W przeciwnym wypadku zwraca @p true.
  */
-static CitiesArray *newCitiesArray(City *start, City *finish,
-        CityHashMap *hashMap) {
-  if (numberOfCities(hashMap) == 0) {
-    return NULL;
+static bool reserveSearch(SearchState *state, CityHashMap *hashMap) {
+  unsigned number = numberOfCities(hashMap);
+  if (number == 0) {
+    return false;
   }
-
-  CityList **cities = showCities(hashMap);
-  if (!cities) {
-    return NULL;
+  if (!state->queue && !(state->queue = newPriorityQueue(number))) {
+    return false;
   }
-
-  CitiesArray *new = malloc(numberOfCities(hashMap) * sizeof(CitiesArray));
-  if (!new) {
-    return NULL;
+  if (!reservePriorityQueue(state->queue, number)) {
+    return false;
   }
-
-  unsigned counter = 2;
-  for (int i = 2; i < CITIES_NUMBER; i++) {
-    CityList *temp = cities[i];
-    while (temp) {
-      unsigned tempCounter = counter;
-      if (isEqual(temp->city, start)) {
-        counter = 0;
-      }
-      else if (isEqual(temp->city, finish)) {
-        counter = 1;
-      }
-      new[counter].city = temp->city;
-      new[counter].checked = false;
-      new[counter].distance = INFINITY;
-      new[counter].oldestRoad = INFINITY;
-      new[counter].previousCity = 0;
-      new[counter].connection = NULL;
-      temp->city->citiesArrayIndex = counter;
-      temp = temp->next;
-      if (counter == tempCounter) {
-        tempCounter++;
-      }
-      counter = tempCounter;
+  if (state->citiesArraySize < number) {
+    CitiesArray *new = realloc(state->citiesArray, number * sizeof(CitiesArray));
+    if (!new) {
+      return false;
+    }
+    for (unsigned i = state->citiesArraySize; i < number; i++) {
+      new[i].search = 0;
     }
+    state->citiesArray = new;
+    state->citiesArraySize = number;
   }
-  return new;
+  return true;
 }
 
-/**@brief Porównuje miasta.
- * Porównuje miasta znajdujące się w tablicy miast pod wskazanymi indeksami.
- * @param index1 - indeks pierwszego miasta w talicy miast;
- * @param index2 - indeks drugiego miasta w tablicy miast.
- * @return Zwraca 1, jeśli droga prowadząca do miasta pod pierwszym indeksem od
- * miasta początkowego jest dłuższa niż do drugiego miasta. W przypadku tej
- * samej odległośći bierze pod uwagę datę remontu najstarszego odcinka drogi.
- * Jeśli nie można rozstrzygnąć, która z dróg jest dłuższa, zwraca 0. W
- * przeciwnym wypadku zwraca -1.
+/**@brief Przygotowuje tablicę miast i kolejkę.
+ * Powiększa tablicę miast i kolejkę priorytetową, jeśli mapa urosła od
+ * poprzedniego wyszukiwania, a następnie unieważnia wszystkie komórki tablicy
+ * zmieniając numer wyszukiwania.
+ * @param state - stan wyszukiwania;
+ * @param hashMap - hashmapa zawierająca miasta.
+ * @return Zwraca @p false, jeśli wystąpi błąd alokacji pamięci lub mapa jest
+ * pusta. W przeciwnym wypadku zwraca @p true.
  */
-static int comparator(unsigned index1, unsigned index2) {
-  unsigned distance1 = citiesArray[index1].distance;
-  unsigned distance2 = citiesArray[index2].distance;
-  int oldestRoad1 = citiesArray[index1].oldestRoad;
-  int oldestRoad2 = citiesArray[index2].oldestRoad;
-  if (distance1 == distance2) {
-    if (oldestRoad1 == oldestRoad2) {
-      return 0;
-    }
-    if (oldestRoad1 < oldestRoad2) {
-      return 1;
+static bool prepareSearch(SearchState *state, CityHashMap *hashMap) {
+  if (!reserveSearch(state, hashMap)) {
+    return false;
+  }
+  clearPriorityQueue(state->queue);
+  state->distanceExceeded = false;
+  if (++state->searchNumber == 0) {
+    for (unsigned i = 0; i < state->citiesArraySize; i++) {
+      state->citiesArray[i].search = 0;
     }
-    return -1;
+    state->searchNumber = 1;
   }
-  if (distance1 > distance2) {
-    return 1;
+  return true;
+}
+
+/**@brief Daje dostęp do komórki tablicy miast.
+ * Jeśli komórka miasta nie była jeszcze wypełniona w bieżącym wyszukiwaniu,
+ * wypełnia ją wartościami początkowymi.
+ * @param state - stan wyszukiwania;
+ * @param city - wskaźnik na strukturę miasta.
+ * @return Zwraca wskaźnik na komórkę tablicy miast.
+ */
+static CitiesArray *crate(SearchState *state, City *city) {
+  CitiesArray *crate = &state->citiesArray[city->citiesArrayIndex];
+  if (crate->search != state->searchNumber) {
+    crate->city = city;
+    crate->checked = false;
+    crate->explicit = true;
+    crate->distance = INFINITY;
+    crate->oldestRoad = INFINITY;
+    crate->previousCity = city->citiesArrayIndex;
+    crate->connection = NULL;
+    crate->source = 0;
+    crate->rivalSource = NO_SOURCE;
+    crate->rivalOldest = INFINITY;
+    crate->search = state->searchNumber;
   }
-  return -1;
+  return crate;
 }
 
 /**
@@ -137,205 +183,454 @@ static int dijkstraMin(int x, int y) {
   return y;
 }
 
-/**
- * Porównuje 2 liczby dodatnie z uwzględnieniem stałej INFINITY.
- * @param distance1 - pierwsza liczba dodatnia;
- * @param distance2 - druga liczba dodatnia.
- * @return Zwraca 0, jeśli liczby są sobie równe. W przeciwnym wypadku, jeśli
- * pierwsza liczba jest równa INFINITY lub żadna z liczb nie jest równa INFINITY
- * a pierwsza liczba jest większa od drugiej - zwraca 1. W przeciwnym wypadku
- * zwraca -1.
+/**@brief Tworzy klucz komórki tablicy miast.
+ * Pakuje odległość i datę remontu najdawniej remontowanego odcinka drogi do
+ * jednej liczby tak, aby lepsza ścieżka (krótsza lub w przypadku równych
+ * odległości - o młodszym najstarszym odcinku) miała mniejszy klucz.
+ * @param distance - odległość od startu;
+ * @param oldestRoad - data remontu najdawniej remontowanego odcinka.
+ * @return Zwraca utworzony klucz.
  */
-static int compareDistances(unsigned distance1, unsigned distance2) {
-  if (distance1 == distance2) {
-    return 0;
-  }
-  if (distance1 == INFINITY) {
-    return 1;
-  }
-  if (distance2 == INFINITY) {
-    return -1;
-  }
-  if (distance1 > distance2) {
-    return 1;
-  }
-  return -1;
+static uint64_t crateKey(unsigned distance, int oldestRoad) {
+  return ((uint64_t) distance << 32) |
+         (uint32_t) ((int64_t) INT_MAX - oldestRoad);
 }
 
 /**
- * Porównuje 2 komórki tablicy miast, biorąc pod uwagę w pierwszej kolejności
- * odległość, a w drugiej datę remonru najdawniej remontowanego odcinka drogi.
- * @param crate1 - pierwsza komórka tablicy miast;
- * @param crate2 - druga komórka tablicy miast.
- * @return Zwraca 1, jeśli pierwsza komórka zawiera informację o gorszej ścieżce
- * (dłuższej lub w przypadku równych odległości - zawierającej najstarszy
- * odcinek). Jeśli ścieżki są tak samo dobre, zwraca 0. W przeciwnym wypadku
- * zwraca -1.
+ * Podaje klucz komórki tablicy miast z uwzględnieniem stałej INFINITY.
+ * @param crate - wskaźnik na komórkę tablicy miast.
+ * @return Zwraca UINT64_MAX, jeśli miasto nie zostało jeszcze osiągnięte.
+ * W przeciwnym wypadku zwraca klucz komórki.
  */
-static int compareCrates(CitiesArray crate1, CitiesArray crate2) {
-  if (compareDistances(crate1.distance, crate2.distance) == 1) {
-    return 1;
-  }
-  if (compareDistances(crate1.distance, crate2.distance) == -1) {
-    return -1;
-  }
-  if (crate1.oldestRoad < crate2.oldestRoad) {
-    return 1;
-  }
-  if (crate1.oldestRoad > crate2.oldestRoad) {
-    return -1;
+static uint64_t currentKey(CitiesArray *crate) {
+  if (crate->distance == INFINITY) {
+    return UINT64_MAX;
   }
-  return 0;
+  return crateKey(crate->distance, crate->oldestRoad);
 }
 
 /**
- * Tworzy nową komórkę tablicy miast o podanym dystancie i najstarszym odcinku.
- * @param distance - odległość od startu;
- * @param oldestRoad - data remontu najdawniej remontowanego odcinka.
- * @return Zwraca utworzoną komórkę.
+ * Uwzględnia drogę do miasta tej samej długości co najlepsza, prowadzącą od
+ * innego miasta początkowego niż najlepsza droga.
+ * @param crate - wskaźnik na komórkę tablicy miast;
+ * @param source - numer miasta początkowego drogi lub NO_SOURCE;
+ * @param oldestRoad - data remontu najstarszego odcinka drogi.
  */
-static CitiesArray newCrate (unsigned distance, int oldestRoad) {
-  CitiesArray new;
-  new.oldestRoad = oldestRoad;
-  new.distance = distance;
-  return new;
+static void offerRival(CitiesArray *crate, unsigned source, int oldestRoad) {
+  if (source != NO_SOURCE && source != crate->source &&
+      (crate->rivalSource == NO_SOURCE || oldestRoad > crate->rivalOldest)) {
+    crate->rivalSource = source;
+    crate->rivalOldest = oldestRoad;
+  }
 }
 
 #define TRUE 1 ///< Stała, oznaczająca że algorytm ma zakończyć działanie.
 #define FALSE 0 ///< Stała, oznaczająca że algorytm ma nie kończyć działania.
-#define ERROR -1 ///< Stała, oznaczająca że wystąpił błąd alokacji pamięci.
+#define EXHAUSTED -1 ///< Stała, oznaczająca że kolejka została wyczerpana.
+#define ERROR -2 ///< Stała, oznaczająca że wystąpił błąd alokacji pamięci.
 
 /**@brief Kolejny krok algorytmu Dijkstry.
  * Funkcja usuwa z kolejki priorytetowej jej pierwszy element. Następnie dla
  * każdego miasta połączonego z miastem o usuniętym indeksie dodaje je do
- * kolejki, jeśli nie zostało wcześniej sprawdzone i jeśli nie przechodzi przez
- * nie wyznaczana droga krajowa.
- * @param queue - wskaźnik na strukturę kolejki priorytetowej;
- * @param forbiddenId - numer wyznaczanej drogi krajowej;
- * @param explicit - zmienna logiczna przyjmująca wartość @p true, jeśli droga
- * krajowa jest wyznaczona jednoznacznie, a @p false, jeśli nie jest.
- * @param forbiddenRoad  - numer wyznaczanej drogi krajowej.
- * @return Zwraca TRUE, jeśli została znaleziona droga krajowa; FALSE, jeśli
- * algorym ma kontynuować szukanie lub ERROR, jeśli wystąpił błąd alokacji
- * pamięci.
+ * kolejki, jeśli nie zostało wcześniej sprawdzone. Jeśli do miasta prowadzą
+ * dwie równie dobre drogi, zaznacza, że droga do niego nie jest wyznaczona
+ * jednoznacznie.
+ * @param state - stan wyszukiwania;
+ * @param finish - indeks miasta końcowego lub UINT_MAX, jeśli go nie ma;
+ * @param forbiddenRoad  - odcinek drogi, który nie może zostać użyty;
+ * @param maxDistance - największa dopuszczalna odległość od startu lub
+ * INFINITY;
+ * @param result - struktura, do której są zapisywane sprawdzone miasta lub
+ * NULL.
+ * @return Zwraca TRUE, jeśli zostało sprawdzone miasto końcowe; FALSE, jeśli
+ * algorym ma kontynuować szukanie lub EXHAUSTED, jeśli kolejka jest pusta.
  */
-static int checkCity(PriorityQueue *queue, unsigned forbiddenId, bool *explicit,
-        Road *forbiddenRoad) {
-  if (isEmpty(queue)) {
-    return ERROR;
+static int checkCity(SearchState *state, unsigned finish,
+        Road *forbiddenRoad, unsigned maxDistance, ReachableCities *result) {
+  if (isEmpty(state->queue)) {
+    return EXHAUSTED;
   }
-  int top = pop(queue);
-  if (top == 1) {
+  int top = pop(state->queue);
+  CitiesArray *current = &state->citiesArray[top];
+  current->checked = true;
+  current->unique = current->explicit &&
+          (!current->connection ||
+           state->citiesArray[current->previousCity].unique);
+  if (result) {
+    ReachedCity *reached = &(result->cities[(result->number)++]);
+    reached->city = current->city;
+    reached->distance = current->distance;
+    reached->oldestRoad = current->oldestRoad;
+    reached->connection = current->connection;
+    reached->previous = current->connection ?
+            state->citiesArray[current->previousCity].city : NULL;
+  }
+  if ((unsigned) top == finish) {
     return TRUE;
   }
-  City *city = citiesArray[top].city;
-  for (int i = 0; i < ROADS_NUMBER; i++) {
-    RoadList *temp = showElement(i, city->roads);
-    while (temp) {
-      Road *road = temp->road;
-      if (road != forbiddenRoad) {
-        unsigned index;
-        if (!isEqual(city, road->city1)) {
-          index = road->city1->citiesArrayIndex;
-        }
-        else {
-          index = road->city2->citiesArrayIndex;
-        }
-        if (!(citiesArray[index].city->routesPassing[forbiddenId]) &&
-           !(citiesArray[index].checked)) {
-          unsigned newDistance = citiesArray[top].distance + road->length;
-          int newOldest = dijkstraMin(citiesArray[top].oldestRoad,
-                  road->lastRepair);
-          int compare = compareCrates(newCrate(newDistance, newOldest),
-                  citiesArray[index]);
-          if (compare < 1) {
-            if (index == 1) {
-              if (compare == 0) {
-                *explicit = false;
-              }
-              else {
-                *explicit = true;
-              }
-            }
-            deleteIndex((int) index, queue);
-            citiesArray[index].connection = road;
-            citiesArray[index].previousCity = city->citiesArrayIndex;
-            (citiesArray[index].distance) = newDistance;
-            citiesArray[index].oldestRoad = newOldest;
-            if (!insert(index, queue, comparator)) {
-              return ERROR;
-            }
-          }
-        }
+  City *city = current->city;
+  for (unsigned i = 0; i < city->degree; i++) {
+    Road *road = city->adjacent[i];
+    if (road == forbiddenRoad) {
+      continue;
+    }
+    City *neighbour = isEqual(city, road->city1) ? road->city2 : road->city1;
+    CitiesArray *next = crate(state, neighbour);
+    if (next->checked) {
+      continue;
+    }
+    uint64_t newDistance = (uint64_t) current->distance + road->length;
+    if (newDistance > UINT_MAX) {
+      continue;
+    }
+    if (maxDistance != INFINITY && newDistance > maxDistance) {
+      state->distanceExceeded = true;
+      continue;
+    }
+    int newOldest = dijkstraMin(current->oldestRoad, road->lastRepair);
+    int rivalOldest = dijkstraMin(current->rivalOldest, road->lastRepair);
+    uint64_t newKey = crateKey((unsigned) newDistance, newOldest);
+    uint64_t oldKey = currentKey(next);
+    if (newKey <= oldKey) {
+      bool sameDistance = next->distance == newDistance;
+      unsigned oldSource = next->source;
+      unsigned oldRival = next->rivalSource;
+      int oldRivalOldest = next->rivalOldest;
+      next->explicit = (newKey < oldKey);
+      next->source = current->source;
+      next->rivalSource = NO_SOURCE;
+      offerRival(next, current->rivalSource, rivalOldest);
+      if (sameDistance) {
+        offerRival(next, oldSource, next->oldestRoad);
+        offerRival(next, oldRival, oldRivalOldest);
       }
-      temp = temp->next;
+      next->connection = road;
+      next->previousCity = (unsigned) top;
+      next->distance = (unsigned) newDistance;
+      next->oldestRoad = newOldest;
+      insert(neighbour->citiesArrayIndex, newKey, state->queue);
+    }
+    else if (next->distance == newDistance) {
+      offerRival(next, current->source, newOldest);
+      offerRival(next, current->rivalSource, rivalOldest);
     }
   }
-  citiesArray[top].checked = true;
   return FALSE;
 }
 
-/**@brief Usuwa strukturę.
- * Usuwa tablicę miast zwalniając zaalokowaną na nią pamięć.
- * @param array - tablica miast.
+///Podaje bieżący czas w mikrosekundach.
+static uint64_t currentTime() {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (uint64_t) time.tv_sec * 1000000 + (uint64_t) time.tv_nsec / 1000;
+}
+
+#define LIMITED -3 ///< Stała, oznaczająca że zostało przekroczone ograniczenie.
+
+/**@brief Przeprowadza wyszukiwanie.
+ * Przygotowuje tablicę miast i kolejkę, a następnie wykonuje kolejne kroki
+ * algorytmu Dijkstry z miast początkowych, dopóki nie zostanie osiągnięte
+ * miasto końcowe, kolejka nie zostanie wyczerpana lub nie zostanie przekroczone
+ * któreś z ograniczeń. Miasta początkowe są od razu oznaczane jako
+ * sprawdzone, żeby żadne z nich nie zostało osiągnięte z innego. Tak samo są
+ * oznaczane miasta zabronionej drogi krajowej, z wyjątkiem miasta końcowego,
+ * więc lista jej odcinków jest przeglądana raz na wyszukiwanie.
+ * @param state - stan wyszukiwania;
+ * @param starts - tablica miast początkowych;
+ * @param startsNumber - liczba miast początkowych;
+ * @param finish - miasto końcowe lub NULL;
+ * @param hashMap - hashmapa miast;
+ * @param forbiddenRoute - droga krajowa, której miasta są zabronione, lub NULL;
+ * @param forbiddenRoad - odcinek drogi, który nie może zostać użyty;
+ * @param limits - ograniczenia wyszukiwania lub NULL;
+ * @param result - struktura, do której są zapisywane sprawdzone miasta lub
+ * NULL.
+ * @return Zwraca TRUE, jeśli miasto końcowe zostało osiągnięte; FALSE, jeśli
+ * kolejka została wyczerpana; LIMITED, jeśli przekroczono liczbę sprawdzonych
+ * miast lub czas albo kolejka została wyczerpana po pominięciu miast zbyt
+ * odległych od startu lub ERROR, jeśli wystąpił błąd alokacji pamięci.
  */
-static void freeCitiesArray(CitiesArray *array) {
-  if (array) {
-    free(array);
+static int runSearch(SearchState *state, City **starts,
+        unsigned startsNumber, City *finish, CityHashMap *hashMap,
+        const Route *forbiddenRoute, Road *forbiddenRoad,
+        const SearchLimits *limits, ReachableCities *result) {
+  for (unsigned i = 0; i < startsNumber; i++) {
+    if (!starts[i]) {
+      return ERROR;
+    }
+  }
+  if (startsNumber == 0 || !prepareSearch(state, hashMap)) {
+    return ERROR;
+  }
+  SearchLimits noLimits = {INFINITY, INFINITY, INFINITY};
+  if (!limits) {
+    limits = &noLimits;
+  }
+  uint64_t deadline = 0;
+  if (limits->timeLimit != INFINITY) {
+    deadline = currentTime() + limits->timeLimit;
+  }
+  for (unsigned i = 0; i < startsNumber; i++) {
+    CitiesArray *start = crate(state, starts[i]);
+    if (!start->checked) {
+      start->checked = true;
+      start->source = i;
+      insert(starts[i]->citiesArrayIndex, 0, state->queue);
+    }
+  }
+  if (forbiddenRoute) {
+    for (RoadList *temp = forbiddenRoute->roads; temp; temp = temp->next) {
+      if (!isEqual(temp->road->city1, finish)) {
+        crate(state, temp->road->city1)->checked = true;
+      }
+      if (!isEqual(temp->road->city2, finish)) {
+        crate(state, temp->road->city2)->checked = true;
+      }
+    }
+  }
+  unsigned finishIndex = finish ? finish->citiesArrayIndex : UINT_MAX;
+  unsigned checked = 0;
+  int end = FALSE;
+  while (end == FALSE) {
+    end = checkCity(state, finishIndex, forbiddenRoad, limits->maxDistance,
+            result);
+    checked++;
+    if (end == FALSE && limits->maxChecked != INFINITY &&
+        checked >= limits->maxChecked) {
+      return LIMITED;
+    }
+    if (end == FALSE && deadline != 0 &&
+        checked % DEADLINE_CHECK_PERIOD == 0 && currentTime() >= deadline) {
+      return LIMITED;
+    }
+  }
+  if (end == TRUE) {
+    return TRUE;
   }
+  return state->distanceExceeded ? LIMITED : FALSE;
 }
 
 /**
- * Korzystając z globalnej tablicy miast oddtwarza listę odcinków dróg, z
- * z których składa się wyznaczona droga krajowa.
+ * Korzystając z tablicy miast oddtwarza listę odcinków dróg, z
+ * z których składa się wyznaczona droga krajowa, od miasta początkowego.
+ * @param state - stan wyszukiwania;
+ * @param finish - indeks miasta końcowego.
  * @return Zwraca utworzoną listę odcinków dróg lub NULL, jeśli wystąpi błąd
  * alokacji pamięci.
  */
-static RoadList *recoverRoadList() {
+static RoadList *recoverRoadList(SearchState *state, unsigned finish) {
   RoadList *list = NULL;
-  unsigned start = 1;
-  while (start != 0) {
-    if (!(addToRoadList(citiesArray[start].connection, &list))) {
+  while (state->citiesArray[finish].connection) {
+    if (!(addToRoadList(state->citiesArray[finish].connection, &list))) {
       freeRoadList(list);
       return NULL;
     }
-    start = citiesArray[start].previousCity;
+    finish = state->citiesArray[finish].previousCity;
   }
   return list;
 }
 
-RoadList *findBestRoute(City *start, City *finish, CityHashMap *hashMap,
-                        unsigned forbiddenId, Road *forbiddenRoad) {
-  RoadList *roadList = NULL;
-  PriorityQueue *queue = newPriorityQueue(numberOfCities(hashMap));
-  if (!queue) {
+RoadList *findBestRouteFromAny(SearchState *state, City **starts,
+        unsigned startsNumber, City *finish, CityHashMap *hashMap,
+        const Route *forbiddenRoute, Road *forbiddenRoad,
+        const SearchLimits *limits, int *status) {
+  int dummy;
+  if (!status) {
+    status = &dummy;
+  }
+  *status = SEARCH_ERROR;
+  if (!state) {
+    state = &sharedState;
+  }
+  if (!finish) {
     return NULL;
   }
-
-  citiesArray = newCitiesArray(start, finish, hashMap);
-  if (!citiesArray) {
-    freePriorityQueue(queue);
+  for (unsigned i = 0; i < startsNumber; i++) {
+    if (!starts[i] || isEqual(starts[i], finish)) {
+      return NULL;
+    }
+  }
+  int end = runSearch(state, starts, startsNumber, finish, hashMap,
+          forbiddenRoute, forbiddenRoad, limits, NULL);
+  if (end != TRUE) {
+    if (end == FALSE) {
+      *status = ROUTE_NOT_FOUND;
+    }
+    else if (end == LIMITED) {
+      *status = BUDGET_EXCEEDED;
+    }
     return NULL;
   }
+  CitiesArray *reached = &state->citiesArray[finish->citiesArrayIndex];
+  if (!reached->explicit || (reached->rivalSource != NO_SOURCE &&
+                             reached->rivalOldest == reached->oldestRoad)) {
+    *status = ROUTE_AMBIGUOUS;
+    return NULL;
+  }
+  RoadList *roadList = recoverRoadList(state, finish->citiesArrayIndex);
+  if (roadList) {
+    *status = ROUTE_FOUND;
+  }
+  return roadList;
+}
+
+RoadList *findBestRouteWith(SearchState *state, City *start, City *finish,
+        CityHashMap *hashMap, const Route *forbiddenRoute, Road *forbiddenRoad,
+        const SearchLimits *limits, int *status) {
+  return findBestRouteFromAny(state, &start, 1, finish, hashMap,
+          forbiddenRoute, forbiddenRoad, limits, status);
+}
+
+RoadList *findBestRouteLimited(City *start, City *finish,
+        CityHashMap *hashMap, const Route *forbiddenRoute, Road *forbiddenRoad,
+        const SearchLimits *limits, int *status) {
+  return findBestRouteWith(&sharedState, start, finish, hashMap,
+          forbiddenRoute, forbiddenRoad, limits, status);
+}
+
+RoadList *findBestRoute(City *start, City *finish, CityHashMap *hashMap,
+                        const Route *forbiddenRoute, Road *forbiddenRoad) {
+  return findBestRouteLimited(start, finish, hashMap, forbiddenRoute,
+          forbiddenRoad, NULL, NULL);
+}
+
+/**
+ * Sprawdza, czy wyznaczona w tablicy miast droga omija miasta, przez które
+ * przechodzi podana droga krajowa. Miasto początkowe i końcowe nie są
+ * sprawdzane.
+ * @param state - stan wyszukiwania;
+ * @param start - indeks miasta początkowego;
+ * @param finish - indeks miasta końcowego;
+ * @param routeId - numer drogi krajowej.
+ * @return Zwraca @p true, jeśli żadne miasto pośrednie na drodze nie należy do
+ * drogi krajowej. W przeciwnym razie zwraca @p false.
+ */
+static bool pathAvoids(SearchState *state, unsigned start, unsigned finish,
+                       unsigned routeId) {
+  unsigned city = state->citiesArray[finish].previousCity;
+  while (city != start) {
+    if (state->citiesArray[city].city->routesPassing[routeId]) {
+      return false;
+    }
+    city = state->citiesArray[city].previousCity;
+  }
+  return true;
+}
 
-  insert(0, queue, comparator);
-  bool explicit = true;
-  int end = FALSE;
-  while (end != TRUE) {
-    end = checkCity(queue, forbiddenId, &explicit, forbiddenRoad);
-    if (end == ERROR) {
-      freePriorityQueue(queue);
-      freeCitiesArray(citiesArray);
+bool startSearch(SearchState *state, City *start, CityHashMap *hashMap) {
+  if (!state || !start || !prepareSearch(state, hashMap)) {
+    return false;
+  }
+  crate(state, start)->checked = true;
+  return insert(start->citiesArrayIndex, 0, state->queue);
+}
+
+bool isSettled(SearchState *state, City *city) {
+  if (!state || !city || city->citiesArrayIndex >= state->citiesArraySize) {
+    return false;
+  }
+  CitiesArray *crate = &state->citiesArray[city->citiesArrayIndex];
+  return crate->search == state->searchNumber && crate->checked;
+}
+
+RoadList *resumeSearch(SearchState *state, City *finish, CityHashMap *hashMap,
+                       int *status) {
+  *status = SEARCH_ERROR;
+  if (!state || !finish || !reserveSearch(state, hashMap)) {
+    return NULL;
+  }
+  while (!isSettled(state, finish)) {
+    if (checkCity(state, UINT_MAX, NULL, INFINITY, NULL) == EXHAUSTED) {
+      *status = ROUTE_NOT_FOUND;
       return NULL;
     }
   }
-  if (!explicit) {
-    freePriorityQueue(queue);
-    freeCitiesArray(citiesArray);
+  CitiesArray *reached = &state->citiesArray[finish->citiesArrayIndex];
+  if (!reached->connection) {
+    return NULL;
+  }
+  if (!reached->explicit) {
+    *status = ROUTE_AMBIGUOUS;
     return NULL;
   }
-  roadList = recoverRoadList();
-  freePriorityQueue(queue);
-  freeCitiesArray(citiesArray);
+  RoadList *roadList = recoverRoadList(state, finish->citiesArrayIndex);
+  if (roadList) {
+    *status = ROUTE_FOUND;
+  }
   return roadList;
-}
\ No newline at end of file
+}
+
+bool findBestRoutes(SearchState *state, City *start, City *finish,
+        CityHashMap *hashMap, Road *forbiddenRoad, Route **routes,
+        unsigned number, RoadList **result, bool *pending) {
+  for (unsigned i = 0; i < number; i++) {
+    result[i] = NULL;
+    pending[i] = false;
+  }
+  if (number == 0) {
+    return true;
+  }
+  if (!state) {
+    state = &sharedState;
+  }
+  int end = runSearch(state, &start, 1, finish, hashMap, NULL, forbiddenRoad,
+          NULL, NULL);
+  if (end == ERROR) {
+    return false;
+  }
+  if (end != TRUE) {
+    return true;
+  }
+  unsigned startIndex = start->citiesArrayIndex;
+  unsigned finishIndex = finish->citiesArrayIndex;
+  if (state->citiesArray[finishIndex].unique) {
+    for (unsigned i = 0; i < number; i++) {
+      if (pathAvoids(state, startIndex, finishIndex, routes[i]->rotueID) &&
+          !(result[i] = recoverRoadList(state, finishIndex))) {
+        return false;
+      }
+    }
+  }
+  for (unsigned i = 0; i < number; i++) {
+    pending[i] = !result[i];
+  }
+  return true;
+}
+
+bool findNearestCity(SearchState *state, City **starts, unsigned startsNumber,
+        City *finish, CityHashMap *hashMap, ReachedCity *result) {
+  if (!finish || !result) {
+    return false;
+  }
+  if (!state) {
+    state = &sharedState;
+  }
+  int end = runSearch(state, starts, startsNumber, finish, hashMap, NULL, NULL,
+          NULL, NULL);
+  if (end == ERROR) {
+    return false;
+  }
+  result->city = NULL;
+  result->distance = 0;
+  result->oldestRoad = 0;
+  result->previous = NULL;
+  result->connection = NULL;
+  if (end == TRUE) {
+    CitiesArray *reached = &state->citiesArray[finish->citiesArrayIndex];
+    result->city = starts[reached->source];
+    result->distance = reached->distance;
+    result->oldestRoad = reached->oldestRoad;
+  }
+  return true;
+}
+
+bool findReachableCities(City *start, CityHashMap *hashMap,
+        unsigned maxDistance, ReachableCities *result) {
+  if (!start || !result ||
+      !reserveReachableCities(result, numberOfCities(hashMap))) {
+    return false;
+  }
+  SearchLimits limits = {maxDistance, INFINITY, INFINITY};
+  return runSearch(&sharedState, &start, 1, NULL, hashMap, NULL, NULL, &limits,
+                   result) != ERROR;
+}
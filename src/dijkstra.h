@@ -12,14 +12,56 @@
 #include "structures.h"
 #include "city_hashmap.h"
 
+#define ROUTE_FOUND 0 ///< Wynik wyszukiwania: droga została wyznaczona.
+#define ROUTE_NOT_FOUND 1 ///< Wynik wyszukiwania: droga nie istnieje.
+#define ROUTE_AMBIGUOUS 2 ///< Wynik wyszukiwania: droga nie jest jednoznaczna.
+#define BUDGET_EXCEEDED 3 ///< Wynik wyszukiwania: przekroczono ograniczenie.
+#define SEARCH_ERROR 4 ///< Wynik wyszukiwania: błąd parametrów lub alokacji.
+
+/**
+ * Struktura przechowująca ograniczenia wyszukiwania drogi. Wartość 0 w polu
+ * oznacza brak danego ograniczenia.
+ */
+typedef struct SearchLimits {
+  unsigned maxDistance; ///< Największa odległość od startu.
+  unsigned maxChecked; ///< Największa liczba sprawdzonych miast.
+  unsigned long timeLimit; ///< Czas na wyszukiwanie w mikrosekundach.
+} SearchLimits;
+
+/**
+ * Struktura przechowująca stan wyszukiwania: tablicę miast i kolejkę
+ * priorytetową, zachowywane pomiędzy kolejnymi wyszukiwaniami. Funkcje bez
+ * jawnie podanego stanu korzystają ze wspólnego stanu, więc nie mogą być
+ * wywoływane z kilku wątków naraz; wyszukiwania na różnych strukturach stanu
+ * mogą przebiegać równolegle, o ile mapa nie jest w tym czasie zmieniana.
+ */
+typedef struct SearchState SearchState;
+
+/**@brief Tworzy nowy stan wyszukiwania.
+ * Pamięć na tablicę miast i kolejkę jest alokowana przy pierwszym
+ * wyszukiwaniu.
+ * @return Zwraca wskaźnik na utworzoną strukturę lub NULL, jeśli nie udało się
+ * zaalokować pamięci.
+ */
+SearchState *newSearchState(void);
+
+/**@brief Usuwa stan wyszukiwania.
+ * Zwalnia całą pamięć zaalokowaną przez strukturę.
+ * @param state - wskaźnik na usuwaną strukturę.
+ */
+void freeSearchState(SearchState *state);
+
 /**@brief Szuka najlepszej drogi.
  * Dla podanych w paramertach miast szuka najlepszej możliwej drogi krajowej bez
  * samoprzecięć i pętli.
+ * Miasta, przez które przechodzi droga krajowa @p forbiddenRoute, są
+ * pomijane, z wyjątkiem miasta końcowego. Są one oznaczane jako sprawdzone
+ * przed rozpoczęciem wyszukiwania na podstawie listy odcinków drogi krajowej.
  * @param city1 - początek wyznaczanej drogi;
  * @param city2 - koniec drogi;
  * @param hashMap - hashmapa miast, między którymi poprowadzone są odcinki dróg;
- * @param forbiddenId - numer drogi krajowej, której odcinki nie mogą być
- * wykorzystane;
+ * @param forbiddenRoute - wskaźnik na drogę krajową, przez której miasta nie
+ * może przechodzić szukana droga, lub NULL;
  * @param forbiddenRoad - wskaźnik na odcinek drogi, który nie może należeć do
  * szukanej drogi krajowej.
  * @return Zwraca NULL, jeśli wystąpi błąd alokacji pamięci, któryś z
@@ -28,6 +70,188 @@
  * wyznaczoną drogę krajową.
  */
 RoadList *findBestRoute(City *city1, City *city2, CityHashMap *hashMap,
-        unsigned forbiddenId, Road *forbiddenRoad);
+        const Route *forbiddenRoute, Road *forbiddenRoad);
+
+/**@brief Szuka najlepszej drogi z ograniczeniami.
+ * Działa tak jak findBestRoute(), ale przerywa wyszukiwanie, jeśli zostanie
+ * przekroczone któreś z podanych ograniczeń. Miasta dalsze od startu niż
+ * dopuszczalna odległość są pomijane; jeśli przez to nie udało się osiągnąć
+ * miasta końcowego, wynikiem jest BUDGET_EXCEEDED, a nie ROUTE_NOT_FOUND.
+ * Limit czasu jest sprawdzany co kilkadziesiąt sprawdzonych miast.
+ * @param city1 - początek wyznaczanej drogi;
+ * @param city2 - koniec drogi;
+ * @param hashMap - hashmapa miast, między którymi poprowadzone są odcinki dróg;
+ * @param forbiddenRoute - wskaźnik na drogę krajową, przez której miasta nie
+ * może przechodzić szukana droga, lub NULL;
+ * @param forbiddenRoad - wskaźnik na odcinek drogi, który nie może należeć do
+ * szukanej drogi krajowej;
+ * @param limits - wskaźnik na ograniczenia wyszukiwania lub NULL, jeśli
+ * wyszukiwanie nie jest ograniczone;
+ * @param status - wskaźnik, pod który zostanie zapisany wynik wyszukiwania
+ * (jedna ze stałych ROUTE_FOUND, ROUTE_NOT_FOUND, ROUTE_AMBIGUOUS,
+ * BUDGET_EXCEEDED, SEARCH_ERROR) lub NULL.
+ * @return Zwraca listę odcinków dróg tworzących wyznaczoną drogę krajową lub
+ * NULL, jeśli jej nie wyznaczono.
+ */
+RoadList *findBestRouteLimited(City *city1, City *city2, CityHashMap *hashMap,
+        const Route *forbiddenRoute, Road *forbiddenRoad,
+        const SearchLimits *limits, int *status);
+
+/**@brief Szuka najlepszej drogi z ograniczeniami na podanym stanie.
+ * Działa tak jak findBestRouteLimited(), ale korzysta z podanego stanu
+ * wyszukiwania zamiast wspólnego.
+ * @param state - wskaźnik na stan wyszukiwania lub NULL dla wspólnego stanu;
+ * @param city1 - początek wyznaczanej drogi;
+ * @param city2 - koniec drogi;
+ * @param hashMap - hashmapa miast, między którymi poprowadzone są odcinki dróg;
+ * @param forbiddenRoute - wskaźnik na drogę krajową, przez której miasta nie
+ * może przechodzić szukana droga, lub NULL;
+ * @param forbiddenRoad - wskaźnik na odcinek drogi, który nie może należeć do
+ * szukanej drogi krajowej;
+ * @param limits - wskaźnik na ograniczenia wyszukiwania lub NULL;
+ * @param status - wskaźnik, pod który zostanie zapisany wynik wyszukiwania
+ * lub NULL.
+ * @return Zwraca listę odcinków dróg tworzących wyznaczoną drogę krajową lub
+ * NULL, jeśli jej nie wyznaczono.
+ */
+RoadList *findBestRouteWith(SearchState *state, City *city1, City *city2,
+        CityHashMap *hashMap, const Route *forbiddenRoute, Road *forbiddenRoad,
+        const SearchLimits *limits, int *status);
+
+/**@brief Szuka najlepszej drogi z dowolnego z kilku miast.
+ * Przeprowadza jedno wyszukiwanie rozpoczęte jednocześnie we wszystkich
+ * miastach początkowych i wyznacza najlepszą drogę z któregokolwiek z nich.
+ * Droga jest niejednoznaczna tak jak w findBestRouteLimited(), a także wtedy,
+ * gdy najlepsze drogi od dwóch różnych miast początkowych są równie dobre,
+ * tak jakby dla każdego z nich przeprowadzono osobne wyszukiwanie.
+ * Wyznaczona droga nie przechodzi przez pozostałe miasta początkowe.
+ * @param state - wskaźnik na stan wyszukiwania lub NULL dla wspólnego stanu;
+ * @param starts - tablica miast początkowych;
+ * @param startsNumber - liczba miast początkowych;
+ * @param finish - koniec drogi;
+ * @param hashMap - hashmapa miast, między którymi poprowadzone są odcinki dróg;
+ * @param forbiddenRoute - wskaźnik na drogę krajową, przez której miasta nie
+ * może przechodzić szukana droga, lub NULL;
+ * @param forbiddenRoad - wskaźnik na odcinek drogi, który nie może należeć do
+ * szukanej drogi krajowej;
+ * @param limits - wskaźnik na ograniczenia wyszukiwania lub NULL;
+ * @param status - wskaźnik, pod który zostanie zapisany wynik wyszukiwania
+ * lub NULL.
+ * @return Zwraca listę odcinków dróg od jednego z miast początkowych do miasta
+ * końcowego lub NULL, jeśli drogi nie wyznaczono.
+ */
+RoadList *findBestRouteFromAny(SearchState *state, City **starts,
+        unsigned startsNumber, City *finish, CityHashMap *hashMap,
+        const Route *forbiddenRoute, Road *forbiddenRoad,
+        const SearchLimits *limits, int *status);
+
+/**@brief Szuka najlepszych dróg dla kilku dróg krajowych naraz.
+ * Przeprowadza jedno wspólne wyszukiwanie, w którym zabroniony jest tylko
+ * podany odcinek drogi. Jeśli najlepsza droga jest w nim wyznaczona
+ * jednoznacznie, a poza swoimi końcami nie przechodzi przez miasta drogi
+ * krajowej, to jest wynikiem
+ * findBestRoute() z tą drogą krajową. Dla pozostałych dróg
+ * krajowych zaznacza, że potrzebne jest osobne wyszukiwanie, chyba że
+ * drogi nie ma nawet we wspólnym wyszukiwaniu. Osobne wyszukiwania są od
+ * siebie niezależne i mogą być przeprowadzane równolegle.
+ * @param state - wskaźnik na stan wyszukiwania lub NULL dla wspólnego stanu;
+ * @param city1 - początek wyznaczanej drogi;
+ * @param city2 - koniec drogi;
+ * @param hashMap - hashmapa miast, między którymi poprowadzone są odcinki dróg;
+ * @param forbiddenRoad - wskaźnik na odcinek drogi, który nie może należeć do
+ * szukanych dróg;
+ * @param routes - tablica dróg krajowych, których odcinki nie mogą być
+ * wykorzystane w odpowiadających im wynikach;
+ * @param number - liczba dróg krajowych w tablicy;
+ * @param result - tablica, do której zostaną zapisane listy odcinków dróg lub
+ * NULL dla dróg krajowych, których nie wyznaczono;
+ * @param pending - tablica, w której zostaną zaznaczone drogi krajowe
+ * wymagające osobnego wyszukiwania.
+ * @return Zwraca @p false, jeśli wystąpił błąd alokacji pamięci. Wtedy
+ * w tablicy wyników mogą się znajdować już wyznaczone listy, które należy
+ * zwolnić. W przeciwnym razie zwraca @p true.
+ */
+bool findBestRoutes(SearchState *state, City *city1, City *city2,
+        CityHashMap *hashMap, Road *forbiddenRoad, Route **routes,
+        unsigned number, RoadList **result, bool *pending);
+
+/**@brief Rozpoczyna wyszukiwanie, które można wznawiać.
+ * Przygotowuje stan wyszukiwania z podanego miasta bez miasta końcowego.
+ * Kolejne wywołania resumeSearch() kontynuują to samo wyszukiwanie.
+ * @param state - wskaźnik na stan wyszukiwania;
+ * @param start - miasto początkowe;
+ * @param hashMap - hashmapa miast, między którymi poprowadzone są odcinki dróg.
+ * @return Zwraca @p false, jeśli wystąpił błąd alokacji pamięci lub któryś
+ * z parametrów jest niepoprawny. W przeciwnym razie zwraca @p true.
+ */
+bool startSearch(SearchState *state, City *start, CityHashMap *hashMap);
+
+/**@brief Wznawia wyszukiwanie do podanego miasta.
+ * Kontynuuje wyszukiwanie rozpoczęte przez startSearch(), dopóki miasto
+ * końcowe nie zostanie sprawdzone, i zatrzymuje je w tym miejscu. Jeśli
+ * miasto zostało sprawdzone wcześniej, nie przeszukuje mapy. Kolejność
+ * sprawdzania miast jest taka sama jak w jednym wyszukiwaniu, więc wynik jest
+ * taki sam jak wynik findBestRoute() bez zabronionej drogi krajowej, o ile mapa
+ * nie zmieniła się w miejscach, które wyszukiwanie już sprawdziło
+ * (zob. isSettled()).
+ * @param state - wskaźnik na stan wyszukiwania;
+ * @param finish - miasto końcowe;
+ * @param hashMap - hashmapa miast, między którymi poprowadzone są odcinki dróg;
+ * @param status - wskaźnik, pod który zostanie zapisany wynik wyszukiwania.
+ * @return Zwraca listę odcinków dróg od miasta początkowego do końcowego lub
+ * NULL, jeśli drogi nie wyznaczono.
+ */
+RoadList *resumeSearch(SearchState *state, City *finish, CityHashMap *hashMap,
+                       int *status);
+
+/**@brief Sprawdza, czy miasto zostało sprawdzone w bieżącym wyszukiwaniu.
+ * Zmiana odcinka drogi, którego żaden koniec nie został sprawdzony, nie
+ * wpływa na dotychczasowy przebieg wyszukiwania.
+ * @param state - wskaźnik na stan wyszukiwania;
+ * @param city - wskaźnik na miasto.
+ * @return Zwraca @p true, jeśli miasto zostało sprawdzone lub jest miastem
+ * początkowym. W przeciwnym razie zwraca @p false.
+ */
+bool isSettled(SearchState *state, City *city);
+
+/**@brief Wyznacza miasto początkowe najbliższe miastu końcowemu.
+ * Przeprowadza jedno wyszukiwanie z wszystkich miast początkowych naraz, bez
+ * zabronionych odcinków i miast, i kończy je po sprawdzeniu miasta końcowego.
+ * Drogi są porównywane tak samo jak w findBestRoute(). Jeśli kilka miast
+ * początkowych jest równie blisko, wybierane jest jedno z nich.
+ * @param state - wskaźnik na stan wyszukiwania lub NULL dla wspólnego stanu;
+ * @param starts - tablica miast początkowych;
+ * @param startsNumber - liczba miast początkowych;
+ * @param finish - miasto końcowe;
+ * @param hashMap - hashmapa miast, między którymi poprowadzone są odcinki dróg;
+ * @param result - wskaźnik na strukturę, do której zostanie zapisane
+ * najbliższe miasto początkowe (lub NULL, jeśli żadne nie jest połączone
+ * z miastem końcowym), odległość i data remontu najstarszego odcinka
+ * najlepszej drogi (0, jeśli miasto końcowe jest miastem początkowym). Pola
+ * @p previous i @p connection mają wartość NULL.
+ * @return Zwraca @p false, jeśli wystąpił błąd alokacji pamięci lub któryś z
+ * parametrów jest niepoprawny. W przeciwnym razie zwraca @p true.
+ */
+bool findNearestCity(SearchState *state, City **starts, unsigned startsNumber,
+        City *finish, CityHashMap *hashMap, ReachedCity *result);
+
+/**@brief Wyznacza drzewo najlepszych dróg z podanego miasta.
+ * Przeszukuje mapę tym samym algorytmem co findBestRoute(), ale bez miasta
+ * końcowego. Zapisuje do struktury wyniku każde osiągnięte miasto wraz z
+ * odległością od startu, datą remontu najstarszego odcinka na najlepszej
+ * drodze oraz poprzednim miastem na tej drodze. Miasta są zapisywane w
+ * kolejności rosnącej odległości, zaczynając od miasta początkowego (dla
+ * którego data remontu najstarszego odcinka wynosi 0). Jeśli struktura wyniku
+ * jest wystarczająco duża, funkcja nie alokuje pamięci.
+ * @param start - miasto początkowe;
+ * @param hashMap - hashmapa miast, między którymi poprowadzone są odcinki dróg;
+ * @param maxDistance - największa odległość od startu, dla której miasto
+ * zostanie zapisane lub 0, jeśli odległość nie jest ograniczona;
+ * @param result - wskaźnik na strukturę, do której zostanie zapisany wynik.
+ * @return Zwraca @p false, jeśli wystąpił błąd alokacji pamięci lub któryś z
+ * parametrów jest niepoprawny. W przeciwnym razie zwraca @p true.
+ */
+bool findReachableCities(City *start, CityHashMap *hashMap,
+        unsigned maxDistance, ReachableCities *result);
 
 #endif //DROGI_DIJKSTRA_H
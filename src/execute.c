@@ -6,6 +6,9 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include <malloc.h>
 
 #include "execute.h"
@@ -17,35 +20,114 @@
 #define YES 1 ///< Wartość oznaczająca potwierdzenie.
 #define NO 0 ///< Wartość oznaczająca zaprzeczenie.
 
-/**@brief Sprawdza, czy w tablicy napisów nie występują powtórzenia.
- * Tworzy hashmapę miast i dodaje do niej miata o nazwach reprezentowanych przez
- * napisy w tablicy napisów. Za każdym razem sprawdza, czy miasto o danej nazwie
- * nie zostało dodane wcześniej. Przed zakończeniem działana usuwa hashmapę
- * zwalniając zaalokowaną pamięć.
- * @param cities - wskaźnik na tablicę przechowującą nazwy miast;
- * @param citiesNumber - liczba napisów w tablicy nazw miast.
- * @return Zwraca wartość MEMORY jeśli przy tworzeniu hashmapy lub dodawania do
- * niej elementu wystąpił błąd alokacji pamięci. W przeciwnym wypadku zwraca
- * YES jeśli w tablicy istnieje nazwa, która się powtarza, a NO jeśli taka nazwa
- * nie istnieje.
+///Najmniejszy rozmiar tablicy nazw miast przy szukaniu powtórzeń.
+#define MIN_NAME_SLOTS 16
+///Największy rozmiar tablicy nazw miast trzymanej na stosie.
+#define LOCAL_NAME_SLOTS 256
+
+///Bufor opisu drogi krajowej, używany ponownie przez kolejne polecenia.
+static char *description = NULL;
+///Rozmiar bufora opisu drogi krajowej.
+static size_t descriptionCapacity = 0;
+
+/**@brief Wyznacza skrót nazwy miasta.
+ * @param name - wskaźnik na napis będący nazwą miasta.
+ * @return Zwraca skrót FNV-1a nazwy.
+ */
+static uint64_t nameHash(const char *name) {
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  for (; *name != '\0'; name++) {
+    hash = (hash ^ (unsigned char) *name) * 0x100000001B3ULL;
+  }
+  return hash;
+}
+
+/**@brief Wstawia nazwę miasta do tablicy z adresowaniem otwartym.
+ * @param slots - tablica wskaźników na nazwy miast;
+ * @param capacity - rozmiar tablicy, będący potęgą dwójki;
+ * @param name - wskaźnik na wstawianą nazwę miasta.
+ * @return Zwraca @p false, jeśli taka sama nazwa była już w tablicy.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool insertName(const char **slots, size_t capacity, const char *name) {
+  size_t index = (size_t) nameHash(name) & (capacity - 1);
+  while (slots[index] && strcmp(slots[index], name) != 0) {
+    index = (index + 1) & (capacity - 1);
+  }
+  if (slots[index]) {
+    return false;
+  }
+  slots[index] = name;
+  return true;
+}
+
+/**@brief Sprawdza, czy w opisie drogi krajowej nie powtarzają się miasta.
+ * Wstawia kolejne nazwy miast do tablicy z adresowaniem otwartym, w której
+ * przechowywane są tylko wskaźniki na nazwy w linii polecenia, i za każdym
+ * razem sprawdza, czy taka sama nazwa nie została wstawiona wcześniej.
+ * Tablica dla krótkich list miast jest na stosie, więc sprawdzenie zwykle nie
+ * wymaga alokowania pamięci.
+ * @param command - wskaźnik na polecenie getRoute.
+ * @return Zwraca wartość MEMORY jeśli wystąpił błąd alokacji pamięci.
+ * W przeciwnym wypadku zwraca YES jeśli w opisie istnieje nazwa, która się
+ * powtarza, a NO jeśli taka nazwa nie istnieje.
  */
-static int duplicateCities(char **cities, int citiesNumber) {
-  CityHashMap *hashMap = newCityHashMap();
-  if (!hashMap) {
+static int duplicateCities(const Command *command) {
+  size_t capacity = MIN_NAME_SLOTS;
+  while (capacity < 2 * (size_t) command->citiesNumber) {
+    capacity *= 2;
+  }
+  const char *local[LOCAL_NAME_SLOTS];
+  const char **slots = local;
+  if (capacity > LOCAL_NAME_SLOTS &&
+      !(slots = malloc(capacity * sizeof(char *)))) {
     return MEMORY;
   }
-  for (int i = 0; i < citiesNumber; i++) {
-    if (findCity(cities[i], hashMap)) {
-      freeCityHashMap(hashMap);
-      return YES;
+  memset(slots, 0, capacity * sizeof(char *));
+  int result = NO;
+  SegmentCursor cursor = routeSegments(command);
+  RouteSegment segment = {{NULL, 0, 0}, {NULL, 0, 0}, 0, 0};
+  while (result == NO && nextSegment(&cursor, &segment)) {
+    if (!insertName(slots, capacity, segment.city1.name)) {
+      result = YES;
+    }
+  }
+  if (result == NO && segment.city2.name &&
+      !insertName(slots, capacity, segment.city2.name)) {
+    result = YES;
+  }
+  if (slots != local) {
+    free(slots);
+  }
+  return result;
+}
+
+/**@brief Tworzy drogę krajową opisaną w poleceniu getRoute.
+ * Przegląda odcinki opisu dwa razy: najpierw sprawdza, czy żaden nie jest
+ * sprzeczny z mapą, a potem dodaje je kolejno do drogi krajowej.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param command - wskaźnik na polecenie getRoute.
+ * @return Zwraca wynik tak jak @ref getRoute.
+ */
+static bool importRoute(Map *map, const Command *command) {
+  RouteBuilder builder;
+  if (!startRoute(map, command->routeID, &builder)) {
+    return false;
+  }
+  RouteSegment segment;
+  SegmentCursor cursor = routeSegments(command);
+  while (nextSegment(&cursor, &segment)) {
+    if (!checkRouteSegment(map, &builder, &segment)) {
+      return false;
     }
-    if (!addCity(cities[i], hashMap)) {
-      freeCityHashMap(hashMap);
-      return MEMORY;
+  }
+  cursor = routeSegments(command);
+  while (nextSegment(&cursor, &segment)) {
+    if (!addRouteSegment(map, &builder, &segment)) {
+      return false;
     }
   }
-  freeCityHashMap(hashMap);
-  return NO;
+  return finishRoute(map, &builder);
 }
 
 bool executeCommand(Command command, Map *map, int *line) {
@@ -56,45 +138,49 @@ bool executeCommand(Command command, Map *map, int *line) {
     executeError(*line);
   }
   else if (command.commandType == ADD_ROAD){
-    if (!addRoad(map, command.city1, command.city2, command.length,
-            command.lastRepair)) {
+    if (!addRoadByKeys(map, &(command.city1), &(command.city2),
+                       command.length, command.lastRepair)) {
       executeError(*line);
     }
   }
   else if (command.commandType == REPAIR_ROAD) {
-    if (!repairRoad(map, command.city1, command.city2, command.lastRepair)) {
+    if (!repairRoadByKeys(map, &(command.city1), &(command.city2),
+                          command.lastRepair)) {
       executeError(*line);
     }
   }
   else if (command.commandType == GET_ROUTE) {
-    if (duplicateCities(command.cities, command.citiesNumber) == YES) {
+    if (duplicateCities(&command) == YES) {
       executeError(*line);
     }
-    else if (!getRoute(map, command.routeID, command.cities, command.lengthArr,
-            command.lastRepairArr, command.citiesNumber)) {
+    else if (!importRoute(map, &command)) {
       executeError(*line);
     }
   }
   else if (command.commandType == GET_ROUTE_DESCR) {
-    char const *str = getRouteDescription(map, command.routeID);
+    char const *str = getRouteDescriptionInto(map, command.routeID,
+                                              &description,
+                                              &descriptionCapacity);
     if (!str) {
       executeError(*line);
     }
-    printf("%s\n", str);
-    free((void *) str);
+    else {
+      printDescription(str);
+    }
   }
   else if (command.commandType == NEW_ROUTE) {
-    if (!newRoute(map, command.routeID, command.city1, command.city2)) {
+    if (!newRouteByKeys(map, command.routeID, &(command.city1),
+                        &(command.city2))) {
       executeError(*line);
     }
   }
   else if (command.commandType == EXTEND_ROUTE) {
-    if (!extendRoute(map, command.routeID, command.city1)) {
+    if (!extendRouteByKey(map, command.routeID, &(command.city1))) {
       executeError(*line);
     }
   }
   else if (command.commandType == REMOVE_ROAD) {
-    if (!removeRoad(map, command.city1, command.city2)) {
+    if (!removeRoadByKeys(map, &(command.city1), &(command.city2))) {
       executeError(*line);
     }
   }
@@ -106,3 +192,83 @@ bool executeCommand(Command command, Map *map, int *line) {
   (*line)++;
   return true;
 }
+
+void finishExecution(void) {
+  free(description);
+  description = NULL;
+  descriptionCapacity = 0;
+}
+
+bool isRouteCommand(Command command) {
+  return command.commandType == NEW_ROUTE ||
+         command.commandType == EXTEND_ROUTE || command.commandType == IGNORE;
+}
+
+/**@brief Wykonuje ciąg poleceń tworzenia i wydłużania dróg krajowych.
+ * Zamienia poprawne polecenia na jedno polecenie zbiorcze, a następnie
+ * wypisuje błędy dla kolejnych linii wejścia w kolejności poleceń.
+ * @param commands - tablica poleceń, dla których @ref isRouteCommand daje
+ * @p true;
+ * @param number - liczba poleceń;
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param line - liczba wczytanych dotąd linii wejścia.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci na polecenie
+ * zbiorcze. Wtedy żadne polecenie nie zostało wykonane.
+ */
+static bool executeRouteCommands(Command *commands, unsigned number, Map *map,
+                                 int *line) {
+  RouteRequest *requests = malloc(number * sizeof(RouteRequest));
+  bool *results = malloc(number * sizeof(bool));
+  bool *valid = malloc(number * sizeof(bool));
+  if (!requests || !results || !valid) {
+    free(requests);
+    free(results);
+    free(valid);
+    return false;
+  }
+  unsigned requestsNumber = 0;
+  for (unsigned i = 0; i < number; i++) {
+    valid[i] = (commands[i].commandType != IGNORE && validCommand(commands[i]));
+    if (valid[i]) {
+      RouteRequest *request = &(requests[requestsNumber++]);
+      request->extend = (commands[i].commandType == EXTEND_ROUTE);
+      request->routeId = commands[i].routeID;
+      request->city1 = commands[i].city1;
+      request->city2 = commands[i].city2;
+    }
+  }
+  executeRouteRequests(map, requests, requestsNumber, results);
+  requestsNumber = 0;
+  for (unsigned i = 0; i < number; i++) {
+    if (commands[i].commandType != IGNORE &&
+        (!valid[i] || !results[requestsNumber++])) {
+      executeError(*line);
+    }
+    (*line)++;
+  }
+  free(requests);
+  free(results);
+  free(valid);
+  return true;
+}
+
+bool executeCommands(Command *commands, unsigned number, Map *map, int *line) {
+  unsigned begin = 0;
+  while (begin < number) {
+    unsigned end = begin;
+    while (end < number && isRouteCommand(commands[end])) {
+      end++;
+    }
+    if (end - begin > 1 &&
+        executeRouteCommands(commands + begin, end - begin, map, line)) {
+      begin = end;
+    }
+    else if (!executeCommand(commands[begin], map, line)) {
+      return false;
+    }
+    else {
+      begin++;
+    }
+  }
+  return true;
+}
@@ -22,4 +22,32 @@
  */
 bool executeCommand(Command command, Map *map, int *line);
 
+/**@brief Zwalnia pamięć używaną przez kolejne komendy.
+ * Zwalnia bufor opisów dróg krajowych, używany ponownie przez kolejne
+ * polecenia getRouteDescription.
+ */
+void finishExecution(void);
+
+/**@brief Sprawdza, czy komenda może należeć do bloku poleceń dróg krajowych.
+ * @param command - wczytana komenda.
+ * @return Zwraca @p true dla poleceń newRoute i extendRoute oraz linii
+ * ignorowanych. W przeciwnym razie zwraca @p false.
+ */
+bool isRouteCommand(Command command);
+
+/**@brief Wykonuje ciąg komend.
+ * Kolejne polecenia newRoute i extendRoute są wykonywane jednym poleceniem
+ * zbiorczym (zob. @ref executeRouteRequests), a pozostałe komendy tak jak
+ * przez @ref executeCommand. Wynik i wypisywane komunikaty są takie same jak
+ * przy wykonaniu komend po kolei.
+ * @param commands - tablica wczytanych komend;
+ * @param number - liczba komend;
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param line - liczba wczytanych dotąd linii wejścia.
+ * @return Jeśli podczas wczytywania którejś komendy nastąpił błąd alokacji
+ * pamięci, zwraca @p false; komendy po niej nie są wykonywane. W każdym innym
+ * wypadku zwraca @p true.
+ */
+bool executeCommands(Command *commands, unsigned number, Map *map, int *line);
+
 #endif //DROGI_EXECUTE_H
@@ -11,12 +11,19 @@
 #endif
 
 #include "input.h"
+#include "scan.h"
+#include "city_hashmap.h"
+#include "binary.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <limits.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #define ADD_ROAD_TEXT "addRoad" ///< Pierwszy wyraz polecenia addRoad
 #define REPAIR_TEXT "repairRoad" ///< Pierwszy wyraz polecenia repairRoad
@@ -28,382 +35,516 @@
 #define REMOVE_ROAD_TEXT "removeRoad" ///< Początek polecenia removeRoad
 #define REMOVE_ROUTE_TEXT "removeRoute" ///< Początek polecenia removeRoute
 
-#define BASE 10 ///< System, w którym zapisane są odczytywane liczby
+///Najmniejszy rozmiar bloku wczytywanego naraz z potoku.
+#define INPUT_BLOCK_SIZE (1 << 20)
 
-/**@brief Tworzy nową strukturę.
- * Tworzy strukturę pustej komendy.
- * @return Zwraca utworzoną strukturę.
+/**
+ * Struktura przechowująca blok wejścia, na który wskazują wczytane polecenia.
  */
-Command initCommand() {
-  Command new;
-  new.commandType = WRONG_COMMAND;
-  new.lastRepair = 0;
-  new.lengthArr = NULL;
-  new.cities = NULL;
-  new.city1 = NULL;
-  new.city2 = NULL;
-  new.lastRepairArr = NULL;
-  new.length = 0;
-  new.lastRepairArr = 0;
-  new.citiesNumber = 0;
-  new.strBeginning = NULL;
-  return new;
-}
-
-void deleteCommand(Command command) {
-  if (command.cities) {
-    free(command.cities);
-  }
-  if (command.lastRepairArr) {
-    free(command.lastRepairArr);
-  }
-  if (command.lengthArr) {
-    free(command.lengthArr);
-  }
-  if (command.strBeginning) {
-    free(command.strBeginning);
-  }
-}
-
-/** @brief Liczy miasta w komendzie.
- * Liczy potencjalne nazwy miast w linii wejścia.
- * @param str  - wskaźnik na linię wejścia;
- * @param size  - długość linii wejścia.
- * @return Zwraca liczbę potencjalnych miast.
+struct InputChunk {
+  char *data; ///< Początek bloku.
+  size_t size; ///< Liczba wczytanych znaków.
+  size_t capacity; ///< Rozmiar bloku.
+  unsigned users; ///< Liczba poleceń i czytników korzystających z bloku.
+  bool mapped; ///< Informacja, czy blok jest odwzorowanym w pamięci plikiem.
+};
+
+/**
+ * Struktura przechowująca stan czytania wejścia blokami.
  */
-static int citiesNumber(char *str, size_t size) {
-  int semicolon = 0;
-  for (size_t i = 0; i < size; i++) {
-    if (str[i] == '\0') {
-      semicolon++;
-    }
-  }
-  return (semicolon - 1) / 3 + 1;
-}
+typedef struct BlockInput {
+  bool active; ///< Informacja, czy wejście jest czytane blokami.
+  InputChunk *chunk; ///< Bieżący blok lub NULL.
+  size_t position; ///< Początek pierwszej nieprzeczytanej linii w bloku.
+  bool finished; ///< Informacja, czy osiągnięto koniec wejścia.
+  InputChunk *spare; ///< Zwolniony blok do ponownego użycia lub NULL.
+  bool binary; ///< Informacja, czy wejście jest w formacie binarnym.
+} BlockInput;
+
+///Stan czytania wejścia blokami.
+static BlockInput blockInput = {false, NULL, 0, false, NULL, false};
 
-///Czyta liczbę całkowitą. W przypadku błędu zwraca 0.
-static int readInt(char *str) {
-  if ((str[0] < '0' || str[0] > '9') && str[0] != '-') {
-    return 0;
-  }
-  char *endptr = NULL;
-  int64_t bigNumber = strtol(str, &endptr, BASE);
-  if (bigNumber > INT_MAX || bigNumber < INT_MIN) {
-    return 0;
-  }
-  if (endptr && strcmp(endptr, "") != 0 && strcmp(endptr, "\n") != 0) {
-    return 0;
-  }
-  int value = bigNumber;
-  return value;
+/**
+ * Struktura przechowująca podział linii wejścia na pola.
+ */
+typedef struct Fields {
+  char **starts; ///< Początki kolejnych pól i początek za ostatnim polem.
+  unsigned number; ///< Liczba pól.
+  unsigned capacity; ///< Rozmiar tablicy początków pól.
+  ///Informacja, czy pola poza pierwszym zawierają znaki o kodach od 1 do 31.
+  bool invalidBytes;
+} Fields;
+
+///Podział ostatnio rozpoznanej linii, którego tablica jest używana ponownie.
+static Fields lineFields = {NULL, 0, 0, false};
+
+///Nazwa miasta nieobecnego w poleceniu.
+static const CityKey noCity = {NULL, 0, 0};
+
+void initCommand(Command *command) {
+  command->commandType = WRONG_COMMAND;
+  command->routeID = 0;
+  command->routeFields = NULL;
+  command->lastRepair = 0;
+  command->citiesNumber = 0;
+  command->city1 = noCity;
+  command->city2 = noCity;
+  command->length = 0;
+  command->strBeginning = NULL;
+  command->strCapacity = 0;
+  command->chunk = NULL;
+  command->invalidBytes = false;
+  command->binary = false;
 }
 
-///Czyta liczbę nieujemną. W przypadku błędu zwraca 0.
-static unsigned readUnsigned(char *str) {
-  if (str[0] < '0' || str[0] > '9') {
-    return 0;
+/**@brief Zwalnia blok wejścia.
+ * Zmniejsza liczbę korzystających z bloku i zwalnia go, jeśli nikt już z niego
+ * nie korzysta. Zwykły blok o rozmiarze INPUT_BLOCK_SIZE jest zachowywany do
+ * ponownego użycia, jeśli wejście jest nadal czytane blokami.
+ * @param chunk - wskaźnik na blok wejścia.
+ */
+static void releaseChunk(InputChunk *chunk) {
+  if (--(chunk->users) > 0) {
+    return;
   }
-  char *endptr = NULL;
-  int64_t bigNumber = strtol(str, &endptr, BASE);
-  if (bigNumber > UINT32_MAX || bigNumber < 0) {
-    return 0;
+  if (chunk->mapped) {
+    munmap(chunk->data, chunk->capacity);
   }
-  if (endptr && strcmp(endptr, "") != 0 && strcmp(endptr, "\n") != 0) {
-    return 0;
+  else if (blockInput.active && !blockInput.spare &&
+           chunk->capacity == INPUT_BLOCK_SIZE) {
+    blockInput.spare = chunk;
+    return;
   }
-  unsigned value = bigNumber;
-  return value;
-}
-
-///Przenosi wskaźnik na następny napis we wczytanej linii wejścia.
-static int movePointer(char *str, size_t *i, size_t size) {
-  size_t actSize = strlen(str) + *i;
-  while ((*i) < actSize) {
-    (*i)++;
-  }
-  (*i)++;
-  if ((*i) >= size) {
-    return WRONG_COMMAND;
+  else {
+    free(chunk->data);
   }
-  return ADD_ROAD;
+  free(chunk);
 }
 
-///Wypełnia danymi strukturę komendy dla polecenia addRoad.
-static int fillAddRoad(Command *command, char *str, size_t size) {
-  size_t i = 0;
-  if (movePointer(str, &i, size) == WRONG_COMMAND) {
-    return WRONG_COMMAND;
-  }
-  command->city1 = str + i;
-  if (movePointer(str + i, &i, size) == WRONG_COMMAND) {
-    return WRONG_COMMAND;
-  }
-  command->city2 = str + i;
-  if (movePointer(str + i, &i, size) == WRONG_COMMAND) {
-    return WRONG_COMMAND;
-  }
-  if (!(str + i) || strcmp(str + i, "") == 0) {
-    return WRONG_COMMAND;
-  }
-
-  command->length = readUnsigned(str + i);
-  if (command->length <= 0) {
-    return WRONG_COMMAND;
-  }
-
-  if (movePointer(str + i, &i, size) == WRONG_COMMAND) {
-    return WRONG_COMMAND;
-  }
-  if ((str + i) && strcmp(str + i, "\n") == 0) {
-    return WRONG_COMMAND;
-  }
-
-  command->lastRepair = readInt(str + i);
-  if (command->lastRepair == 0) {
-    return WRONG_COMMAND;
-  }
+/**@brief Przygotowuje komendę do wczytania kolejnej linii.
+ * Zwalnia blok wejścia, na który wskazywała komenda, i zeruje jej pola,
+ * zachowując bufor linii.
+ * @param command - wskaźnik na strukturę komendy.
+ */
+static void resetCommand(Command *command) {
+  if (command->chunk) {
+    releaseChunk(command->chunk);
+  }
+  command->commandType = WRONG_COMMAND;
+  command->routeID = 0;
+  command->routeFields = NULL;
+  command->lastRepair = 0;
+  command->citiesNumber = 0;
+  command->city1 = noCity;
+  command->city2 = noCity;
+  command->length = 0;
+  command->chunk = NULL;
+  command->invalidBytes = false;
+  command->binary = false;
+}
 
-  movePointer(str + i, &i, size);
-  if (i != size + 1) {
-    return WRONG_COMMAND;
-  }
-  return ADD_ROAD;
+void deleteCommand(Command *command) {
+  resetCommand(command);
+  free(command->strBeginning);
+  initCommand(command);
 }
 
-///Wypełnia danymi strukturę komendy dla polecenia getRouteDescription.
-static int fillRouteDescr(Command *command, char *str, size_t size) {
-  size_t i = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+///Informacja, że cyfry można przetwarzać po osiem naraz w słowie 64-bitowym.
+#define SWAR_DIGITS 1
+#endif
 
-  if (movePointer(str, &i, size) == WRONG_COMMAND) {
-    return WRONG_COMMAND;
+#define DIGITS_STEP 8 ///< Liczba cyfr przetwarzanych naraz.
+#define ZEROS 0x3030303030303030ULL ///< Osiem znaków '0' w słowie 64-bitowym.
+#define HIGH_NIBBLES 0xF0F0F0F0F0F0F0F0ULL ///< Maska starszych połówek bajtów.
+
+/**@brief Odczytuje liczbę zapisaną samymi cyframi dziesiętnymi.
+ * Przetwarza po DIGITS_STEP cyfr naraz w słowie 64-bitowym, a pierwszy,
+ * niepełny fragment uzupełnia z przodu zerami. Nie wymaga, żeby pole było
+ * zakończone znakiem '\0'.
+ * @param text - wskaźnik na początek pola;
+ * @param length - długość pola;
+ * @param limit - największa dopuszczalna wartość, mniejsza niż 2^34;
+ * @param value - wskaźnik, pod który zostanie zapisana wartość.
+ * @return Zwraca @p false, jeśli pole jest puste, zawiera znak niebędący cyfrą
+ * lub zapisana w nim liczba jest większa niż @p limit. W przeciwnym razie
+ * zwraca @p true.
+ */
+static bool readDigits(const char *text, size_t length, uint64_t limit,
+                       uint64_t *value) {
+  if (length == 0) {
+    return false;
   }
-
-  command->routeID = readUnsigned(str + i);
-  if (command->routeID == 0) {
-    return WRONG_COMMAND;
+  uint64_t result = 0;
+#ifdef SWAR_DIGITS
+  size_t size = length % DIGITS_STEP ? length % DIGITS_STEP : DIGITS_STEP;
+  for (size_t i = 0; i < length; i += size, size = DIGITS_STEP) {
+    uint64_t chunk = ZEROS;
+    memcpy((char *) &chunk + DIGITS_STEP - size, text + i, size);
+    if ((chunk & HIGH_NIBBLES) != ZEROS ||
+        ((chunk + 0x0606060606060606ULL) & HIGH_NIBBLES) != ZEROS) {
+      return false;
+    }
+    chunk -= ZEROS;
+    chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FFULL;
+    chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFFULL;
+    chunk = (chunk * 10000 + (chunk >> 32)) & 0x00000000FFFFFFFFULL;
+    result = result * 100000000 + chunk;
+    if (result > limit) {
+      return false;
+    }
   }
-
-  movePointer(str + i, &i, size);
-  if (i != size + 1) {
-    return WRONG_COMMAND;
+#else
+  for (size_t i = 0; i < length; i++) {
+    if (text[i] < '0' || text[i] > '9') {
+      return false;
+    }
+    result = result * 10 + (uint64_t) (text[i] - '0');
+    if (result > limit) {
+      return false;
+    }
   }
-
-  return GET_ROUTE_DESCR;
+#endif
+  *value = result;
+  return true;
 }
 
-///Wypełnia danymi strukturę komendy dla polecenia repairRoad.
-static int fillRepairRoad(Command *command, char *str, size_t size) {
-  size_t i = 0;
-
-  if (movePointer(str, &i, size) == WRONG_COMMAND) {
-    return WRONG_COMMAND;
+/**
+ * Czyta liczbę całkowitą zapisaną cyframi dziesiętnymi, poprzedzonymi
+ * ewentualnie znakiem '-'.
+ * @param text - wskaźnik na początek pola;
+ * @param length - długość pola.
+ * @return Zwraca odczytaną liczbę lub 0, jeśli pole ma niewłaściwy format albo
+ * liczba nie mieści się w typie int.
+ */
+static int readInt(const char *text, size_t length) {
+  bool negative = length > 0 && text[0] == '-';
+  uint64_t value;
+  if (!readDigits(text + negative, length - negative,
+                  negative ? (uint64_t) INT_MAX + 1 : INT_MAX, &value)) {
+    return 0;
   }
-  command->city1 = str + i;
+  return negative ? (int) -(int64_t) value : (int) value;
+}
 
-  if (movePointer(str + i, &i, size) == WRONG_COMMAND) {
-    return WRONG_COMMAND;
+/**
+ * Czyta liczbę nieujemną zapisaną cyframi dziesiętnymi.
+ * @param text - wskaźnik na początek pola;
+ * @param length - długość pola.
+ * @return Zwraca odczytaną liczbę lub 0, jeśli pole ma niewłaściwy format albo
+ * liczba nie mieści się w typie unsigned.
+ */
+static unsigned readUnsigned(const char *text, size_t length) {
+  uint64_t value;
+  if (!readDigits(text, length, UINT32_MAX, &value)) {
+    return 0;
   }
-  command->city2 = str + i;
+  return (unsigned) value;
+}
 
-  if (movePointer(str + i, &i, size) == WRONG_COMMAND) {
-    return WRONG_COMMAND;
-  }
+///Początkowy rozmiar tablicy początków pól linii.
+#define INITIAL_FIELDS 16
 
-  command->lastRepair = readInt(str + i);
-  if (command->lastRepair == 0) {
-    return WRONG_COMMAND;
-  }
+/**
+ * Struktura opisująca słowo kluczowe polecenia.
+ */
+typedef struct Keyword {
+  const char *text; ///< Słowo kluczowe.
+  size_t length; ///< Długość słowa kluczowego.
+  int type; ///< Rodzaj polecenia.
+  unsigned fields; ///< Liczba pól polecenia razem ze słowem kluczowym.
+} Keyword;
+
+///Słowa kluczowe poleceń.
+static const Keyword keywords[] = {
+  {ADD_ROAD_TEXT, sizeof(ADD_ROAD_TEXT) - 1, ADD_ROAD, 5},
+  {GET_DESCR_TEXT, sizeof(GET_DESCR_TEXT) - 1, GET_ROUTE_DESCR, 2},
+  {REPAIR_TEXT, sizeof(REPAIR_TEXT) - 1, REPAIR_ROAD, 4},
+  {NEW_ROUTE_TEXT, sizeof(NEW_ROUTE_TEXT) - 1, NEW_ROUTE, 4},
+  {EXTEND_ROUTE_TEXT, sizeof(EXTEND_ROUTE_TEXT) - 1, EXTEND_ROUTE, 3},
+  {REMOVE_ROAD_TEXT, sizeof(REMOVE_ROAD_TEXT) - 1, REMOVE_ROAD, 3},
+  {REMOVE_ROUTE_TEXT, sizeof(REMOVE_ROUTE_TEXT) - 1, REMOVE_ROUTE, 2},
+};
 
-  movePointer(str + i, &i, size);
-  if (i != size + 1) {
-    return WRONG_COMMAND;
-  }
-  return REPAIR_ROAD;
+/**
+ * Podaje długość pola linii.
+ * @param fields - wskaźnik na podział linii;
+ * @param index - numer pola.
+ * @return Zwraca liczbę znaków pola.
+ */
+static size_t fieldLength(const Fields *fields, unsigned index) {
+  return (size_t) (fields->starts[index + 1] - fields->starts[index] - 1);
 }
 
-/**@brief Alokuje pamięć w komendzie.
- * Alokuje pamięć potrzebną do wywołania manualnego tworzenia nowej drogi
- * krajowej.
- * @param command - struktura komendy.
- * @param number - liczba miast w tablicy.
- * @return Zwraca @p true, jeśli alokacja pamięci się powiodła, a @p false jeśli
- * nie.
+/**@brief Dopisuje początek pola.
+ * Jeśli tablica początków pól jest pełna, powiększa ją dwukrotnie. Tablica
+ * nie jest zwalniana po rozpoznaniu linii, więc kolejne linie nie wymagają
+ * alokowania pamięci.
+ * @param fields - wskaźnik na podział linii;
+ * @param start - początek pola.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
  */
-static bool allocateMemory(Command *command, int number) {
-  if (!command->cities) {
-    command->cities = malloc(number * sizeof(char*));
-  }
-  if (!command->lengthArr) {
-    command->lengthArr = malloc((number - 1) * sizeof(unsigned));
-  }
-
-  if (!command->lastRepairArr) {
-    command->lastRepairArr = malloc((number - 1) * sizeof(int));
-  }
-
-  if (!(command->cities) || !(command->lengthArr) ||
-     !(command->lastRepairArr)) {
-    return false;
-  }
-  for (int i = 0; i < number; i++) {
-    command->cities[i] = NULL;
+static bool addField(Fields *fields, char *start) {
+  if (fields->number + 1 >= fields->capacity) {
+    unsigned capacity = fields->capacity ? 2 * fields->capacity :
+                        INITIAL_FIELDS;
+    char **starts = realloc(fields->starts, capacity * sizeof(char *));
+    if (!starts) {
+      return false;
+    }
+    fields->starts = starts;
+    fields->capacity = capacity;
   }
+  fields->starts[(fields->number)++] = start;
   return true;
 }
 
-/// Wypełnia danymi strukturę komendy dla polecenia oznaczającego manualne dodanie drogi krajowej.
-static int fillGetRoute(Command *command, char *str, size_t size) {
-  command->routeID = readUnsigned(str);
-  if (command->routeID == 0) {
-    return WRONG_COMMAND;
-  }
-
-  command->citiesNumber = citiesNumber(str, size);
-  if (command->citiesNumber < 2) {
-    return WRONG_COMMAND;
-  }
-
-  if (!allocateMemory(command, command->citiesNumber)) {
-    return MEMORY_ERROR;
+/**@brief Dzieli linię wejścia na pola.
+ * W jednym przejściu, po SCAN_BLOCK znaków naraz, zastępuje znaki ';' znakami
+ * '\0', zapamiętuje początki pól i sprawdza, czy pola poza pierwszym zawierają
+ * znaki o kodach od 1 do 31.
+ * @param fields - wskaźnik na strukturę, do której zostanie zapisany podział;
+ * @param str - wskaźnik na linię wejścia bez znaków '\n' i '\0', zakończoną
+ * znakiem '\0';
+ * @param size - długość linii wejścia.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool splitLine(Fields *fields, char *str, size_t size) {
+  fields->number = 0;
+  fields->invalidBytes = false;
+  if (!addField(fields, str)) {
+    return false;
   }
-
-  int counter = 0;
-  size_t i = 0;
-  while (counter < command->citiesNumber - 1) {
-    if (movePointer(str + i, &i, size) == WRONG_COMMAND) {
-      return WRONG_COMMAND;
+  ScanKernel scan = chooseScanKernel(size);
+  for (size_t i = 0; i < size; i += SCAN_BLOCK) {
+    unsigned block = size - i < SCAN_BLOCK ? (unsigned) (size - i) : SCAN_BLOCK;
+    uint64_t semicolons, controls;
+    scan(str + i, block, &semicolons, &controls);
+    if (fields->number == 1) {
+      uint64_t first = semicolons & (~semicolons + 1);
+      controls &= ~((first << 1) - 1);
     }
-    command->cities[counter] = str + i;
-
-    if (movePointer(str + i, &i, size) == WRONG_COMMAND) {
-      return WRONG_COMMAND;
+    if (controls) {
+      fields->invalidBytes = true;
     }
-
-    command->lengthArr[counter] = readUnsigned(str + i);
-    if (command->lengthArr[counter] == 0) {
-      return WRONG_COMMAND;
-    }
-
-    if (movePointer(str + i, &i, size) == WRONG_COMMAND) {
-      return WRONG_COMMAND;
-    }
-
-    command->lastRepairArr[counter] = readInt(str +i);
-    if (command->lastRepairArr[counter] == 0) {
-      return WRONG_COMMAND;
+    while (semicolons) {
+      size_t position = i + lowestBit(semicolons);
+      semicolons &= semicolons - 1;
+      str[position] = '\0';
+      if (!addField(fields, str + position + 1)) {
+        return false;
+      }
     }
-
-    counter++;
-  }
-  if (movePointer(str + i, &i, size) == WRONG_COMMAND) {
-    return WRONG_COMMAND;
   }
-  command->cities[counter] = str + i;
-  movePointer(str + i, &i, size);
-  if (i != size + 1) {
-    return WRONG_COMMAND;
-  }
-  str[i - 2] = '\0';
-  return GET_ROUTE;
+  fields->starts[fields->number] = str + size + 1;
+  return true;
 }
 
-/// Wypełnia danymi strukturę komendy dla polecenia newRoute.
-static int fillNewRoute(Command *command, char *str, size_t size) {
-  size_t i = 0;
-  if (movePointer(str, &i, size) == WRONG_COMMAND) {
-    return WRONG_COMMAND;
-  }
-
-  command->routeID = readUnsigned(str + i);
-  if (command->routeID == 0) {
-    return WRONG_COMMAND;
-  }
-
-  if (movePointer(str + i, &i, size) == WRONG_COMMAND) {
-    return WRONG_COMMAND;
-  }
-  command->city1 = str + i;
-
-  if (movePointer(str + i, &i, size) == WRONG_COMMAND) {
-    return WRONG_COMMAND;
+/**@brief Rozpoznaje słowo kluczowe polecenia.
+ * Wybiera jedyne możliwe słowo kluczowe na podstawie pierwszych znaków pola,
+ * a następnie sprawdza, czy pole się od niego zaczyna.
+ * @param word - wskaźnik na pierwsze pole linii;
+ * @param length - długość pola.
+ * @return Zwraca wskaźnik na opis słowa kluczowego lub NULL, jeśli pole nie
+ * zaczyna się od żadnego z nich.
+ */
+static const Keyword *findKeyword(const char *word, size_t length) {
+  const Keyword *keyword;
+  switch (word[0]) {
+    case 'a':
+      keyword = &keywords[0];
+      break;
+    case 'g':
+      keyword = &keywords[1];
+      break;
+    case 'n':
+      keyword = &keywords[3];
+      break;
+    case 'e':
+      keyword = &keywords[4];
+      break;
+    case 'r':
+      if (length > 2 && word[2] == 'p') {
+        keyword = &keywords[2];
+      }
+      else if (length > 8 && word[8] == 'a') {
+        keyword = &keywords[5];
+      }
+      else {
+        keyword = &keywords[6];
+      }
+      break;
+    default:
+      return NULL;
   }
-  command->city2 = str + i;
-
-  movePointer(str + i, &i, size);
-  if (i != size + 1) {
-    return WRONG_COMMAND;
+  if (length < keyword->length ||
+      memcmp(word, keyword->text, keyword->length) != 0) {
+    return NULL;
   }
-  return NEW_ROUTE;
+  return keyword;
 }
 
-/// Wypełnia danymi strukturę komendy dla polecenia fillGetRoute.
-static int fillExtendRoute(Command *command, char *str, size_t size) {
-  size_t i = 0;
-
-  if (movePointer(str, &i, size) == WRONG_COMMAND) {
-    return WRONG_COMMAND;
-  }
+#define ROUTE_ID_FIELD 0 ///< Pole z numerem drogi krajowej.
+#define CITY_FIELD 1 ///< Pole z nazwą miasta w opisie drogi krajowej.
+#define LENGTH_FIELD 2 ///< Pole z długością odcinka w opisie drogi krajowej.
+#define YEAR_FIELD 3 ///< Pole z datą remontu w opisie drogi krajowej.
 
-  command->routeID = readUnsigned(str + i);
-  if (command->routeID == 0) {
-    return WRONG_COMMAND;
-  }
-
-  if (movePointer(str + i, &i, size) == WRONG_COMMAND) {
-    return WRONG_COMMAND;
-  }
-  command->city1 = str + i;
-
-  movePointer(str + i, &i, size);
-  if (i != size + 1) {
-    return WRONG_COMMAND;
+/**@brief Sprawdza pole opisu drogi krajowej.
+ * Pola opisu są kolejno: numer drogi krajowej, a następnie trójki: nazwa
+ * miasta, długość odcinka drogi i data jego ostatniego remontu, zakończone
+ * nazwą ostatniego miasta.
+ * @param command - struktura komendy;
+ * @param field - wskaźnik na początek pola;
+ * @param length - długość pola;
+ * @param kind - rodzaj pola: ROUTE_ID_FIELD, CITY_FIELD, LENGTH_FIELD lub
+ * YEAR_FIELD;
+ * @param cityLength - wskaźnik na długość ostatniej nazwy miasta, uaktualnianą
+ * dla pól z nazwą miasta.
+ * @return Zwraca @p false, jeśli pole ma niewłaściwy format, lub nazwa miasta
+ * przed odcinkiem drogi jest pusta. W przeciwnym razie zwraca @p true.
+ */
+static bool checkRouteField(Command *command, const char *field, size_t length,
+                            int kind, size_t *cityLength) {
+  switch (kind) {
+    case ROUTE_ID_FIELD:
+      command->routeID = readUnsigned(field, length);
+      return command->routeID != 0;
+    case CITY_FIELD:
+      *cityLength = length;
+      return true;
+    case LENGTH_FIELD:
+      return *cityLength > 0 && readUnsigned(field, length) != 0;
+    default:
+      return readInt(field, length) != 0;
   }
-  return EXTEND_ROUTE;
 }
 
-/// Wypełnia danymi strukturę komendy dla polecenia removeRoad.
-static int fillRemoveRoad(Command *command, char *str, size_t size) {
-  size_t i = 0;
-  if (movePointer(str, &i, size) == WRONG_COMMAND) {
-    return WRONG_COMMAND;
+/**@brief Wypełnia danymi strukturę komendy dla polecenia oznaczającego
+ * manualne dodanie drogi krajowej.
+ * Przegląda linię jeden raz, po SCAN_BLOCK znaków naraz, zastępuje znaki ';'
+ * znakami '\0' i sprawdza każde pole zaraz po jego zakończeniu, nie
+ * zapamiętując początków pól. Odcinki drogi można potem przeglądać funkcją
+ * nextSegment().
+ * @param command - struktura komendy;
+ * @param str - wskaźnik na linię wejścia bez znaków '\n' i '\0', zakończoną
+ * znakiem '\0' i zaczynającą się cyfrą;
+ * @param size - długość linii wejścia.
+ * @return Zwraca GET_ROUTE lub WRONG_COMMAND, jeśli opis drogi krajowej ma
+ * niewłaściwy format.
+ */
+static int fillGetRoute(Command *command, char *str, size_t size) {
+  unsigned index = 0;
+  int kind = ROUTE_ID_FIELD;
+  char *field = str;
+  size_t cityLength = 0;
+  ScanKernel scan = chooseScanKernel(size);
+  for (size_t i = 0; i < size; i += SCAN_BLOCK) {
+    unsigned block = size - i < SCAN_BLOCK ? (unsigned) (size - i) : SCAN_BLOCK;
+    uint64_t semicolons, controls;
+    scan(str + i, block, &semicolons, &controls);
+    if (index == 0) {
+      uint64_t first = semicolons & (~semicolons + 1);
+      controls &= ~((first << 1) - 1);
+    }
+    if (controls) {
+      command->invalidBytes = true;
+    }
+    while (semicolons) {
+      char *end = str + i + lowestBit(semicolons);
+      semicolons &= semicolons - 1;
+      *end = '\0';
+      if (!checkRouteField(command, field, (size_t) (end - field), kind,
+                           &cityLength)) {
+        return WRONG_COMMAND;
+      }
+      if (kind == ROUTE_ID_FIELD) {
+        command->routeFields = end + 1;
+      }
+      kind = kind == YEAR_FIELD ? CITY_FIELD : kind + 1;
+      index++;
+      field = end + 1;
+    }
   }
-  command->city1 = str + i;
-
-  if (movePointer(str + i, &i, size) == WRONG_COMMAND) {
+  if (index < 4 || index % 3 != 1) {
     return WRONG_COMMAND;
   }
-  command->city2 = str + i;
+  command->citiesNumber = (int) (index - 1) / 3 + 1;
+  return GET_ROUTE;
+}
 
-  movePointer(str + i, &i, size);
-  if (i != size + 1) {
-    return WRONG_COMMAND;
-  }
-  return REMOVE_ROAD;
+/**@brief Opisuje pole z nazwą miasta.
+ * Wyznacza indeks nazwy, więc mapa nie musi jej ponownie przeglądać.
+ * @param fields - wskaźnik na podział linii;
+ * @param index - numer pola.
+ * @return Zwraca nazwę miasta, jej długość i indeks.
+ */
+static CityKey fieldKey(const Fields *fields, unsigned index) {
+  CityKey key;
+  key.name = fields->starts[index];
+  key.length = (unsigned) fieldLength(fields, index);
+  key.index = cityIndex(key.name, key.length);
+  return key;
 }
 
-/// Wypełnia danymi strukturę komendy dla polecenia removeRoute.
-static int fillRemoveRoute(Command *command, char *str, size_t size) {
-  size_t i = 0;
-  if (movePointer(str, &i, size) == WRONG_COMMAND) {
-    return WRONG_COMMAND;
-  }
-  command->routeID = readUnsigned(str + i);
-  if (command->routeID == 0) {
-    return WRONG_COMMAND;
-  }
+/**
+ * Opisuje nazwę miasta w linii polecenia.
+ * @param name - wskaźnik na nazwę miasta zakończoną znakiem '\0'.
+ * @return Zwraca nazwę miasta, jej długość i indeks.
+ */
+static CityKey nameKey(const char *name) {
+  CityKey key;
+  key.name = name;
+  key.length = (unsigned) strlen(name);
+  key.index = cityIndex(name, key.length);
+  return key;
+}
 
-  movePointer(str + i, &i, size);
-  if (i != size + 1) {
-    return WRONG_COMMAND;
-  }
-  return REMOVE_ROUTE;
+/**@brief Wypełnia danymi strukturę komendy.
+ * Liczba pól linii jest już zgodna z rodzajem polecenia.
+ * @param command - struktura komendy;
+ * @param fields - wskaźnik na podział linii;
+ * @param type - rodzaj polecenia.
+ * @return Zwraca rodzaj polecenia lub WRONG_COMMAND, jeśli któraś z liczb ma
+ * niewłaściwy format.
+ */
+static int fillCommand(Command *command, Fields *fields, int type) {
+  char **field = fields->starts;
+  switch (type) {
+    case ADD_ROAD:
+      command->city1 = fieldKey(fields, 1);
+      command->city2 = fieldKey(fields, 2);
+      command->length = readUnsigned(field[3], fieldLength(fields, 3));
+      command->lastRepair = readInt(field[4], fieldLength(fields, 4));
+      return (command->length == 0 || command->lastRepair == 0) ?
+             WRONG_COMMAND : ADD_ROAD;
+    case REPAIR_ROAD:
+      command->city1 = fieldKey(fields, 1);
+      command->city2 = fieldKey(fields, 2);
+      command->lastRepair = readInt(field[3], fieldLength(fields, 3));
+      return command->lastRepair == 0 ? WRONG_COMMAND : REPAIR_ROAD;
+    case NEW_ROUTE:
+      command->city1 = fieldKey(fields, 2);
+      command->city2 = fieldKey(fields, 3);
+      break;
+    case EXTEND_ROUTE:
+      command->city1 = fieldKey(fields, 2);
+      break;
+    case REMOVE_ROAD:
+      command->city1 = fieldKey(fields, 1);
+      command->city2 = fieldKey(fields, 2);
+      return REMOVE_ROAD;
+  }
+  command->routeID = readUnsigned(field[1], fieldLength(fields, 1));
+  return command->routeID == 0 ? WRONG_COMMAND : type;
 }
 
 /**@brief Rozpoznaje typ komendy i wypełnia jej strukturę danymi.
- * W zależności od początku linii wejścia wypełnia odpowiednie pola struktury
- * Command odpowiednimi danymi.
+ * Dzieli linię na pola i w zależności od pierwszego z nich wypełnia
+ * odpowiednie pola struktury Command odpowiednimi danymi.
  * @param command - struktura komendy;
- * @param str - wskaźnik na wczytaną linię wejścia;
+ * @param str - wskaźnik na niepustą linię wejścia bez znaku '\n';
  * @param size - długość linii wejścia.
  * @return Zwraca wartość WRONG_COMMAND, jeśli polecenie miało niewłaściwy
  * format, MEMORY_ERROR jeśli wystąpił błąd alokacji pamięci i odpowiednią stałą
@@ -412,113 +553,432 @@ static int fillRemoveRoute(Command *command, char *str, size_t size) {
  * komendy).
  */
 static int identifyCommand(Command *command, char *str, size_t size) {
-  if (size < 1) {
-    return WRONG_COMMAND;
-  }
-  else if (str[0] >= '0' && str[0] <= '9') {
+  if (str[0] >= '0' && str[0] <= '9') {
     return fillGetRoute(command, str, size);
   }
-  else if (strstr(str, ADD_ROAD_TEXT) == str) {
-    return fillAddRoad(command, str, size);
+  Fields *fields = &lineFields;
+  if (!splitLine(fields, str, size)) {
+    return MEMORY_ERROR;
   }
-  else if (strstr(str, GET_DESCR_TEXT) == str) {
-    return fillRouteDescr(command, str, size);
+  command->invalidBytes = fields->invalidBytes;
+  const Keyword *keyword = findKeyword(str, fieldLength(fields, 0));
+  if (keyword && fields->number == keyword->fields) {
+    return fillCommand(command, fields, keyword->type);
   }
-  else if (strstr(str, REPAIR_TEXT) == str) {
-    return fillRepairRoad(command, str, size);
+  return WRONG_COMMAND;
+}
+
+/**@brief Rozpoznaje polecenie w linii wejścia.
+ * Pomija linie puste i komentarze, a pozostałe dzieli na napisy i wypełnia
+ * nimi strukturę komendy. Napisy wskazują na linię wejścia.
+ * @param command - wskaźnik na strukturę komendy;
+ * @param str - wskaźnik na linię wejścia bez znaku '\n', zakończoną znakiem
+ * '\0';
+ * @param size - długość linii wejścia.
+ */
+static void parseLine(Command *command, char *str, size_t size) {
+  if (size == 0 || str[0] == '#') {
+    command->commandType = IGNORE;
+    return;
   }
-  else if (strstr(str, NEW_ROUTE_TEXT) == str) {
-    return fillNewRoute(command, str, size);
+  if (str[size - 1] == ';') {
+    command->commandType = WRONG_COMMAND;
+    return;
   }
-  else if (strstr(str, EXTEND_ROUTE_TEXT) == str) {
-    return fillExtendRoute(command, str, size);
+  command->commandType = identifyCommand(command, str, size);
+}
+
+void parseCommand(Command *command, char *str, size_t size) {
+  resetCommand(command);
+  parseLine(command, str, size);
+}
+
+/**@brief Tworzy nowy blok wejścia.
+ * Jeśli to możliwe, używa ponownie zwolnionego bloku.
+ * @param capacity - rozmiar bloku.
+ * @return Zwraca wskaźnik na utworzony blok, z którego korzysta czytnik, lub
+ * NULL, jeśli nie udało się zaalokować pamięci.
+ */
+static InputChunk *newChunk(size_t capacity) {
+  InputChunk *chunk = blockInput.spare;
+  if (chunk && chunk->capacity == capacity) {
+    blockInput.spare = NULL;
+    chunk->size = 0;
+    chunk->users = 1;
+    return chunk;
+  }
+  chunk = malloc(sizeof(InputChunk));
+  if (!chunk) {
+    return NULL;
+  }
+  chunk->data = malloc(capacity);
+  if (!chunk->data) {
+    free(chunk);
+    return NULL;
+  }
+  chunk->size = 0;
+  chunk->capacity = capacity;
+  chunk->users = 1;
+  chunk->mapped = false;
+  return chunk;
+}
+
+/**@brief Doczytuje kolejny fragment wejścia.
+ * Jeśli bieżący blok jest pełny, przenosi nieprzeczytaną część do nowego,
+ * co najmniej dwa razy większego od niej bloku, a poprzedni zwalnia, gdy nie
+ * wskazuje już na niego żadne polecenie. Rozmiar bloku zależy więc tylko od
+ * długości faktycznie wczytanych danych.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool growBlock(void) {
+  InputChunk *chunk = blockInput.chunk;
+  if (!chunk || chunk->size == chunk->capacity) {
+    size_t rest = chunk ? chunk->size - blockInput.position : 0;
+    size_t capacity = INPUT_BLOCK_SIZE;
+    while (capacity < 2 * rest) {
+      capacity *= 2;
+    }
+    InputChunk *new = newChunk(capacity);
+    if (!new) {
+      return false;
+    }
+    if (chunk) {
+      memcpy(new->data, chunk->data + blockInput.position, rest);
+      releaseChunk(chunk);
+    }
+    new->size = rest;
+    blockInput.chunk = chunk = new;
+    blockInput.position = 0;
   }
-  else if (strstr(str, REMOVE_ROAD_TEXT) == str) {
-    return fillRemoveRoad(command, str, size);
+  ssize_t number = read(STDIN_FILENO, chunk->data + chunk->size,
+                        chunk->capacity - chunk->size);
+  if (number > 0) {
+    chunk->size += (size_t) number;
   }
-  else if (strstr(str, REMOVE_ROUTE_TEXT) == str) {
-    return fillRemoveRoute(command, str, size);
+  else if (number == 0 || errno != EINTR) {
+    blockInput.finished = true;
   }
-  else {
-    command->commandType = WRONG_COMMAND;
-    return WRONG_COMMAND;
+  return true;
+}
+
+/**@brief Doczytuje wejście do końca bieżącej linii.
+ * Jeśli bieżący blok nie zawiera całej linii, doczytuje kolejne fragmenty
+ * wejścia funkcją growBlock().
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool fillBlock(void) {
+  size_t searched = 0;
+  while (true) {
+    InputChunk *chunk = blockInput.chunk;
+    if (chunk && memchr(chunk->data + blockInput.position + searched, '\n',
+                        chunk->size - blockInput.position - searched)) {
+      return true;
+    }
+    if (blockInput.finished) {
+      return true;
+    }
+    searched = chunk ? chunk->size - blockInput.position : 0;
+    if (!growBlock()) {
+      return false;
+    }
   }
 }
 
-/**@brief Dzieli linię wejścia.
- * Dzieli linię wejścia na linię osobnych napisów zastępując znaki ';' znakami
- * '\0'.
- * @param str - wskaźnik na niepustą linię wejścia.
+/**
+ * Podaje liczbę wczytanych, nieprzeczytanych znaków wejścia.
+ * @return Zwraca liczbę znaków bieżącego bloku od początku nieprzeczytanej
+ * części.
+ */
+static size_t availableBytes(void) {
+  return blockInput.chunk ? blockInput.chunk->size - blockInput.position : 0;
+}
+
+/**@brief Doczytuje wejście do końca bieżącego rekordu binarnego.
+ * Tak jak fillBlock() czyta tylko tyle, ile potrzeba do rozpoznania całego
+ * rekordu, więc nie czeka na dane, które jeszcze nie nadeszły.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
  */
-static void editInput(char *str) {
-  size_t i = 0;
-  while (str[i] != '\0') {
-    if (str[i] == ';') {
-      str[i] = '\0';
+static bool fillRecord(void) {
+  while (!blockInput.finished) {
+    size_t available = availableBytes();
+    if (available > 0) {
+      size_t size = recordSize(blockInput.chunk->data + blockInput.position,
+                               available);
+      if (size != 0 && size <= available) {
+        return true;
+      }
+    }
+    if (!growBlock()) {
+      return false;
     }
-    i++;
   }
+  return true;
 }
 
-///Sprawdza, czy napis jest zakończony znakiem '\n'
-static bool endline(char *str, size_t size) {
-  size_t i = 0;
-  while (i < size && str[i] != '\n') {
-    i++;
+/**@brief Czyta pojedynczą linię wejścia czytanego blokami.
+ * Napisy polecenia wskazują na blok wejścia, który jest zwalniany dopiero
+ * razem z ostatnim wskazującym na niego poleceniem.
+ * @param command - wskaźnik na przygotowaną strukturę komendy, do której
+ * zostanie zapisane polecenie tak jak w readLine().
+ */
+static void readBlockLine(Command *command) {
+  if (!fillBlock()) {
+    command->commandType = MEMORY_ERROR;
+    return;
+  }
+  InputChunk *chunk = blockInput.chunk;
+  if (!chunk || blockInput.position >= chunk->size) {
+    command->commandType = EOF_FOUND;
+    return;
+  }
+  char *str = chunk->data + blockInput.position;
+  char *newline = memchr(str, '\n', chunk->size - blockInput.position);
+  if (!newline) {
+    blockInput.position = chunk->size;
+    return;
+  }
+  size_t size = (size_t) (newline - str);
+  blockInput.position += size + 1;
+  if (memchr(str, '\0', size)) {
+    return;
+  }
+  *newline = '\0';
+  (chunk->users)++;
+  command->chunk = chunk;
+  parseLine(command, str, size);
+}
+
+/**@brief Czyta pojedynczy rekord polecenia wejścia binarnego.
+ * Pomija rekordy BINARY_CITY, zapamiętując ich nazwy. Rekord niekompletny
+ * na końcu wejścia jest traktowany jak niepoprawna linia. Opis drogi krajowej
+ * polecenia GET_ROUTE wskazuje na blok wejścia.
+ * @param command - wskaźnik na przygotowaną strukturę komendy, do której
+ * zostanie zapisane polecenie tak jak w readLine().
+ */
+static void readBlockRecord(Command *command) {
+  while (true) {
+    if (!fillRecord()) {
+      command->commandType = MEMORY_ERROR;
+      return;
+    }
+    size_t available = availableBytes();
+    if (available == 0) {
+      command->commandType = EOF_FOUND;
+      return;
+    }
+    size_t size = recordSize(blockInput.chunk->data + blockInput.position,
+                             available);
+    if (size == 0 || size > available) {
+      blockInput.position = blockInput.chunk->size;
+      return;
+    }
+    InputChunk *chunk = blockInput.chunk;
+    char *data = chunk->data + blockInput.position;
+    blockInput.position += size;
+    if (parseRecord(command, data, size)) {
+      if (command->commandType == GET_ROUTE) {
+        (chunk->users)++;
+        command->chunk = chunk;
+      }
+      return;
+    }
   }
-  return (i < size);
 }
 
-Command readLine() {
-  char *str = NULL;
-  size_t strSize = 0;
-  Command command = initCommand();
+/**@brief Rozpoznaje format wejścia.
+ * Doczytuje wejście tylko tak długo, jak wczytane znaki są początkiem
+ * nagłówka COMMAND_MAGIC, więc nie czeka na dalsze linie wejścia tekstowego.
+ * Jeśli wejście zaczyna się nagłówkiem, pomija go.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool detectBinary(void) {
+  while (true) {
+    size_t available = availableBytes();
+    size_t compared = available < MAGIC_LENGTH ? available : MAGIC_LENGTH;
+    if (compared > 0 &&
+        memcmp(blockInput.chunk->data + blockInput.position, COMMAND_MAGIC,
+               compared) != 0) {
+      return true;
+    }
+    if (compared == MAGIC_LENGTH) {
+      blockInput.position += MAGIC_LENGTH;
+      blockInput.binary = true;
+      return true;
+    }
+    if (blockInput.finished) {
+      return true;
+    }
+    if (!growBlock()) {
+      return false;
+    }
+  }
+}
 
-  if (getline(&str, &strSize, stdin) == -1) {
-    command.commandType = EOF_FOUND;
-    if (str) free(str);
-    return command;
+bool startBlockInput(void) {
+  if (blockInput.active) {
+    return true;
+  }
+  blockInput.chunk = NULL;
+  blockInput.position = 0;
+  blockInput.finished = false;
+  blockInput.binary = false;
+  struct stat status;
+  if (fstat(STDIN_FILENO, &status) == 0 && S_ISREG(status.st_mode) &&
+      status.st_size > 0) {
+    size_t size = (size_t) status.st_size;
+    void *data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                      STDIN_FILENO, 0);
+    if (data != MAP_FAILED) {
+      InputChunk *chunk = malloc(sizeof(InputChunk));
+      if (!chunk) {
+        munmap(data, size);
+        return false;
+      }
+      posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+      chunk->data = data;
+      chunk->size = size;
+      chunk->capacity = size;
+      chunk->users = 1;
+      chunk->mapped = true;
+      off_t offset = lseek(STDIN_FILENO, 0, SEEK_CUR);
+      size_t position = offset > 0 ? (size_t) offset : 0;
+      blockInput.chunk = chunk;
+      blockInput.position = position < size ? position : size;
+      blockInput.finished = true;
+    }
   }
-  command.strBeginning = str;
-  if (!endline(str, strlen(str))) {
-    return command;
+  blockInput.active = true;
+  return detectBinary();
+}
+
+void finishBlockInput(void) {
+  if (blockInput.active && blockInput.chunk) {
+    releaseChunk(blockInput.chunk);
+  }
+  blockInput.chunk = NULL;
+  blockInput.active = false;
+  if (blockInput.spare) {
+    free(blockInput.spare->data);
+    free(blockInput.spare);
+    blockInput.spare = NULL;
+  }
+  free(lineFields.starts);
+  lineFields.starts = NULL;
+  lineFields.capacity = 0;
+  blockInput.binary = false;
+  freeBinaryCities();
+}
+
+bool binaryInput(void) {
+  return blockInput.binary;
+}
+
+bool inputReady(void) {
+  if (!blockInput.active || blockInput.finished) {
+    return blockInput.active;
   }
-  if (str && (strcmp(str, "\n") == 0 || str[0] == '#')) {
-    command.commandType = IGNORE;
-    return command;
+  size_t available = availableBytes();
+  if (available == 0) {
+    return false;
   }
-  size_t size = strlen(str);
-  if (str[size - 2] == ';') {
-    command.commandType = WRONG_COMMAND;
-    return command;
+  const char *data = blockInput.chunk->data + blockInput.position;
+  if (blockInput.binary) {
+    return commandComplete(data, available);
   }
-  editInput(str);
-  command.commandType = identifyCommand(&command, str, size);
-  return command;
+  return memchr(data, '\n', available) != NULL;
 }
 
-/**
- * Funkcja sprawdzająca poprawność wczytanej nazwy miasta.
- * @param cityName - wskaźnik na napis reprezentujący nazwę miasta.
- * @param size - długość napisu.
- * @return Zwraca @p true, jeśli nazwa miasta jest poprawna - nie zawiera znaków
- * o kodach pomiędzy 0 a 31 ani średnika. W przeciwnym wypadku zwraca @p false.
- */
-static bool validCityName(char *cityName, unsigned size) {
-  for (unsigned i = 0; i < size; i++) {
-    if (!cityName) {
-      return false;
+void readLine(Command *command) {
+  resetCommand(command);
+  if (blockInput.active) {
+    if (blockInput.binary) {
+      readBlockRecord(command);
     }
-    if (cityName[i] == ';' || ((int) cityName[i] < 32 && (int) cityName[i] > -1)) {
-      return false;
+    else {
+      readBlockLine(command);
     }
+    return;
+  }
+  ssize_t length = getline(&(command->strBeginning), &(command->strCapacity),
+                           stdin);
+  if (length == -1) {
+    command->commandType = EOF_FOUND;
+    return;
+  }
+  char *str = command->strBeginning;
+  size_t size = (size_t) length;
+  if (str[size - 1] != '\n' || memchr(str, '\0', size)) {
+    return;
+  }
+  str[size - 1] = '\0';
+  parseLine(command, str, size - 1);
+}
+
+bool parseRecord(Command *command, char *data, size_t size) {
+  resetCommand(command);
+  int type = decodeRecord(command, data, size);
+  if (type == BINARY_CITY) {
+    return false;
+  }
+  command->commandType = type;
+  return true;
+}
+
+SegmentCursor routeSegments(const Command *command) {
+  SegmentCursor cursor;
+  cursor.city = noCity;
+  cursor.next = NULL;
+  if (command->binary) {
+    startSegments(&cursor, command->routeFields);
   }
-  if (strcmp(cityName, "") == 0) {
+  else if (command->routeFields) {
+    cursor.city = nameKey(command->routeFields);
+  }
+  cursor.remaining = command->citiesNumber > 0 ?
+                     (unsigned) command->citiesNumber - 1 : 0;
+  return cursor;
+}
+
+bool nextSegment(SegmentCursor *cursor, RouteSegment *segment) {
+  if (cursor->remaining == 0) {
     return false;
   }
+  if (cursor->next) {
+    decodeSegment(cursor, segment);
+    (cursor->remaining)--;
+    return true;
+  }
+  const char *length = cursor->city.name + cursor->city.length + 1;
+  size_t lengthSize = strlen(length);
+  const char *year = length + lengthSize + 1;
+  size_t yearSize = strlen(year);
+  segment->city1 = cursor->city;
+  segment->city2 = nameKey(year + yearSize + 1);
+  segment->length = readUnsigned(length, lengthSize);
+  segment->lastRepair = readInt(year, yearSize);
+  cursor->city = segment->city2;
+  (cursor->remaining)--;
   return true;
 }
 
+/**
+ * Funkcja sprawdzająca poprawność wczytanej nazwy miasta. Znaki o kodach
+ * pomiędzy 1 a 31 są wykrywane już przy dzieleniu linii na pola, a średników
+ * pole nie może zawierać.
+ * @param command - wczytana komenda;
+ * @param cityName - nazwa miasta.
+ * @return Zwraca @p true, jeśli nazwa miasta jest niepusta, a pola komendy nie
+ * zawierają znaków o kodach pomiędzy 1 a 31. W przeciwnym wypadku zwraca
+ * @p false.
+ */
+static bool validCityName(Command command, CityKey cityName) {
+  return !command.invalidBytes && cityName.length > 0;
+}
+
 ///Sprawdza poprawność numeru drogi krajowej.
 static bool validRouteId(unsigned routeId) {
   return (routeId > 0 && routeId <= 999);
@@ -534,49 +994,24 @@ static bool validYear(int year) {
   return (year != 0);
 }
 
-///Zastępuje w napisie znak '\n' znakiem '\0'.
-static void deleteEndline (char *str) {
-  int i = 0;
-  while (str[i] != '\0' && str[i] != '\n') {
-    i++;
-  }
-  if (str[i] == '\n') str[i] = '\0';
-}
-
 bool validCommand (Command command) {
   int type = command.commandType;
   if (type == WRONG_COMMAND) {
     return false;
   }
   if (type == GET_ROUTE) {
-    for (int i = 0; i < command.citiesNumber - 1; i++) {
-      if (!validCityName(command.cities[i], strlen(command.cities[i]))) {
-        return false;
-      }
-      if (!validLength(command.lengthArr[i])) {
-        return false;
-      }
-      if (!validRouteId(command.routeID)) {
-        return false;
-      }
-      if (!validYear(command.lastRepairArr[i])) {
-        return false;
-      }
-      deleteEndline(command.cities[i]);
-    }
+    return !command.invalidBytes && validRouteId(command.routeID);
   }
   if (type == ADD_ROAD || type == REPAIR_ROAD) {
-    if (!validCityName(command.city1, strlen(command.city1))) {
+    if (!validCityName(command, command.city1)) {
       return false;
     }
-    if (!validCityName(command.city2, strlen(command.city2))) {
+    if (!validCityName(command, command.city2)) {
       return false;
     }
     if (!validYear(command.lastRepair)) {
       return false;
     }
-    deleteEndline(command.city1);
-    deleteEndline(command.city2);
   }
   if (type == ADD_ROAD && !validLength(command.length)) {
     return false;
@@ -585,25 +1020,86 @@ bool validCommand (Command command) {
     return false;
   }
   if (type == NEW_ROUTE) {
-    deleteEndline(command.city1);
-    deleteEndline(command.city2);
     return (validRouteId(command.routeID) &&
-    validCityName(command.city1, strlen(command.city1)) &&
-    validCityName(command.city2, strlen(command.city2)));
+    validCityName(command, command.city1) &&
+    validCityName(command, command.city2));
   }
   if (type == EXTEND_ROUTE) {
-    deleteEndline(command.city1);
     return (validRouteId(command.routeID) &&
-    validCityName(command.city1, strlen(command.city1)));
+    validCityName(command, command.city1));
   }
   if (type == REMOVE_ROAD) {
-    deleteEndline(command.city1);
-    deleteEndline(command.city2);
-    return (validCityName(command.city1, strlen(command.city1)) &&
-    validCityName(command.city2, strlen(command.city2)));
+    return (validCityName(command, command.city1) &&
+    validCityName(command, command.city2));
   }
   if (type == REMOVE_ROUTE) {
     return validRouteId(command.routeID);
   }
   return true;
 }
+
+/**
+ * Wypisuje nazwę miasta.
+ * @param city - nazwa miasta i jej długość;
+ * @param file - plik, do którego zostanie wypisana nazwa.
+ */
+static void printCity(CityKey city, FILE *file) {
+  fwrite(city.name, 1, city.length, file);
+}
+
+void printCommand(const Command *command, FILE *file) {
+  int type = command->commandType;
+  if (type == IGNORE) {
+    fputc('\n', file);
+    return;
+  }
+  if (type < 0 || !validCommand(*command)) {
+    fputs(";\n", file);
+    return;
+  }
+  if (type == GET_ROUTE) {
+    SegmentCursor cursor = routeSegments(command);
+    RouteSegment segment;
+    fprintf(file, "%u;", command->routeID);
+    printCity(cursor.city, file);
+    while (nextSegment(&cursor, &segment)) {
+      fprintf(file, ";%u;%d;", segment.length, segment.lastRepair);
+      printCity(segment.city2, file);
+    }
+    fputc('\n', file);
+    return;
+  }
+  const Keyword *keyword = keywords;
+  while (keyword->type != type) {
+    keyword++;
+  }
+  fputs(keyword->text, file);
+  switch (type) {
+    case GET_ROUTE_DESCR:
+    case REMOVE_ROUTE:
+      fprintf(file, ";%u", command->routeID);
+      break;
+    case NEW_ROUTE:
+    case EXTEND_ROUTE:
+      fprintf(file, ";%u", command->routeID);
+      fputc(';', file);
+      printCity(command->city1, file);
+      if (type == NEW_ROUTE) {
+        fputc(';', file);
+        printCity(command->city2, file);
+      }
+      break;
+    default:
+      fputc(';', file);
+      printCity(command->city1, file);
+      fputc(';', file);
+      printCity(command->city2, file);
+      if (type == ADD_ROAD) {
+        fprintf(file, ";%u", command->length);
+      }
+      if (type != REMOVE_ROAD) {
+        fprintf(file, ";%d", command->lastRepair);
+      }
+  }
+  fputc('\n', file);
+}
@@ -9,6 +9,9 @@
 #define DROGI_INPUT_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "structures.h"
 
 #define MEMORY_ERROR -2 ///< Kod oznaczający błąd alokacji pamięci
 #define EOF_FOUND -3 ///< Kod oznaczający koniec pliku
@@ -24,28 +27,144 @@
 #define REMOVE_ROAD 6 ///< Kod oznaczający polecenie removeRoad
 #define REMOVE_ROUTE 7 ///< Kod oznaczający polecenie removeRoute
 
+/**
+ * Struktura przechowująca blok wejścia czytanego blokami.
+ */
+typedef struct InputChunk InputChunk;
+
 /**
  * Struktura przechowująca informacje o wczytanym poleceniu.
  */
 typedef struct Command {
   int commandType; ///< Informacje na temat typu komendy lub ewentualnego błędu
   unsigned routeID; ///< Numer drogi krajowej
-  char **cities; ///< Tablica wskaźników na nazwy miast
-  unsigned *lengthArr; ///<Tablica długości odcików dróg
-  int *lastRepairArr; ///<Tablica dat ostatnich remontów odcinków dróg
+  ///Pierwsze pole z nazwą miasta polecenia getRoute (zob. routeSegments())
+  char *routeFields;
   int lastRepair; ///< Data ostatniego remontu odcinka drogi
   int citiesNumber; ///< Liczba miast w tablicy nazw miast
-  char *city1; ///< Wskaźnik na nazwę pierwszego z miast
-  char *city2; ///< Wskaźnik na nazwę drugiego z miast
+  CityKey city1; ///< Nazwa pierwszego z miast, jej długość i indeks
+  CityKey city2; ///< Nazwa drugiego z miast, jej długość i indeks
   unsigned length; ///< Długość odcinka drogi
   char *strBeginning; ///<Wskaźnik na wczytaną linię wejścia
+  size_t strCapacity; ///< Rozmiar bufora wczytanej linii wejścia
+  InputChunk *chunk; ///< Blok wejścia, na który wskazują napisy polecenia
+  ///Informacja, czy pola poza pierwszym zawierają znaki o kodach od 1 do 31
+  bool invalidBytes;
+  ///Informacja, czy opis drogi krajowej jest zapisany binarnie (zob. binary.h)
+  bool binary;
 } Command;
 
+/**
+ * Struktura pozwalająca przeglądać kolejne odcinki drogi krajowej opisanej
+ * w poleceniu getRoute.
+ */
+typedef struct SegmentCursor {
+  CityKey city; ///< Nazwa miasta, z którego wychodzi następny odcinek.
+  unsigned remaining; ///< Liczba nieprzejrzanych odcinków.
+  const char *next; ///< Zapis binarny następnego odcinka lub NULL.
+} SegmentCursor;
+
+/** @brief Tworzy pustą komendę.
+ * Komendę można następnie wielokrotnie wypełniać funkcjami readLine()
+ * i parseCommand(), które używają ponownie zaalokowanej w niej pamięci.
+ * @param command - wskaźnik na inicjalizowaną strukturę komendy.
+ */
+void initCommand(Command *command);
+
+/** @brief Przełącza wczytywanie poleceń na czytanie blokami.
+ * Jeśli standardowe wejście jest zwykłym plikiem, odwzorowuje go w pamięci,
+ * a w przeciwnym razie czyta wejście blokami po co najmniej 1 MiB. Kolejne
+ * polecenia wskazują na linie w bloku, więc ich wczytanie nie wymaga
+ * alokowania pamięci. Jeśli wejście zaczyna się nagłówkiem COMMAND_MAGIC, jest
+ * dalej czytane jako strumień rekordów opisany w binary.h, a każdy rekord
+ * polecenia odpowiada jednej linii. Należy wywołać przed pierwszym wywołaniem
+ * readLine().
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+bool startBlockInput(void);
+
+/** @brief Kończy czytanie wejścia blokami.
+ * Bloki wejścia są zwalniane razem z ostatnimi wskazującymi na nie
+ * poleceniami. Zwalnia też pamięć używaną przez czytnik do dzielenia linii
+ * i nazwy miast wejścia binarnego, więc należy wywołać po zwolnieniu poleceń.
+ */
+void finishBlockInput(void);
+
+/** @brief Sprawdza, czy wejście jest czytane w formacie binarnym.
+ * @return Zwraca @p true, jeśli startBlockInput() rozpoznała nagłówek
+ * COMMAND_MAGIC. W przeciwnym razie zwraca @p false.
+ */
+bool binaryInput(void);
+
+/** @brief Sprawdza, czy kolejne polecenie jest już wczytane.
+ * @return Zwraca @p true, jeśli wejście jest czytane blokami, a readLine() nie
+ * będzie czekać na dalsze dane wejścia. W przeciwnym razie zwraca @p false.
+ */
+bool inputReady(void);
+
 /** @brief Czyta pojedynczą linię wejścia.
- * @return Zwraca strukturę Command zawierającą informację na temat rodzaju
+ * Linia jest wczytywana funkcją getline do bufora komendy lub, po wywołaniu
+ * startBlockInput(), wskazywana w bloku wejścia. Poprzednia zawartość komendy
+ * jest zastępowana, a jej bufor jest używany ponownie, więc linie nie dłuższe
+ * od wcześniej wczytanych nie wymagają alokowania pamięci. Opis drogi krajowej
+ * w poleceniu getRoute jest sprawdzany w jednym przejściu po linii, bez
+ * zapamiętywania jego pól; jego odcinki można potem przeglądać funkcją
+ * nextSegment().
+ * @param command - wskaźnik na strukturę komendy utworzoną przez
+ * initCommand(), do której zostanie zapisana informacja na temat rodzaju
  * komendy, błędu alokacji pamięci lub innego błędu.
  */
-Command readLine();
+void readLine(Command *command);
+
+/** @brief Rozpoznaje polecenie w linii.
+ * Dzieli linię na pola w jednym przejściu, zastępując znaki ';' znakami '\0',
+ * i wypełnia strukturę komendy wskaźnikami na nie. Nie zwalnia linii.
+ * @param command - wskaźnik na strukturę komendy utworzoną przez
+ * initCommand(), wypełnianą tak jak w readLine();
+ * @param str - wskaźnik na linię bez znaku '\n' i bez znaków '\0',
+ * zakończoną znakiem '\0';
+ * @param size - długość linii.
+ */
+void parseCommand(Command *command, char *str, size_t size);
+
+/** @brief Rozpoznaje polecenie w rekordzie binarnym.
+ * Rekord BINARY_CITY nadaje numer nazwie miasta i nie jest poleceniem.
+ * @param command - wskaźnik na strukturę komendy utworzoną przez
+ * initCommand(), wypełnianą tak jak w readLine();
+ * @param data - wskaźnik na cały rekord;
+ * @param size - długość rekordu.
+ * @return Zwraca @p false, jeśli rekord nadał numer nazwie miasta.
+ * W przeciwnym razie zwraca @p true.
+ */
+bool parseRecord(Command *command, char *data, size_t size);
+
+/** @brief Wypisuje polecenie w postaci linii tekstowej.
+ * Linie pominięte są wypisywane jako puste, a polecenia niepoprawne (zob.
+ * validCommand()) jako linia ";", więc wykonanie wypisanych linii daje ten
+ * sam wynik co wykonanie poleceń.
+ * @param command - wskaźnik na rozpoznane polecenie, różne od EOF_FOUND;
+ * @param file - plik, do którego zostanie wypisana linia.
+ */
+void printCommand(const Command *command, FILE *file);
+
+/** @brief Zaczyna przeglądanie odcinków drogi krajowej.
+ * @param command - wskaźnik na poprawne polecenie getRoute.
+ * @return Zwraca strukturę wskazującą na pierwszy odcinek drogi krajowej.
+ */
+SegmentCursor routeSegments(const Command *command);
+
+/** @brief Odczytuje kolejny odcinek drogi krajowej.
+ * Napisy odcinka wskazują na linię polecenia, więc przeglądanie nie wymaga
+ * alokowania pamięci i można je powtarzać. Indeks nazwy każdego miasta jest
+ * wyznaczany jeden raz podczas przeglądania.
+ * @param cursor - wskaźnik na strukturę utworzoną przez routeSegments();
+ * @param segment - wskaźnik na strukturę, do której zostanie zapisany
+ * odcinek.
+ * @return Zwraca @p false, jeśli wszystkie odcinki zostały już przejrzane.
+ * W przeciwnym razie zwraca @p true.
+ */
+bool nextSegment(SegmentCursor *cursor, RouteSegment *segment);
 
 /** @brief Sprawdza poprawność wczytanej komendy.
  * W zależności od jej rodzaju sprawdza, czy potrzebne do jej wykonania
@@ -57,10 +176,12 @@ Command readLine();
 bool validCommand (Command command);
 
 /** @brief Zwalnia pamięć zaalokowaną w strukturze command.
- * Zwalnia (jeśli zostały zaalokowane) pola: cities, lengthArr, lastRepairArr
- * oraz wskaźnik na wczytaną linię polecenia (str).
- * @param command - wczytana komenda.
+ * Zwalnia (jeśli został zaalokowany) bufor wczytanej linii polecenia
+ * (strBeginning), a także blok wejścia, jeśli nie wskazują na niego inne
+ * polecenia. Komenda staje się z powrotem
+ * pusta.
+ * @param command - wskaźnik na wczytaną komendę.
  */
-void deleteCommand(Command command);
+void deleteCommand(Command *command);
 
 #endif //DROGI_INPUT_H
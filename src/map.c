@@ -7,9 +7,17 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
+#include <stdatomic.h>
 #include "map.h"
 #include "road_hashmap.h"
 #include "dijkstra.h"
+#include "connectivity.h"
+#include "delta_stepping.h"
+#include "route_cache.h"
+#include "tree_cache.h"
+#include "overlay.h"
+#include "scan.h"
 #include "output.h"
 
 /**
@@ -19,6 +27,17 @@ struct Map {
   CityHashMap *allCities; ///< Wskaźnik na hashmapę miast.
   Route **allRoutes; ///< Wskaźnik na tablicę dróg krajowych.
   RoadList *allRoads; ///< Wskaźnik na listę odcinków dróg.
+  Connectivity *components; ///< Wskaźnik na strukturę spójnych składowych.
+  SearchLimits limits; ///< Ograniczenia wyszukiwania dróg krajowych.
+  int searchStatus; ///< Wynik ostatniego wyszukiwania drogi krajowej.
+  ThreadPool *pool; ///< Pula wątków dla wyszukiwań równoległych lub NULL.
+  DeltaStepping *engine; ///< Algorytm wyszukiwań równoległych lub NULL.
+  RouteCache *cache; ///< Pamięć podręczna wyników wyszukiwania.
+  TreeCache *trees; ///< Pamięć podręczna wstrzymanych wyszukiwań.
+  SearchState **states; ///< Stany wyszukiwania dla kolejnych wątków lub NULL.
+  unsigned statesNumber; ///< Liczba stanów wyszukiwania.
+  Overlay *overlay; ///< Nakładka podziału mapy lub NULL, jeśli jest wyłączona.
+  LookupStatistics lookups; ///< Statystyki wyszukań po nazwie.
 };
 
 Map *newMap(void) {
@@ -30,8 +49,29 @@ Map *newMap(void) {
     free(new);
     return NULL;
   }
+  if (!(new->components = newConnectivity())) {
+    freeCityHashMap(new->allCities);
+    free(new);
+    return NULL;
+  }
+  if (!(new->cache = newRouteCache())) {
+    freeConnectivity(new->components);
+    freeCityHashMap(new->allCities);
+    free(new);
+    return NULL;
+  }
+  if (!(new->trees = newTreeCache())) {
+    freeRouteCache(new->cache);
+    freeConnectivity(new->components);
+    freeCityHashMap(new->allCities);
+    free(new);
+    return NULL;
+  }
   new->allRoutes = malloc(ROUTES_NUMBER * sizeof(Route *));
   if (!new->allRoutes) {
+    freeTreeCache(new->trees);
+    freeRouteCache(new->cache);
+    freeConnectivity(new->components);
     freeCityHashMap(new->allCities);
     free(new);
     return NULL;
@@ -40,9 +80,61 @@ Map *newMap(void) {
     new->allRoutes[i] = NULL;
   }
   new->allRoads = NULL;
+  new->limits.maxDistance = 0;
+  new->limits.maxChecked = 0;
+  new->limits.timeLimit = 0;
+  new->searchStatus = ROUTE_FOUND;
+  new->pool = NULL;
+  new->engine = NULL;
+  new->states = NULL;
+  new->statesNumber = 0;
+  new->overlay = NULL;
+  new->lookups.segments = 0;
+  new->lookups.cities = 0;
+  new->lookups.roads = 0;
   return new;
 }
 
+/**
+ * Usuwa stany wyszukiwania utworzone dla wątków.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg.
+ */
+static void freeSearchStates(Map *map) {
+  if (map->states) {
+    for (unsigned i = 0; i < map->statesNumber; i++) {
+      freeSearchState(map->states[i]);
+    }
+    free(map->states);
+  }
+  map->states = NULL;
+  map->statesNumber = 0;
+}
+
+/**@brief Przygotowuje stany wyszukiwania dla wątków.
+ * Tworzy po jednym stanie wyszukiwania dla każdego wątku puli mapy, jeśli nie
+ * zostały utworzone wcześniej.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool prepareSearchStates(Map *map) {
+  unsigned number = threadsNumber(map->pool);
+  if (map->states) {
+    return true;
+  }
+  if (!(map->states = calloc(number, sizeof(SearchState *)))) {
+    return false;
+  }
+  map->statesNumber = number;
+  for (unsigned i = 0; i < number; i++) {
+    if (!(map->states[i] = newSearchState())) {
+      freeSearchStates(map);
+      return false;
+    }
+  }
+  return true;
+}
+
 void deleteMap(Map *map) {
   if (map) {
     if (map->allCities) {
@@ -57,6 +149,13 @@ void deleteMap(Map *map) {
     if (map->allRoads) {
       freeRoads(map->allRoads);
     }
+    freeConnectivity(map->components);
+    freeRouteCache(map->cache);
+    freeTreeCache(map->trees);
+    freeOverlay(map->overlay);
+    freeSearchStates(map);
+    freeDeltaStepping(map->engine);
+    freeThreadPool(map->pool);
     free(map);
   }
 }
@@ -68,22 +167,36 @@ void deleteMap(Map *map) {
  * o kodach pomiędzy 0 a 31 ani średnika. W przeciwnym wypadku zwraca @p false.
  */
 static bool validCityName(const char *cityName) {
-  unsigned length = strlen(cityName);
-  if (strcmp(cityName, "") == 0) {
+  size_t length = strlen(cityName);
+  return length > 0 && plainText(cityName, length);
+}
+
+bool makeCityKey(const char *cityName, CityKey *key) {
+  if (!cityName || !key) {
     return false;
   }
-  for (unsigned i = 0; i < length; i++) {
-    if (((int) (cityName[i]) >= 0 && (int) (cityName[i]) <= 31 &&
-      cityName[i] != '\n') || cityName[i] == ';') {
-      return false;
-    }
-  }
-  if (cityName[length] != '\0') {
+  size_t length = strlen(cityName);
+  if (length == 0 || length > UINT_MAX || !plainText(cityName, length)) {
     return false;
   }
+  key->name = cityName;
+  key->length = (unsigned) length;
+  key->index = cityIndex(cityName, length);
   return true;
 }
 
+/**
+ * Sprawdza, czy dwie nazwy miast są takie same.
+ * @param key1 - wskaźnik na pierwszą nazwę;
+ * @param key2 - wskaźnik na drugą nazwę.
+ * @return Zwraca @p true, jeśli nazwy są takie same. W przeciwnym razie
+ * zwraca @p false.
+ */
+static bool sameCityKey(const CityKey *key1, const CityKey *key2) {
+  return key1->length == key2->length && key1->index == key2->index &&
+         memcmp(key1->name, key2->name, key1->length) == 0;
+}
+
 /**@brief Łączy miasta odcinkiem drogi.
  * Łączy podane miasta znajdujące się w hashmapie odcinkiem drogi. Zakłada
  * poprawność parametrów.
@@ -92,82 +205,142 @@ static bool validCityName(const char *cityName) {
  * @param city2 - wskaźnik na strukturę @p City dla drugiego miasta;
  * @param length - długość odcinka drogi;
  * @param builtYear - rok budowy.
- * @return Zwraca @p false jeśli wystąpił błąd alokacji pamięci lub miasta są
- * już połączone odcinkiem drogi. W przeciwnym wypadku zwraca @p true.
+ * @return Zwraca NULL jeśli wystąpił błąd alokacji pamięci lub miasta są
+ * już połączone odcinkiem drogi. W przeciwnym wypadku zwraca wskaźnik na
+ * utworzony odcinek.
  */
-static bool connectCities(Map *map, City *city1, City *city2, unsigned length,
+static Road *connectCities(Map *map, City *city1, City *city2, unsigned length,
         int builtYear) {
+  if (!reserveJoin(map->components, city1, city2)) {
+    return NULL;
+  }
   Road *road = newRoad(builtYear, length);
   if (!road) {
-    return false;
+    return NULL;
   }
   road->city1 = city1;
   road->city2 = city2;
+  invalidateTrees(map->trees, city1, city2);
+  invalidateOverlay(map->overlay);
   if (!addRoadToHashmap(road, city1->roads) ||
-      !addRoadToHashmap(road, city2->roads)) {
-    return false;
+      !addRoadToHashmap(road, city2->roads) ||
+      !addAdjacentRoad(city1, road) || !addAdjacentRoad(city2, road)) {
+    invalidateComponents(map->components);
+    return NULL;
+  }
+  invalidateMap(map->cache);
+  if (!addToRoadList(road, &(map->allRoads))) {
+    invalidateComponents(map->components);
+    return NULL;
   }
-  return addToRoadList(road, &(map->allRoads));
+  joinComponents(map->components, city1, city2);
+  return road;
+}
+
+/**
+ * Wyszukuje miasto po nazwie, zliczając wyszukanie.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param key - wskaźnik na sprawdzoną nazwę miasta.
+ * @return Zwraca wskaźnik na miasto lub NULL, jeśli go nie ma.
+ */
+static City *lookupCity(Map *map, const CityKey *key) {
+  (map->lookups.cities)++;
+  return findCityAt(key->name, key->index, map->allCities);
 }
 
 /**
- * Sprawdza, czy w mapie istnieje odcinek drogi między dwoma miastami.
- * @param map - wskaźnik na struktruę przechowującą mapę dróg;
- * @param cityName1 - wskaźnik na napis reprezentujący nazwę pierwszego miasta;
- * @param cityName2 - wskaźnik na napis reprezentujący nazwę drugiego miasta.
- * @return Zwraca @p true, jeśli odcinek między podanymi miastami znajduje się
- * na mapie. W przeciwnym razie zwraca @p false.
+ * Dodaje miasto do hashmapy miast, jeśli go w niej nie ma, zliczając
+ * wyszukanie.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param key - wskaźnik na sprawdzoną nazwę miasta.
+ * @return Zwraca wskaźnik na miasto lub NULL, jeśli nie udało się zaalokować
+ * pamięci.
  */
-static bool isRoad(Map *map, const char *cityName1, const char *cityName2) {
-  City *city1 = findCity(cityName1, map->allCities);
-  City *city2 = findCity(cityName2, map->allCities);
+static City *insertCity(Map *map, const CityKey *key) {
+  (map->lookups.cities)++;
+  return addCityAt(key->name, key->index, map->allCities);
+}
 
-  if (!city1 || !city2) {
-    return false;
-  }
-  return findRoad(cityName1, city2->roads);
+/**
+ * Wyszukuje odcinek drogi wychodzący z miasta po nazwie drugiego końca,
+ * zliczając wyszukanie.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param city - wskaźnik na miasto;
+ * @param key - wskaźnik na sprawdzoną nazwę drugiego końca.
+ * @return Zwraca wskaźnik na odcinek drogi lub NULL, jeśli go nie ma.
+ */
+static Road *lookupRoad(Map *map, City *city, const CityKey *key) {
+  (map->lookups.roads)++;
+  return findRoadAt(key->name, key->index, city->roads);
 }
 
-bool addRoad(Map *map, const char *city1, const char *city2,
-             unsigned length, int builtYear) {
-  if (strcmp(city1, city2) == 0 ||
-      (!validCityName(city1) || !validCityName(city2)) ||
+bool addRoadByKeys(Map *map, const CityKey *city1, const CityKey *city2,
+                   unsigned length, int builtYear) {
+  if (!map || !city1 || !city2 || sameCityKey(city1, city2) ||
       builtYear == 0 || length == 0) {
     return false;
   }
 
-  if (isRoad(map, city1, city2)) {
+  City *firstCity = insertCity(map, city1);
+  if (!firstCity || lookupRoad(map, firstCity, city2)) {
     return false;
   }
-
-  City *firstCity = addCity(city1, map->allCities);
-  City *secondCity = addCity(city2, map->allCities);
-  if (!firstCity || !secondCity) {
+  City *secondCity = insertCity(map, city2);
+  if (!secondCity) {
     return false;
   }
-  return connectCities(map, firstCity, secondCity, length, builtYear);
+  return connectCities(map, firstCity, secondCity, length, builtYear) != NULL;
 }
 
-bool repairRoad(Map *map, const char *city1, const char *city2, int repairYear) {
-  if (!map || !validCityName(city1) || !validCityName(city2) ||
-      repairYear == 0) {
+bool addRoad(Map *map, const char *city1, const char *city2,
+             unsigned length, int builtYear) {
+  CityKey key1, key2;
+  return makeCityKey(city1, &key1) && makeCityKey(city2, &key2) &&
+         addRoadByKeys(map, &key1, &key2, length, builtYear);
+}
+
+/**
+ * Zmienia datę ostatniego remontu odcinka drogi i unieważnia zależne od niej
+ * wyniki wyszukiwań.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param road - wskaźnik na odcinek drogi;
+ * @param repairYear - nowa data remontu, nie wcześniejsza niż dotychczasowa.
+ */
+static void renewRoad(Map *map, Road *road, int repairYear) {
+  if (road->lastRepair != repairYear) {
+    invalidateTrees(map->trees, road->city1, road->city2);
+    road->lastRepair = repairYear;
+    invalidateMap(map->cache);
+    overlayRoadChanged(map->overlay, road->city1, road->city2);
+  }
+}
+
+bool repairRoadByKeys(Map *map, const CityKey *city1, const CityKey *city2,
+                      int repairYear) {
+  if (!map || !city1 || !city2 || repairYear == 0) {
     return false;
   }
-  City *first = findCity(city1, map->allCities);
+  City *first = lookupCity(map, city1);
   if (!first) {
     return false;
   }
-  Road *road = findRoad(city2, first->roads);
+  Road *road = lookupRoad(map, first, city2);
   if (!road) {
     return NULL;
   }
   if (road->lastRepair > repairYear) {
     return false;
   }
-  road->lastRepair = repairYear;
+  renewRoad(map, road, repairYear);
   return true;
 }
 
+bool repairRoad(Map *map, const char *city1, const char *city2, int repairYear) {
+  CityKey key1, key2;
+  return makeCityKey(city1, &key1) && makeCityKey(city2, &key2) &&
+         repairRoadByKeys(map, &key1, &key2, repairYear);
+}
+
 /**
  * Sprawdza poprawność numeru drogi krajowej.
  * @param id - numer drogi krajowej
@@ -181,145 +354,510 @@ static bool validRouteId(unsigned id) {
   return true;
 }
 
-bool newRoute(Map *map, unsigned routeId,
-              const char *city1, const char *city2) {
-  if (!validRouteId(routeId) || !map || !validCityName(city1) ||
-      !validCityName(city2)) {
-    return false;
+///Wynik wyszukiwania, który nie zmienia pola searchStatus mapy.
+#define STATUS_UNCHANGED -1
+
+/**
+ * Struktura przechowująca stan polecenia utworzenia lub wydłużenia drogi
+ * krajowej pomiędzy sprawdzeniem parametrów, wyszukiwaniem i zmianą mapy.
+ */
+typedef struct RouteSearch {
+  bool extend; ///< Informacja, czy droga krajowa jest wydłużana.
+  unsigned routeId; ///< Numer drogi krajowej.
+  City *start; ///< Miasto początkowe wyszukiwania.
+  City *otherStart; ///< Drugie miasto początkowe wyszukiwania lub NULL.
+  City *finish; ///< Miasto końcowe wyszukiwania.
+  unsigned forbiddenId; ///< Numer drogi krajowej, której miasta są zabronione.
+  bool needsSearch; ///< Informacja, czy wyszukiwanie trzeba przeprowadzić.
+  int tree; ///< Zarezerwowane wyszukiwanie z pamięci wyszukiwań lub NO_TREE.
+  RoadList *roadList; ///< Wyznaczona lista odcinków dróg lub NULL.
+  int status; ///< Wynik wyszukiwania lub STATUS_UNCHANGED.
+} RouteSearch;
+
+/**@brief Sprawdza parametry polecenia i szuka wyniku w pamięci podręcznej.
+ * Sprawdza parametry tak jak funkcje @ref newRoute i @ref extendRoute. Jeśli
+ * są poprawne, a wyniku nie ma w pamięci podręcznej, zaznacza, że trzeba
+ * przeprowadzić wyszukiwanie. Nie zmienia mapy.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param request - polecenie;
+ * @param search - wskaźnik na strukturę, do której zostanie zapisany stan
+ * polecenia.
+ */
+static void prepareRouteSearch(Map *map, const RouteRequest *request,
+                               RouteSearch *search) {
+  unsigned routeId = request->routeId;
+  search->extend = request->extend;
+  search->routeId = routeId;
+  search->needsSearch = false;
+  search->tree = NO_TREE;
+  search->otherStart = NULL;
+  search->roadList = NULL;
+  search->status = STATUS_UNCHANGED;
+  if (!request->extend) {
+    if (!validRouteId(routeId)) {
+      return;
+    }
+    search->status = SEARCH_ERROR;
+    if (map->allRoutes[routeId]) {
+      return;
+    }
+    search->start = lookupCity(map, &(request->city1));
+    search->finish = lookupCity(map, &(request->city2));
+    search->forbiddenId = 0;
+    if (!search->start || !search->finish ||
+        isEqual(search->start, search->finish)) {
+      return;
+    }
   }
-  if (map->allRoutes[routeId]) {
-    return false;
+  else {
+    if (!validRouteId(routeId) || !(map->allRoutes[routeId])) {
+      return;
+    }
+    search->status = SEARCH_ERROR;
+    search->start = map->allRoutes[routeId]->city2;
+    search->otherStart = map->allRoutes[routeId]->city1;
+    search->finish = lookupCity(map, &(request->city1));
+    search->forbiddenId = routeId;
+    if (!search->finish || search->finish->routesPassing[routeId]) {
+      return;
+    }
   }
-  City *firstCity = findCity(city1, map->allCities);
-  City *secondCity = findCity(city2, map->allCities);
-  if (!firstCity || !secondCity || city1 == city2) {
-    return false;
+  if (!sameComponent(map->components, search->start, search->finish)) {
+    search->status = ROUTE_NOT_FOUND;
+    return;
   }
-  RoadList *roadList = findBestRoute(firstCity, secondCity, map->allCities, 0,
-          NULL);
-  if (!roadList) {
-    return false;
+  search->needsSearch = !findCachedRoute(map->cache, search->start,
+          search->finish, search->forbiddenId, NULL, &(search->roadList),
+          &(search->status));
+}
+
+/**
+ * Sprawdza, czy wyszukiwanie dla polecenia może korzystać z pamięci
+ * wstrzymanych wyszukiwań, czyli czy jest to wyszukiwanie z jednego miasta,
+ * bez zabronionej drogi krajowej i bez ograniczeń.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param search - wskaźnik na stan polecenia.
+ * @return Zwraca @p true, jeśli wyszukiwanie może korzystać z pamięci.
+ * W przeciwnym razie zwraca @p false.
+ */
+static bool usesTreeCache(Map *map, RouteSearch *search) {
+  return !search->otherStart && search->forbiddenId == 0 &&
+         map->limits.maxDistance == 0 && map->limits.maxChecked == 0 &&
+         map->limits.timeLimit == 0;
+}
+
+/**@brief Przeprowadza wyszukiwanie dla polecenia.
+ * Przy wydłużaniu drogi krajowej jedno wyszukiwanie rozpoczyna się
+ * jednocześnie w obu jej końcach. Wyszukiwania bez ograniczeń przy tworzeniu
+ * drogi krajowej, wykonywane na wspólnym stanie, wznawiają wstrzymane
+ * wyszukiwanie z tego samego miasta. Korzysta tylko z odcinków dróg i miast
+ * drogi krajowej o zabronionym numerze, więc dla poleceń o różnych numerach
+ * może być wywoływana równolegle na różnych stanach wyszukiwania.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param state - stan wyszukiwania lub NULL dla wspólnego stanu;
+ * @param search - wskaźnik na stan polecenia.
+ */
+static void runRouteSearch(Map *map, SearchState *state, RouteSearch *search) {
+  if (!state && usesTreeCache(map, search)) {
+    search->roadList = findTreeRoute(map->trees, search->start, search->finish,
+            map->allCities, &(search->status));
+    return;
   }
-  Route *route = createRoute(roadList, firstCity, secondCity, routeId);
-  if (!route) {
+  City *starts[2] = {search->start, search->otherStart};
+  Route *forbiddenRoute = search->forbiddenId ?
+          map->allRoutes[search->forbiddenId] : NULL;
+  search->roadList = findBestRouteFromAny(state, starts,
+          search->otherStart ? 2 : 1, search->finish, map->allCities,
+          forbiddenRoute, NULL, &(map->limits), &(search->status));
+}
+
+/**
+ * Sprawdza, czy wyznaczony fragment zaczyna się w początku drogi krajowej.
+ * Pierwszy odcinek fragmentu łączy koniec drogi krajowej z miastem spoza niej,
+ * więc nie może dotykać obu jej końców.
+ * @param route - wskaźnik na drogę krajową;
+ * @param roadList - lista odcinków dróg od jednego z końców drogi krajowej.
+ * @return Zwraca @p true, jeśli fragment zaczyna się w mieście @p city1 drogi
+ * krajowej. W przeciwnym razie zwraca @p false.
+ */
+static bool startsAtFirstCity(Route *route, RoadList *roadList) {
+  return isEqual(roadList->road->city1, route->city1) ||
+         isEqual(roadList->road->city2, route->city1);
+}
+
+/**@brief Kończy wykonywanie polecenia.
+ * Zapisuje wynik wyszukiwania w pamięci podręcznej, o ile nie zależy on od
+ * ograniczeń wyszukiwania, a następnie tworzy lub wydłuża drogę krajową.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param search - wskaźnik na stan polecenia.
+ * @return Zwraca wynik polecenia, taki jak funkcje @ref newRoute
+ * i @ref extendRoute.
+ */
+static bool commitRouteSearch(Map *map, RouteSearch *search) {
+  if (search->status != STATUS_UNCHANGED) {
+    map->searchStatus = search->status;
+  }
+  if (search->needsSearch && (search->status == ROUTE_FOUND ||
+      search->status == ROUTE_NOT_FOUND || search->status == ROUTE_AMBIGUOUS)) {
+    storeRoute(map->cache, search->start, search->finish, search->forbiddenId,
+               NULL, search->roadList, search->status);
+  }
+  if (!search->roadList) {
     return false;
   }
-  map->allRoutes[routeId] = route;
+  if (!search->extend) {
+    Route *route = createRoute(search->roadList, search->start, search->finish,
+            search->routeId);
+    if (!route) {
+      return false;
+    }
+    map->allRoutes[search->routeId] = route;
+  }
+  else if (startsAtFirstCity(map->allRoutes[search->routeId],
+                             search->roadList)) {
+    modifyRouteStart(search->roadList, search->finish,
+                     map->allRoutes[search->routeId]);
+  }
+  else {
+    modifyRoute(search->roadList, search->finish,
+                map->allRoutes[search->routeId]);
+  }
+  invalidateRoute(map->cache, search->routeId);
   return true;
 }
 
-bool extendRoute(Map *map, unsigned routeId, const char *city) {
-  if (!map || !validRouteId(routeId) || !validCityName(city) ||
-      !(map->allRoutes[routeId])) {
+/**@brief Wykonuje pojedyncze polecenie.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param request - polecenie.
+ * @return Zwraca wynik polecenia.
+ */
+static bool executeRouteRequest(Map *map, const RouteRequest *request) {
+  RouteSearch search;
+  prepareRouteSearch(map, request, &search);
+  if (search.needsSearch) {
+    runRouteSearch(map, NULL, &search);
+  }
+  return commitRouteSearch(map, &search);
+}
+
+bool newRouteByKeys(Map *map, unsigned routeId, const CityKey *city1,
+                    const CityKey *city2) {
+  if (!map || !city1 || !city2) {
     return false;
   }
+  RouteRequest request = {false, routeId, *city1, *city2};
+  return executeRouteRequest(map, &request);
+}
+
+bool newRoute(Map *map, unsigned routeId,
+              const char *city1, const char *city2) {
+  CityKey key1, key2;
+  return makeCityKey(city1, &key1) && makeCityKey(city2, &key2) &&
+         newRouteByKeys(map, routeId, &key1, &key2);
+}
 
-  City *newEnd = findCity(city, map->allCities);
-  if (!newEnd || newEnd->routesPassing[routeId]) {
+bool extendRouteByKey(Map *map, unsigned routeId, const CityKey *city) {
+  if (!map || !city) {
     return false;
   }
-  RoadList *roadList = findBestRoute(map->allRoutes[routeId]->city2, newEnd,
-          map->allCities, routeId, NULL);
-  if (!roadList) {
+  RouteRequest request = {true, routeId, *city, *city};
+  return executeRouteRequest(map, &request);
+}
+
+bool extendRoute(Map *map, unsigned routeId, const char *city) {
+  CityKey key;
+  return makeCityKey(city, &key) && extendRouteByKey(map, routeId, &key);
+}
+
+/**
+ * Dane zadania wykonującego równolegle wyszukiwania poleceń zbiorczych.
+ */
+typedef struct BatchSearches {
+  Map *map; ///< Wskaźnik na strukturę przechowującą mapę dróg.
+  RouteSearch *searches; ///< Tablica stanów poleceń.
+  unsigned number; ///< Liczba poleceń.
+  atomic_uint next; ///< Numer następnego polecenia do sprawdzenia.
+} BatchSearches;
+
+/**
+ * Zadanie wątku: pobiera kolejne polecenia i przeprowadza dla nich
+ * wyszukiwania na własnym stanie wyszukiwania.
+ * @param thread - numer wątku;
+ * @param threads - liczba wątków;
+ * @param data - wskaźnik na strukturę BatchSearches.
+ */
+static void batchSearchTask(unsigned thread, unsigned threads, void *data) {
+  (void) threads;
+  BatchSearches *batch = data;
+  SearchState *state = batch->map->states[thread];
+  unsigned i;
+  while ((i = atomic_fetch_add(&(batch->next), 1)) < batch->number) {
+    RouteSearch *search = &(batch->searches[i]);
+    if (search->tree != NO_TREE) {
+      search->roadList = findClaimedRoute(batch->map->trees, search->tree,
+              search->finish, batch->map->allCities, &(search->status));
+    }
+    else if (search->needsSearch) {
+      runRouteSearch(batch->map, state, search);
+    }
+  }
+}
+
+bool executeRouteRequests(Map *map, const RouteRequest *requests,
+                          unsigned number, bool *results) {
+  if (!map || !requests || !results) {
     return false;
   }
-  modifyRoute(roadList, newEnd, map->allRoutes[routeId]);
+  RouteSearch *searches = malloc((number > 0 ? number : 1) *
+                                 sizeof(RouteSearch));
+  if (!searches || !prepareSearchStates(map)) {
+    free(searches);
+    for (unsigned i = 0; i < number; i++) {
+      results[i] = executeRouteRequest(map, &(requests[i]));
+    }
+    return true;
+  }
+  unsigned lastWave[ROUTES_NUMBER] = {0};
+  unsigned wave = 0;
+  unsigned begin = 0;
+  while (begin < number) {
+    wave++;
+    unsigned end = begin;
+    while (end < number) {
+      unsigned routeId = requests[end].routeId;
+      if (validRouteId(routeId)) {
+        if (lastWave[routeId] == wave) {
+          break;
+        }
+        lastWave[routeId] = wave;
+      }
+      end++;
+    }
+    for (unsigned i = begin; i < end; i++) {
+      RouteSearch *search = &(searches[i]);
+      prepareRouteSearch(map, &(requests[i]), search);
+      if (search->needsSearch && usesTreeCache(map, search)) {
+        search->tree = claimTree(map->trees, search->start, map->allCities);
+      }
+    }
+    BatchSearches batch;
+    batch.map = map;
+    batch.searches = searches + begin;
+    batch.number = end - begin;
+    atomic_init(&(batch.next), 0);
+    runParallel(map->pool, batchSearchTask, &batch);
+    releaseTrees(map->trees);
+    for (unsigned i = begin; i < end; i++) {
+      results[i] = commitRouteSearch(map, &(searches[i]));
+    }
+    begin = end;
+  }
+  free(searches);
   return true;
 }
 
-/**Uzupełnia lukę w drodze krajowej.
- * Zastępuje w drodze krajowej wskazany odcinek drogi w najkrótszy możliwy
- * sposób, w drugiej kolejnośći biorąc pod uwagę datę remontu najdawniej
- * odnawianego odcinka drogi (analogicznie do funkcji newRoute()).
- * @param map - wskaźnik na mapę dróg;
+/**
+ * Sprawdza, w którą stronę droga krajowa przechodzi przez podany odcinek drogi.
+ * @param route - wskaźnik na drogę krajową;
+ * @param brake - wskaźnik na odcinek drogi należący do drogi krajowej.
+ * @return Zwraca @p true, jeśli droga krajowa wchodzi na odcinek drogi przez
+ * jego pierwsze miasto. W przeciwnym razie zwraca @p false.
+ */
+static bool entersByFirstCity(Route *route, Road *brake) {
+  RoadList *temp = route->roads;
+  if (temp->road == brake) {
+    return isEqual(brake->city1, route->city1);
+  }
+  while (temp->next && temp->next->road != brake) {
+    temp = temp->next;
+  }
+  return isEqual(temp->road->city1, brake->city1) ||
+         isEqual(temp->road->city2, brake->city1);
+}
+
+/**
+ * Zastępuje w drodze krajowej podany odcinek drogi listą odcinków łączących
+ * jego końce i oznacza, że droga krajowa przez nie przechodzi.
  * @param route - wskaźnik na modyfikowaną drogę krajową;
- * @param brake - wskaźnik na odcinek drogi, przez który droga krajowa ma nie
+ * @param brake - wskaźnik na zastępowany odcinek drogi;
+ * @param patch - lista odcinków dróg ułożona w kierunku drogi krajowej.
+ */
+static void splicePatch(Route *route, Road *brake, RoadList *patch) {
+  Pair pair = lengthAndOldestRoad(patch, route->rotueID, route);
+  route->length += pair.value1 - brake->length;
+  if (pair.value2 < route->oldestRoad) {
+    route->oldestRoad = pair.value2;
+  }
+  RoadList **place = &(route->roads);
+  while ((*place)->road != brake) {
+    place = &((*place)->next);
+  }
+  RoadList *removed = *place;
+  findEnd(patch)->next = removed->next;
+  *place = patch;
+  free(removed);
+}
+
+/**
+ * Dane zadania wyznaczającego równolegle nowe przebiegi dróg krajowych
+ * omijające usuwany odcinek drogi.
+ */
+typedef struct PatchSearches {
+  Map *map; ///< Wskaźnik na strukturę przechowującą mapę dróg.
+  Road *brake; ///< Usuwany odcinek drogi.
+  Route **routes; ///< Tablica naprawianych dróg krajowych.
+  RoadList **patches; ///< Tablica wyznaczonych przebiegów.
+  bool *pending; ///< Tablica dróg krajowych wymagających osobnego wyszukiwania.
+  unsigned number; ///< Liczba naprawianych dróg krajowych.
+  ///Liczba dróg krajowych przechodzących przez odcinek od jego pierwszego miasta.
+  unsigned forward;
+  atomic_uint next; ///< Numer następnej drogi krajowej do sprawdzenia.
+  atomic_bool failed; ///< Informacja, czy wystąpił błąd alokacji pamięci.
+} PatchSearches;
+
+/**
+ * Zadanie wątku: najpierw wspólne wyszukiwania dla obu kierunków przejścia
+ * przez odcinek, a po ich zakończeniu kolejne osobne wyszukiwania. Mapa nie
+ * jest w tym czasie zmieniana.
+ * @param thread - numer wątku;
+ * @param threads - liczba wątków;
+ * @param data - wskaźnik na strukturę PatchSearches.
+ */
+static void patchSearchTask(unsigned thread, unsigned threads, void *data) {
+  PatchSearches *batch = data;
+  SearchState *state = batch->map->states[thread];
+  Road *brake = batch->brake;
+  CityHashMap *cities = batch->map->allCities;
+  unsigned forward = batch->forward;
+  for (unsigned direction = thread; direction < 2; direction += threads) {
+    bool success = (direction == 0) ?
+            findBestRoutes(state, brake->city1, brake->city2, cities, brake,
+                    batch->routes, forward, batch->patches, batch->pending) :
+            findBestRoutes(state, brake->city2, brake->city1, cities, brake,
+                    batch->routes + forward, batch->number - forward,
+                    batch->patches + forward, batch->pending + forward);
+    if (!success) {
+      atomic_store(&(batch->failed), true);
+    }
+  }
+  waitForThreads(batch->map->pool);
+  if (atomic_load(&(batch->failed))) {
+    return;
+  }
+  unsigned i;
+  while ((i = atomic_fetch_add(&(batch->next), 1)) < batch->number) {
+    if (batch->pending[i]) {
+      int status;
+      City *start = (i < forward) ? brake->city1 : brake->city2;
+      City *finish = (i < forward) ? brake->city2 : brake->city1;
+      batch->patches[i] = findBestRouteWith(state, start, finish, cities,
+              batch->routes[i], brake, NULL, &status);
+      if (status == SEARCH_ERROR) {
+        atomic_store(&(batch->failed), true);
+      }
+    }
+  }
+}
+
+/**@brief Uzupełnia luki we wszystkich drogach krajowych.
+ * Dla każdej drogi krajowej przechodzącej przez wskazany odcinek drogi
+ * wyznacza zastępczy przebieg omijający ten odcinek w najkrótszy możliwy
+ * sposób, w drugiej kolejności biorąc pod uwagę datę remontu najdawniej
+ * odnawianego odcinka drogi (analogicznie do funkcji newRoute()). Drogi
+ * krajowe są grupowane według kierunku, w którym przechodzą przez odcinek,
+ * a każda grupa korzysta ze wspólnego wyszukiwania. Wyszukiwania są
+ * wykonywane równolegle na wątkach mapy, a drogi krajowe są modyfikowane
+ * dopiero po zakończeniu wszystkich wyszukiwań. Drogi krajowe są
+ * modyfikowane tylko wtedy, gdy udało się wyznaczyć wszystkie przebiegi.
+ * @param map - wskaźnik na mapę dróg;
+ * @param brake - wskaźnik na odcinek drogi, przez który drogi krajowe mają nie
  * przebiegać.
  * @return Zwraca @p false, jeśli wystąpił błąd alokacji pamięci lub jeśli nie
- * można jednoznacznie wyznaczyć nowego przebiegu drogi krajowej. W przeciwnym
- * wypadku zwraca @p true.
+ * można jednoznacznie wyznaczyć nowego przebiegu którejś drogi krajowej. Wtedy
+ * mapa pozostaje niezmieniona. W przeciwnym wypadku zwraca @p true.
  */
-static bool patchRoute(Map *map, Route *route, Road *brake) {
-  RoadList *patch = NULL;
-  brake->city1->routesPassing[route->rotueID] = false;
-  brake->city2->routesPassing[route->rotueID] = false;
-  RoadList *temp = route->roads;
-  City *firstCity = brake->city2;
-  City *secondCity = brake->city1;
-  if (temp->road == brake) {
-    if (isEqual(brake->city1, route->city1)) {
-      firstCity = brake->city1;
-      secondCity = brake->city2;
-    }
-    if (!(patch = findBestRoute(firstCity, secondCity, map->allCities,
-                                route->rotueID, brake))) {
-      brake->city1->routesPassing[route->rotueID] = true;
-      brake->city2->routesPassing[route->rotueID] = true;
-      return false;
+static bool patchRoutes(Map *map, Road *brake) {
+  if (!prepareSearchStates(map)) {
+    return false;
+  }
+  unsigned number = 0;
+  for (RouteList *temp = brake->routes; temp; temp = temp->next) {
+    number++;
+  }
+  if (number == 0) {
+    return true;
+  }
+  Route **routes = malloc(number * sizeof(Route *));
+  RoadList **patches = calloc(number, sizeof(RoadList *));
+  bool *pending = malloc(number * sizeof(bool));
+  if (!routes || !patches || !pending) {
+    free(routes);
+    free(patches);
+    free(pending);
+    return false;
+  }
+  unsigned forward = 0;
+  unsigned backward = number;
+  for (RouteList *temp = brake->routes; temp; temp = temp->next) {
+    if (entersByFirstCity(temp->route, brake)) {
+      routes[forward++] = temp->route;
     }
-    route->roads = patch;
-    RoadList *end = findEnd(patch);
-    end->next = temp->next;
-    route->city1 = firstCity;
-    if (!(temp->next)) {
-      route->city2 = secondCity;
+    else {
+      routes[--backward] = temp->route;
     }
-    free(temp);
   }
-  else {
-    while (temp && temp->next && temp->next->road != brake) {
-      temp = temp->next;
-    }
-    if (isEqual(temp->road->city1, brake->city1) ||
-        isEqual(temp->road->city2, brake->city1)) {
-      firstCity = brake->city1;
-      secondCity = brake->city2;
-    }
-    if (!(patch = findBestRoute(firstCity, secondCity, map->allCities,
-                                route->rotueID, brake))) {
-      brake->city1->routesPassing[route->rotueID] = true;
-      brake->city2->routesPassing[route->rotueID] = true;
-      return false;
+  PatchSearches batch;
+  batch.map = map;
+  batch.brake = brake;
+  batch.routes = routes;
+  batch.patches = patches;
+  batch.pending = pending;
+  batch.number = number;
+  batch.forward = forward;
+  atomic_init(&(batch.next), 0);
+  atomic_init(&(batch.failed), false);
+  runParallel(map->pool, patchSearchTask, &batch);
+  bool success = !atomic_load(&(batch.failed));
+  for (unsigned i = 0; i < number; i++) {
+    success = success && patches[i];
+  }
+  for (unsigned i = 0; i < number; i++) {
+    if (success) {
+      splicePatch(routes[i], brake, patches[i]);
+      invalidateRoute(map->cache, routes[i]->rotueID);
     }
-    if (!(temp->next->next)) {
-      route->city2 = secondCity;
+    else {
+      freeRoadList(patches[i]);
     }
-    RoadList *temp2 = temp->next;
-    temp->next = patch;
-    RoadList *end = findEnd(patch);
-    end->next = temp2->next;
-    free(temp2);
   }
-  brake->city1->routesPassing[route->rotueID] = true;
-  brake->city2->routesPassing[route->rotueID] = true;
-  Pair pair = lengthAndOldestRoad(patch, route->rotueID, route);
-  (route->length) += pair.value1;
-  route->oldestRoad += pair.value2;
-  return true;
+  free(routes);
+  free(patches);
+  free(pending);
+  return success;
 }
 
-bool removeRoad(Map *map, const char *city1, const char *city2) {
-  if (!map || !validCityName(city1) || !validCityName(city2)) {
+bool removeRoadByKeys(Map *map, const CityKey *city1, const CityKey *city2) {
+  if (!map || !city1 || !city2) {
     return false;
   }
 
-  City *firstCity = findCity(city1, map->allCities);
-  City *secondCity = findCity(city2, map->allCities);
-  if (!firstCity || !secondCity) {
+  City *firstCity = lookupCity(map, city1);
+  if (!firstCity) {
     return false;
   }
 
-  Road *road = findRoad(city1, secondCity->roads);
+  Road *road = lookupRoad(map, firstCity, city2);
   if (!road) {
     return false;
   }
 
-  RouteList *temp1 = road->routes;
-  while (temp1) {
-    if (!(patchRoute(map, temp1->route, road))) {
-      return false;
-    }
-    temp1 = temp1->next;
+  bool checked = road->routes != NULL;
+  if (checked && checkRemoval(map->components, road) != CONNECTED) {
+    return false;
+  }
+
+  if (!patchRoutes(map, road)) {
+    return false;
   }
 
   if (!cutRoad(map->allRoads, road)) {
@@ -329,10 +867,22 @@ bool removeRoad(Map *map, const char *city1, const char *city2) {
       free(temp2);
     }
   }
+  invalidateTrees(map->trees, road->city1, road->city2);
+  overlayRoadChanged(map->overlay, road->city1, road->city2);
   deleteRoad(road);
+  invalidateMap(map->cache);
+  if (!checked) {
+    invalidateComponents(map->components);
+  }
   return true;
 }
 
+bool removeRoad(Map *map, const char *city1, const char *city2) {
+  CityKey key1, key2;
+  return makeCityKey(city1, &key1) && makeCityKey(city2, &key2) &&
+         removeRoadByKeys(map, &key1, &key2);
+}
+
 char const* getRouteDescription(Map *map, unsigned routeId) {
   if (!map || !validRouteId(routeId)) {
     return NULL;
@@ -341,105 +891,150 @@ char const* getRouteDescription(Map *map, unsigned routeId) {
   return getRouteDescriptionOut(map->allRoutes[routeId], routeId);
 }
 
-/**
- * Sprawdza, czy dla talblicy miast istnieją odcinki dróg między kolejnymi
- * miastami i czy nie konfliktują z podanymi długościami i datami napraw.
- * @param map - wskaźnik na strukturę przechowującą mapę dróg;
- * @param cities - tablica napisów reprezentujących nazwy kolejnych miast;
- * @param lengths - tablica długości kolejnych odcinków dróg;
- * @param lastRepairs - tablica dat remontów kolejnych odcinków dróg;
- * @param citiesNumber - długość tablicy miast.
- * @return Zwraca @p false jeśli w tablicy nazw miast istnieją takie dwa pod
- * indeksami "i", "i + 1", że w mapie dróg istnieje odcinek drogi między
- * miastami o tych nazwach i długość tego odcinka jest różna od wartości pod
- * i - tym indeksem w tablicy długości lub jego rok ostatniego remontu jest
- * późniejszy niż i - ty rok w tablicy remontów.
- */
-static bool checkRoads(Map *map, char **cities, unsigned *lengths,
-        int *lastRepairs, int citiesNumber) {
-  for (int i = 0; i < citiesNumber - 1; i++) {
-    City *city1 = findCity(cities[i], map->allCities);
-    if (city1) {
-      Road *road = findRoad(cities[i + 1], city1->roads);
-      if (road && (road->length != lengths[i] ||
-         road->lastRepair > lastRepairs[i])) {
-        return false;
-      }
-    }
+char const *getRouteDescriptionInto(Map *map, unsigned routeId, char **buffer,
+                                    size_t *capacity) {
+  if (!map || !buffer || !capacity || !validRouteId(routeId) ||
+      !describeRoute(map->allRoutes[routeId], routeId, buffer, capacity)) {
+    return NULL;
   }
+  return *buffer;
+}
 
+bool startRoute(Map *map, unsigned routeId, RouteBuilder *builder) {
+  if (!map || !builder || !validRouteId(routeId) || map->allRoutes[routeId]) {
+    return false;
+  }
+  builder->routeId = routeId;
+  builder->roads = NULL;
+  builder->first = NULL;
+  builder->last = NULL;
+  builder->checked = 0;
+  builder->checkedEnd = NULL;
   return true;
 }
 
 /**
- * Tworzy z tablic miast, długości i dat remontów listę odcinków dróg. Jeśli
- * jakieś miasto lub odcinek drogi nie istnieje, to go tworzy. Jeśli odcinek
- * drogi już istnieje, ale ma wcześniejszy rok budowy lub ostatniego remontu,
- * to modyfikuje ten atrybut odcinka drogi. Jeśli odcinek drogi już istnieje,
- * ale ma inną długość albo późniejszy rok budowy lub ostatniego remontu zwalnia
- * listę i kończy działanie. Zmiany dokonane w mapie pozostają nawet w przypadku
- * błędu.
- * @param map - wskaźnik na strukturę przechowującą mapę dróg i miast;
- * @param cities - tablica napisów reprezentujących dodawane miasta;
- * @param lengths - tablica długości kolejnych odcików drogi;
- * @param lastRepairs - tablica dat ostatnich remontów odcinków drogi;
- * @param citiesNumber - liczba miast w tablicy miast.
- * @return Zwraca NULL, jeśli wystąpił błąd - odcinek drogi już istniał, ale
- * miał inną długość albo późniejszy rok budowy lub ostatniego remontu lub jeśli
- * nie udało się zaalokować pamięci. W przeciwnym razie zwraca listę odcików
- * dróg.
- */
-static RoadList *recoverRoadList(Map *map, char **cities, unsigned *lengths,
-                                 int *lastRepairs, int citiesNumber) {
-  if (!checkRoads(map, cities, lengths, lastRepairs, citiesNumber)) {
-    return false;
-  }
-
-  RoadList *roadList = NULL;
-
-  for (int i = 0; i < citiesNumber - 1; i++) {
-    Road *road = NULL;
-    City *city1 = NULL;
-
-    if (!addRoad(map, cities[i], cities[i + 1], lengths[i], lastRepairs[i])
-       && !repairRoad(map, cities[i], cities[i + 1], lastRepairs[i])) {
-      city1 = findCity(cities[i], map->allCities);
-      road = findRoad(cities[i + 1], city1->roads);
-      if (!road) {
-        freeRoadList(roadList);
-        return NULL;
+ * Podaje drugi koniec odcinka drogi.
+ * @param city - wskaźnik na jeden z końców odcinka;
+ * @param road - wskaźnik na odcinek drogi.
+ * @return Zwraca wskaźnik na drugi koniec odcinka.
+ */
+static City *otherEnd(City *city, Road *road) {
+  return isEqual(city, road->city1) ? road->city2 : road->city1;
+}
+
+bool checkRouteSegment(Map *map, RouteBuilder *builder,
+                       const RouteSegment *segment) {
+  City *city1 = builder->checked > 0 ? builder->checkedEnd :
+                lookupCity(map, &(segment->city1));
+  Road *road = city1 ? lookupRoad(map, city1, &(segment->city2)) : NULL;
+  (builder->checked)++;
+  builder->checkedEnd = road ? otherEnd(city1, road) :
+                        lookupCity(map, &(segment->city2));
+  return !road || (road->length == segment->length &&
+                   road->lastRepair <= segment->lastRepair);
+}
+
+bool addRouteSegment(Map *map, RouteBuilder *builder,
+                     const RouteSegment *segment) {
+  City *city1 = builder->last;
+  City *city2 = NULL;
+  Road *road = NULL;
+  if (!sameCityKey(&(segment->city1), &(segment->city2))) {
+    if (!city1) {
+      city1 = lookupCity(map, &(segment->city1));
+    }
+    if (city1) {
+      road = lookupRoad(map, city1, &(segment->city2));
+    }
+    if (road) {
+      city2 = otherEnd(city1, road);
+      if (segment->lastRepair != 0 && road->lastRepair < segment->lastRepair) {
+        renewRoad(map, road, segment->lastRepair);
       }
     }
+    else if (segment->length > 0 && segment->lastRepair != 0) {
+      if (!city1) {
+        city1 = insertCity(map, &(segment->city1));
+      }
+      city2 = insertCity(map, &(segment->city2));
+      if (city1 && city2) {
+        road = connectCities(map, city1, city2, segment->length,
+                             segment->lastRepair);
+      }
+    }
+  }
 
-    city1 = findCity(cities[i], map->allCities);
-    road = findRoad(cities[i + 1], city1->roads);
-    addToRoadList(road, &roadList);
+  if (!road || !addToRoadList(road, &(builder->roads))) {
+    freeRoadList(builder->roads);
+    builder->roads = NULL;
+    return false;
   }
-  return roadList;
+  if (!builder->first) {
+    builder->first = city1;
+  }
+  builder->last = city2;
+  (map->lookups.segments)++;
+  return true;
 }
 
-bool getRoute(Map *map, unsigned routeId,  char **cities, unsigned *lengths,
-        int *lastRepairs, int citiesNumber) {
-  if (!map || !validRouteId(routeId) || map->allRoutes[routeId]) {
+bool finishRoute(Map *map, RouteBuilder *builder) {
+  if (!builder->roads) {
     return false;
   }
-  RoadList* roadList = recoverRoadList(map, cities, lengths, lastRepairs,
-                                       citiesNumber);
-  if (!roadList) {
+  reverseRoadList(&(builder->roads));
+  Route *route = createRoute(builder->roads, builder->first, builder->last,
+                             builder->routeId);
+  if (!route) {
+    freeRoadList(builder->roads);
+    builder->roads = NULL;
     return false;
   }
 
-  reverseRoadList(&roadList);
+  map->allRoutes[builder->routeId] = route;
+  invalidateRoute(map->cache, builder->routeId);
+  return true;
+}
 
-  City *firstCity = findCity(cities[0], map->allCities);
-  City *secondCity = findCity(cities[citiesNumber - 1], map->allCities);
-  Route *route = createRoute(roadList, firstCity, secondCity, routeId);
-  if (!route) {
+bool getRoute(Map *map, unsigned routeId,  char **cities, unsigned *lengths,
+        int *lastRepairs, int citiesNumber) {
+  if (!cities || !lengths || !lastRepairs || citiesNumber < 2) {
+    return false;
+  }
+  unsigned number = (unsigned) citiesNumber - 1;
+  RouteSegment *segments = malloc(number * sizeof(RouteSegment));
+  if (!segments) {
     return false;
   }
+  bool result = true;
+  for (unsigned i = 0; result && i < number; i++) {
+    result = makeCityKey(cities[i], &(segments[i].city1)) &&
+             makeCityKey(cities[i + 1], &(segments[i].city2));
+    segments[i].length = lengths[i];
+    segments[i].lastRepair = lastRepairs[i];
+  }
+  result = result && importRouteSegments(map, routeId, segments, number);
+  free(segments);
+  return result;
+}
 
-  map->allRoutes[routeId] = route;
-  return true;
+bool importRouteSegments(Map *map, unsigned routeId,
+                         const RouteSegment *segments, unsigned number) {
+  RouteBuilder builder;
+  if (!segments || !startRoute(map, routeId, &builder)) {
+    return false;
+  }
+  for (unsigned i = 0; i < number; i++) {
+    if (!checkRouteSegment(map, &builder, &segments[i])) {
+      return false;
+    }
+  }
+  for (unsigned i = 0; i < number; i++) {
+    if (!addRouteSegment(map, &builder, &segments[i])) {
+      return false;
+    }
+  }
+  return finishRoute(map, &builder);
 }
 
 bool removeRoute(Map *map, unsigned routeId) {
@@ -459,5 +1054,355 @@ bool removeRoute(Map *map, unsigned routeId) {
 
   deleteRoute(map->allRoutes[routeId]);
   map->allRoutes[routeId] = NULL;
+  invalidateRoute(map->cache, routeId);
+  return true;
+}
+
+bool reachableCities(Map *map, const char *city, unsigned maxDistance,
+                     ReachableCities *result) {
+  if (!map || !result || !validCityName(city)) {
+    return false;
+  }
+  City *start = findCity(city, map->allCities);
+  if (!start) {
+    return false;
+  }
+  if (map->engine) {
+    return parallelReachableCities(map->engine, start, map->allCities,
+            maxDistance, result);
+  }
+  return findReachableCities(start, map->allCities, maxDistance, result);
+}
+
+/**
+ * Tworzy tablicę miast, przez które przechodzi droga krajowa, na podstawie
+ * listy jej odcinków.
+ * @param route - wskaźnik na drogę krajową;
+ * @param number - wskaźnik, pod który zostanie zapisana liczba miast.
+ * @return Zwraca tablicę miast w kolejności przebiegu drogi krajowej lub NULL,
+ * jeśli nie udało się zaalokować pamięci.
+ */
+static City **routeCities(Route *route, unsigned *number) {
+  unsigned size = 1;
+  for (RoadList *temp = route->roads; temp; temp = temp->next) {
+    size++;
+  }
+  City **cities = malloc(size * sizeof(City *));
+  if (!cities) {
+    return NULL;
+  }
+  cities[0] = route->city1;
+  *number = 1;
+  for (RoadList *temp = route->roads; temp; temp = temp->next) {
+    City *last = cities[*number - 1];
+    cities[(*number)++] = isEqual(temp->road->city1, last) ?
+            temp->road->city2 : temp->road->city1;
+  }
+  return cities;
+}
+
+bool nearestRouteCity(Map *map, unsigned routeId, const char *city,
+                      ReachedCity *result) {
+  if (!map || !result || !validRouteId(routeId) || !validCityName(city) ||
+      !map->allRoutes[routeId]) {
+    return false;
+  }
+  City *finish = findCity(city, map->allCities);
+  if (!finish) {
+    return false;
+  }
+  unsigned number;
+  City **starts = routeCities(map->allRoutes[routeId], &number);
+  if (!starts) {
+    return false;
+  }
+  bool success = findNearestCity(NULL, starts, number, finish,
+                                 map->allCities, result);
+  free(starts);
+  return success;
+}
+
+bool setSearchThreads(Map *map, unsigned threads) {
+  if (!map) {
+    return false;
+  }
+  ThreadPool *pool = NULL;
+  DeltaStepping *engine = NULL;
+  if (threads > 1 && !(pool = newThreadPool(threads))) {
+    return false;
+  }
+  if (threads > 0 && !(engine = newDeltaStepping(pool, 0))) {
+    freeThreadPool(pool);
+    return false;
+  }
+  freeSearchStates(map);
+  freeDeltaStepping(map->engine);
+  freeThreadPool(map->pool);
+  map->pool = pool;
+  map->engine = engine;
   return true;
-}
\ No newline at end of file
+}
+
+/**
+ * Struktura przechowująca wyszukiwania zastępczych przebiegów dla
+ * symulowanych zamknięć odcinków dróg.
+ */
+typedef struct ClosureSearches {
+  Map *map; ///< Wskaźnik na strukturę przechowującą mapę dróg.
+  Road **brakes; ///< Zamykany odcinek drogi dla każdego wyszukiwania.
+  Route **routes; ///< Naprawiana droga krajowa dla każdego wyszukiwania.
+  RoadList **patches; ///< Tablica wyznaczonych przebiegów.
+  int *statuses; ///< Tablica wyników wyszukiwań.
+  unsigned number; ///< Liczba wyszukiwań.
+  atomic_uint next; ///< Numer następnego wyszukiwania do wykonania.
+} ClosureSearches;
+
+/**
+ * Zadanie wątku: kolejne niezależne wyszukiwania zastępczych przebiegów.
+ * Mapa nie jest w tym czasie zmieniana.
+ * @param thread - numer wątku;
+ * @param threads - liczba wątków;
+ * @param data - wskaźnik na strukturę ClosureSearches.
+ */
+static void closureSearchTask(unsigned thread, unsigned threads, void *data) {
+  (void) threads;
+  ClosureSearches *batch = data;
+  SearchState *state = batch->map->states[thread];
+  unsigned i;
+  while ((i = atomic_fetch_add(&(batch->next), 1)) < batch->number) {
+    Road *brake = batch->brakes[i];
+    Route *route = batch->routes[i];
+    bool forward = entersByFirstCity(route, brake);
+    batch->patches[i] = findBestRouteWith(state,
+            forward ? brake->city1 : brake->city2,
+            forward ? brake->city2 : brake->city1, batch->map->allCities,
+            route, brake, NULL, &(batch->statuses[i]));
+  }
+}
+
+/**
+ * Wyszukuje zamykany odcinek drogi.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param closure - wskaźnik na opis zamknięcia.
+ * @return Zwraca wskaźnik na odcinek drogi lub NULL, jeśli go nie ma.
+ */
+static Road *closedRoad(Map *map, const RoadClosure *closure) {
+  if (!validCityName(closure->city1) || !validCityName(closure->city2)) {
+    return NULL;
+  }
+  City *city = findCity(closure->city2, map->allCities);
+  return city ? findRoad(closure->city1, city->roads) : NULL;
+}
+
+/**
+ * Wypełnia raport zamknięcia odcinka drogi na podstawie wyznaczonych
+ * przebiegów.
+ * @param report - wskaźnik na wypełniany raport;
+ * @param brake - zamykany odcinek drogi;
+ * @param batch - wskaźnik na strukturę wyszukiwań;
+ * @param first - numer pierwszego wyszukiwania dotyczącego odcinka.
+ */
+static void fillClosureReport(ClosureReport *report, Road *brake,
+        ClosureSearches *batch, unsigned first) {
+  report->removable = true;
+  for (unsigned i = 0; i < report->changesNumber; i++) {
+    RouteChange *change = &(report->changes[i]);
+    Route *route = batch->routes[first + i];
+    change->routeId = route->rotueID;
+    change->oldLength = 0;
+    for (RoadList *temp = route->roads; temp; temp = temp->next) {
+      change->oldLength += temp->road->length;
+    }
+    change->status = batch->statuses[first + i];
+    change->newLength = 0;
+    if (batch->patches[first + i]) {
+      change->newLength = change->oldLength - brake->length;
+      for (RoadList *temp = batch->patches[first + i]; temp;
+           temp = temp->next) {
+        change->newLength += temp->road->length;
+      }
+    }
+    else {
+      report->removable = false;
+    }
+  }
+}
+
+bool simulateClosures(Map *map, const RoadClosure *closures, unsigned number,
+                      ClosureReport *reports) {
+  if (!map || !closures || !reports) {
+    return false;
+  }
+  Road **closed = malloc((number > 0 ? number : 1) * sizeof(Road *));
+  if (!closed || !prepareSearchStates(map)) {
+    free(closed);
+    return false;
+  }
+  unsigned searches = 0;
+  bool success = true;
+  for (unsigned i = 0; i < number; i++) {
+    closed[i] = closedRoad(map, &(closures[i]));
+    reports[i] = (ClosureReport) {closed[i] != NULL, false, NULL, 0};
+    for (RouteList *temp = closed[i] ? closed[i]->routes : NULL; temp;
+         temp = temp->next) {
+      (reports[i].changesNumber)++;
+    }
+    if (reports[i].changesNumber > 0 &&
+        !(reports[i].changes = malloc(reports[i].changesNumber *
+                                      sizeof(RouteChange)))) {
+      success = false;
+    }
+    searches += reports[i].changesNumber;
+  }
+  ClosureSearches batch;
+  batch.map = map;
+  batch.brakes = malloc((searches > 0 ? searches : 1) * sizeof(Road *));
+  batch.routes = malloc((searches > 0 ? searches : 1) * sizeof(Route *));
+  batch.patches = calloc(searches > 0 ? searches : 1, sizeof(RoadList *));
+  batch.statuses = malloc((searches > 0 ? searches : 1) * sizeof(int));
+  batch.number = searches;
+  atomic_init(&(batch.next), 0);
+  success = success && batch.brakes && batch.routes && batch.patches &&
+          batch.statuses;
+  if (success) {
+    unsigned j = 0;
+    for (unsigned i = 0; i < number; i++) {
+      for (RouteList *temp = closed[i] ? closed[i]->routes : NULL; temp;
+           temp = temp->next, j++) {
+        batch.brakes[j] = closed[i];
+        batch.routes[j] = temp->route;
+      }
+    }
+    runParallel(map->pool, closureSearchTask, &batch);
+    j = 0;
+    for (unsigned i = 0; i < number; i++) {
+      if (closed[i]) {
+        fillClosureReport(&(reports[i]), closed[i], &batch, j);
+        j += reports[i].changesNumber;
+      }
+    }
+    for (unsigned i = 0; i < searches; i++) {
+      success = success && batch.statuses[i] != SEARCH_ERROR;
+      freeRoadList(batch.patches[i]);
+    }
+  }
+  free(closed);
+  free(batch.brakes);
+  free(batch.routes);
+  free(batch.patches);
+  free(batch.statuses);
+  if (!success) {
+    freeClosureReports(reports, number);
+  }
+  return success;
+}
+
+void freeClosureReports(ClosureReport *reports, unsigned number) {
+  for (unsigned i = 0; reports && i < number; i++) {
+    free(reports[i].changes);
+    reports[i].changes = NULL;
+    reports[i].changesNumber = 0;
+  }
+}
+
+/**
+ * Zamienia tablicę nazw miast na tablicę wskaźników na miasta.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param names - tablica nazw miast;
+ * @param number - liczba nazw.
+ * @return Zwraca utworzoną tablicę lub NULL, jeśli któreś miasto nie istnieje
+ * lub nie udało się zaalokować pamięci.
+ */
+static City **findCities(Map *map, const char **names, unsigned number) {
+  City **cities = malloc((number > 0 ? number : 1) * sizeof(City *));
+  if (!cities) {
+    return NULL;
+  }
+  for (unsigned i = 0; i < number; i++) {
+    if (!validCityName(names[i]) ||
+        !(cities[i] = findCity(names[i], map->allCities))) {
+      free(cities);
+      return NULL;
+    }
+  }
+  return cities;
+}
+
+bool routeDistances(Map *map, const char **sources, unsigned sourcesNumber,
+                    const char **targets, unsigned targetsNumber,
+                    ReachedCity *result) {
+  if (!map || !sources || !targets || !result) {
+    return false;
+  }
+  DeltaStepping *engine = map->engine;
+  if (!engine && !(engine = newDeltaStepping(NULL, 0))) {
+    return false;
+  }
+  City **sourceCities = findCities(map, sources, sourcesNumber);
+  City **targetCities = findCities(map, targets, targetsNumber);
+  bool success = sourceCities && targetCities &&
+          parallelDistances(engine, sourceCities, sourcesNumber,
+                  targetCities, targetsNumber, map->allCities, result);
+  free(sourceCities);
+  free(targetCities);
+  if (engine != map->engine) {
+    freeDeltaStepping(engine);
+  }
+  return success;
+}
+
+void setSearchLimits(Map *map, SearchLimits limits) {
+  if (map) {
+    map->limits = limits;
+  }
+}
+
+int searchStatus(Map *map) {
+  if (!map) {
+    return SEARCH_ERROR;
+  }
+  return map->searchStatus;
+}
+
+CacheStatistics cacheStatistics(Map *map) {
+  CacheStatistics statistics = {0, 0};
+  return map ? routeCacheStatistics(map->cache) : statistics;
+}
+
+LookupStatistics lookupStatistics(Map *map) {
+  LookupStatistics statistics = {0, 0, 0};
+  return map ? map->lookups : statistics;
+}
+
+bool enableOverlay(Map *map, bool enabled) {
+  if (!map) {
+    return false;
+  }
+  if (!enabled) {
+    freeOverlay(map->overlay);
+    map->overlay = NULL;
+    return true;
+  }
+  if (!map->overlay) {
+    map->overlay = newOverlay();
+  }
+  return map->overlay != NULL;
+}
+
+bool overlayRouteDistance(Map *map, const char *city1, const char *city2,
+                          ReachedCity *result) {
+  if (!map || !map->overlay || !validCityName(city1) ||
+      !validCityName(city2)) {
+    return false;
+  }
+  City *start = findCity(city1, map->allCities);
+  City *finish = findCity(city2, map->allCities);
+  if (!start || !finish) {
+    return false;
+  }
+  return overlayDistance(map->overlay, start, finish, map->allCities, result);
+}
+
+OverlayStatistics partitionStatistics(Map *map) {
+  return overlayStatistics(map ? map->overlay : NULL);
+}
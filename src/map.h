@@ -12,6 +12,9 @@
 #include <stdbool.h>
 #include "structures.h"
 #include "city_hashmap.h"
+#include "dijkstra.h"
+#include "route_cache.h"
+#include "overlay.h"
 
 /**
  * Struktura przechowująca mapę dróg krajowych.
@@ -33,6 +36,22 @@ Map* newMap(void);
  */
 void deleteMap(Map *map);
 
+/**@brief Sprawdza nazwę miasta i wyznacza jej indeks.
+ * Funkcje mapy przyjmujące nazwy miast jako napisy sprawdzają je tą funkcją
+ * przy każdym wywołaniu, a następnie wywołują swoje odpowiedniki przyjmujące
+ * struktury @ref CityKey, które już niczego nie sprawdzają ani nie wyznaczają
+ * indeksów nazw. Struktury można też wypełnić bezpośrednio, jeśli nazwa została
+ * już sprawdzona, a jej długość jest znana, wyznaczając indeks funkcją
+ * cityIndex().
+ * @param cityName - wskaźnik na napis reprezentujący nazwę miasta;
+ * @param key - wskaźnik na strukturę, do której zostanie zapisana nazwa, jej
+ * długość i indeks. Nazwa nie jest kopiowana.
+ * @return Zwraca @p true, jeśli nazwa miasta jest poprawna - jest niepusta
+ * i nie zawiera znaków o kodach pomiędzy 0 a 31 ani średnika. W przeciwnym
+ * wypadku zwraca @p false.
+ */
+bool makeCityKey(const char *cityName, CityKey *key);
+
 /** @brief Dodaje do mapy odcinek drogi między dwoma różnymi miastami.
  * Jeśli któreś z podanych miast nie istnieje, to dodaje go do mapy, a następnie
  * dodaje do mapy odcinek drogi między tymi miastami.
@@ -49,6 +68,18 @@ void deleteMap(Map *map);
 bool addRoad(Map *map, const char *city1, const char *city2,
              unsigned length, int builtYear);
 
+/**@brief Dodaje do mapy odcinek drogi między miastami o sprawdzonych nazwach.
+ * Działa tak jak @ref addRoad.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param city1 - wskaźnik na nazwę pierwszego miasta (zob. makeCityKey());
+ * @param city2 - wskaźnik na nazwę drugiego miasta;
+ * @param length - długość w km odcinka drogi;
+ * @param builtYear - rok budowy odcinka drogi.
+ * @return Zwraca wynik tak jak @ref addRoad.
+ */
+bool addRoadByKeys(Map *map, const CityKey *city1, const CityKey *city2,
+                   unsigned length, int builtYear);
+
 /** @brief Modyfikuje rok ostatniego remontu odcinka drogi.
  * Dla odcinka drogi między dwoma miastami zmienia rok jego ostatniego remontu
  * lub ustawia ten rok, jeśli odcinek nie był jeszcze remontowany.
@@ -64,6 +95,18 @@ bool addRoad(Map *map, const char *city1, const char *city2,
  */
 bool repairRoad(Map *map, const char *city1, const char *city2, int repairYear);
 
+/**@brief Modyfikuje rok ostatniego remontu odcinka drogi między miastami
+ * o sprawdzonych nazwach.
+ * Działa tak jak @ref repairRoad.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param city1 - wskaźnik na nazwę pierwszego miasta (zob. makeCityKey());
+ * @param city2 - wskaźnik na nazwę drugiego miasta;
+ * @param repairYear - rok ostatniego remontu odcinka drogi.
+ * @return Zwraca wynik tak jak @ref repairRoad.
+ */
+bool repairRoadByKeys(Map *map, const CityKey *city1, const CityKey *city2,
+                      int repairYear);
+
 /** @brief Łączy dwa różne miasta drogą krajową.
  * Tworzy drogę krajową pomiędzy dwoma miastami i nadaje jej podany numer.
  * Wśród istniejących odcinków dróg wyszukuje najkrótszą drogę. Jeśli jest
@@ -84,12 +127,26 @@ bool repairRoad(Map *map, const char *city1, const char *city2, int repairYear);
 bool newRoute(Map *map, unsigned routeId,
               const char *city1, const char *city2);
 
+/**@brief Łączy drogą krajową dwa miasta o sprawdzonych nazwach.
+ * Działa tak jak @ref newRoute.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param routeId - numer drogi krajowej;
+ * @param city1 - wskaźnik na nazwę pierwszego miasta (zob. makeCityKey());
+ * @param city2 - wskaźnik na nazwę drugiego miasta.
+ * @return Zwraca wynik tak jak @ref newRoute.
+ */
+bool newRouteByKeys(Map *map, unsigned routeId, const CityKey *city1,
+                    const CityKey *city2);
+
 /** @brief Wydłuża drogę krajową do podanego miasta.
  * Dodaje do drogi krajowej nowe odcinki dróg do podanego miasta w taki sposób,
- * aby nowy fragment drogi krajowej był najkrótszy. Jeśli jest więcej niż jeden
- * sposób takiego wydłużenia, to dla każdego wariantu wyznacza wśród dodawanych
- * odcinków dróg ten, który był najdawniej wybudowany lub remontowany i wybiera
- * wariant z odcinkiem, który jest najmłodszy.
+ * aby nowy fragment drogi krajowej był najkrótszy. Nowy fragment może
+ * zaczynać się w którymkolwiek z końców drogi krajowej; przy wydłużeniu od
+ * strony początku podane miasto staje się nowym początkiem drogi krajowej.
+ * Jeśli jest więcej niż jeden sposób takiego wydłużenia, to dla każdego
+ * wariantu wyznacza wśród dodawanych odcinków dróg ten, który był najdawniej
+ * wybudowany lub remontowany i wybiera wariant z odcinkiem, który jest
+ * najmłodszy.
  * @param[in,out] map    – wskaźnik na strukturę przechowującą mapę dróg;
  * @param[in] routeId    – numer drogi krajowej;
  * @param[in] city       – wskaźnik na napis reprezentujący nazwę miasta.
@@ -103,6 +160,49 @@ bool newRoute(Map *map, unsigned routeId,
  */
 bool extendRoute(Map *map, unsigned routeId, const char *city);
 
+/**@brief Wydłuża drogę krajową do miasta o sprawdzonej nazwie.
+ * Działa tak jak @ref extendRoute.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param routeId - numer drogi krajowej;
+ * @param city - wskaźnik na nazwę miasta (zob. makeCityKey()).
+ * @return Zwraca wynik tak jak @ref extendRoute.
+ */
+bool extendRouteByKey(Map *map, unsigned routeId, const CityKey *city);
+
+/**
+ * Struktura opisująca jedno polecenie utworzenia lub wydłużenia drogi krajowej
+ * w poleceniu zbiorczym (zob. @ref executeRouteRequests).
+ */
+typedef struct RouteRequest {
+  bool extend; ///< @p true dla @ref extendRoute, @p false dla @ref newRoute.
+  unsigned routeId; ///< Numer drogi krajowej.
+  ///Sprawdzona nazwa miasta początkowego lub miasta, do którego droga jest
+  ///wydłużana (zob. makeCityKey()).
+  CityKey city1;
+  CityKey city2; ///< Nazwa miasta końcowego; nieużywana przy wydłużaniu.
+} RouteRequest;
+
+/**@brief Tworzy i wydłuża wiele dróg krajowych naraz.
+ * Wykonuje kolejne polecenia tak jak @ref newRoute i @ref extendRoute.
+ * Polecenia dotyczące różnych numerów dróg krajowych są od siebie niezależne,
+ * więc wyszukiwania dla kolejnych poleceń o różnych numerach są wykonywane
+ * równolegle na wątkach ustawionych przez @ref setSearchThreads, a mapa jest
+ * zmieniana po kolei, w kolejności poleceń. Wyszukiwania z jednego miasta
+ * bez ograniczeń korzystają z pamięci wstrzymanych wyszukiwań tak jak przy
+ * pojedynczych poleceniach: przed uruchomieniem wątków każde miasto początkowe
+ * dostaje własne wyszukiwanie z pamięci, które wątek wznawia. Stan mapy,
+ * wyniki poleceń i wynik zwracany przez @ref searchStatus są takie same jak
+ * przy wykonaniu poleceń po kolei.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param requests - tablica poleceń;
+ * @param number - liczba poleceń;
+ * @param results - tablica, do której zostaną zapisane wyniki poleceń.
+ * @return Wartość @p false, jeśli któryś ze wskaźników ma wartość NULL. Wtedy
+ * żadne polecenie nie jest wykonywane. W przeciwnym razie @p true.
+ */
+bool executeRouteRequests(Map *map, const RouteRequest *requests,
+                          unsigned number, bool *results);
+
 /** @brief Usuwa odcinek drogi między dwoma różnymi miastami.
  * Usuwa odcinek drogi między dwoma miastami. Jeśli usunięcie tego odcinka drogi
  * powoduje przerwanie ciągu jakiejś drogi krajowej, to uzupełnia ją
@@ -122,6 +222,15 @@ bool extendRoute(Map *map, unsigned routeId, const char *city);
  */
 bool removeRoad(Map *map, const char *city1, const char *city2);
 
+/**@brief Usuwa odcinek drogi między miastami o sprawdzonych nazwach.
+ * Działa tak jak @ref removeRoad.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param city1 - wskaźnik na nazwę pierwszego miasta (zob. makeCityKey());
+ * @param city2 - wskaźnik na nazwę drugiego miasta.
+ * @return Zwraca wynik tak jak @ref removeRoad.
+ */
+bool removeRoadByKeys(Map *map, const CityKey *city1, const CityKey *city2);
+
 /** @brief Udostępnia informacje o drodze krajowej.
  * Zwraca wskaźnik na napis, który zawiera informacje o drodze krajowej. Alokuje
  * pamięć na ten napis. Zwraca pusty napis, jeśli nie istnieje droga krajowa
@@ -139,6 +248,21 @@ bool removeRoad(Map *map, const char *city1, const char *city2);
  */
 char const* getRouteDescription(Map *map, unsigned routeId);
 
+/** @brief Zapisuje informacje o drodze krajowej do podanego bufora.
+ * Działa tak jak @ref getRouteDescription, ale zamiast alokować nowy napis,
+ * zapisuje go do bufora, który jest powiększany tylko wtedy, gdy opis się
+ * w nim nie mieści.
+ * @param[in,out] map      – wskaźnik na strukturę przechowującą mapę dróg;
+ * @param[in] routeId      – numer drogi krajowej;
+ * @param[in,out] buffer   – wskaźnik na bufor lub na NULL, jeśli @p capacity
+ *                           wskazuje na 0;
+ * @param[in,out] capacity – wskaźnik na rozmiar bufora.
+ * @return Wskaźnik na napis w buforze lub NULL, gdy numer drogi krajowej jest
+ * niepoprawny albo nie udało się zaalokować pamięci.
+ */
+char const *getRouteDescriptionInto(Map *map, unsigned routeId, char **buffer,
+                                    size_t *capacity);
+
 /**@brief Tworzy drogę krajową o podanym przebiegu.
  * Tworzy drogę krajową o podanym numerze i przebiegu. Jeśli jakieś miasto lub
  * odcinek drogi nie istnieje, to go tworzy. Jeśli odcinek drogi już istnieje,
@@ -158,6 +282,95 @@ char const* getRouteDescription(Map *map, unsigned routeId);
 bool getRoute(Map *map, unsigned routeId,  char **cities, unsigned *lengths,
               int *lastRepairs, int citiesNumber);
 
+/**
+ * Struktura przechowująca drogę krajową tworzoną odcinek po odcinku
+ * (zob. @ref startRoute).
+ */
+typedef struct RouteBuilder {
+  unsigned routeId; ///< Numer tworzonej drogi krajowej.
+  RoadList *roads; ///< Dodane odcinki dróg, od ostatniego.
+  City *first; ///< Miasto początkowe lub NULL przed dodaniem odcinka.
+  City *last; ///< Miasto końcowe lub NULL przed dodaniem odcinka.
+  unsigned checked; ///< Liczba sprawdzonych odcinków.
+  ///Miasto, w którym kończy się ostatni sprawdzony odcinek, lub NULL, jeśli
+  ///go nie ma na mapie.
+  City *checkedEnd;
+} RouteBuilder;
+
+/**@brief Zaczyna tworzenie drogi krajowej odcinek po odcinku.
+ * Pozwala utworzyć drogę krajową tak jak @ref getRoute bez tablic miast,
+ * długości i dat: opis drogi jest przeglądany dwa razy. Najpierw każdy odcinek
+ * należy sprawdzić funkcją @ref checkRouteSegment, a jeśli żaden nie jest
+ * sprzeczny z mapą, dodać kolejne odcinki funkcją @ref addRouteSegment
+ * i zakończyć tworzenie funkcją @ref finishRoute. Nie alokuje pamięci, więc
+ * po nieudanym sprawdzeniu nie trzeba niczego zwalniać.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param routeId - numer drogi krajowej;
+ * @param builder - wskaźnik na strukturę, która zostanie zainicjowana.
+ * @return Zwraca @p false, jeśli któryś z parametrów ma niepoprawną wartość lub
+ * droga krajowa o podanym numerze już istnieje. W przeciwnym razie zwraca
+ * @p true.
+ */
+bool startRoute(Map *map, unsigned routeId, RouteBuilder *builder);
+
+/**@brief Sprawdza, czy odcinek drogi krajowej nie jest sprzeczny z mapą.
+ * Miasto początkowe odcinka jest wyszukiwane tylko dla pierwszego odcinka,
+ * a dla kolejnych jest to miasto końcowe poprzedniego. Miasto końcowe jest
+ * wyszukiwane tylko wtedy, gdy odcinka nie ma na mapie.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param builder - wskaźnik na strukturę tworzonej drogi krajowej;
+ * @param segment - wskaźnik na opis odcinka o sprawdzonych nazwach miast
+ * (zob. makeCityKey()), zaczynającego się w mieście, w którym kończy się
+ * poprzedni sprawdzony odcinek.
+ * @return Zwraca @p false, jeśli odcinek drogi między podanymi miastami już
+ * istnieje, ale ma inną długość albo późniejszy rok budowy lub ostatniego
+ * remontu. W przeciwnym razie zwraca @p true.
+ */
+bool checkRouteSegment(Map *map, RouteBuilder *builder,
+                       const RouteSegment *segment);
+
+/**@brief Dodaje kolejny odcinek do tworzonej drogi krajowej.
+ * Jeśli jakieś miasto lub odcinek drogi nie istnieje, to go tworzy, a jeśli
+ * odcinek ma wcześniejszy rok budowy lub ostatniego remontu, to go zmienia,
+ * tak jak @ref getRoute. Miasto początkowe jest wyszukiwane tylko dla
+ * pierwszego odcinka, a odcinek - jeden raz, wśród odcinków wychodzących
+ * z miasta początkowego; na tej podstawie funkcja rozstrzyga, czy odcinek
+ * należy utworzyć, zmienić jego datę remontu czy pozostawić bez zmian.
+ * Miasto końcowe jest wyszukiwane tylko wtedy, gdy odcinka nie ma. Zmiany
+ * dokonane w mapie pozostają nawet w przypadku błędu.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param builder - wskaźnik na strukturę tworzonej drogi krajowej;
+ * @param segment - wskaźnik na opis odcinka o sprawdzonych nazwach miast
+ * (zob. makeCityKey()), zaczynającego się w mieście, w którym kończy się
+ * poprzedni odcinek.
+ * @return Zwraca @p false, jeśli nie udało się dodać odcinka. Wtedy pamięć
+ * tworzonej drogi krajowej jest zwalniana. W przeciwnym razie zwraca @p true.
+ */
+bool addRouteSegment(Map *map, RouteBuilder *builder,
+                     const RouteSegment *segment);
+
+/**@brief Kończy tworzenie drogi krajowej odcinek po odcinku.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param builder - wskaźnik na strukturę tworzonej drogi krajowej.
+ * @return Zwraca @p true, jeśli droga krajowa została utworzona. Jeśli nie
+ * dodano żadnego odcinka lub nie udało się zaalokować pamięci, zwalnia pamięć
+ * tworzonej drogi krajowej i zwraca @p false.
+ */
+bool finishRoute(Map *map, RouteBuilder *builder);
+
+/**@brief Tworzy drogę krajową z tablicy odcinków.
+ * Sprawdza i dodaje kolejne odcinki tak jak @ref startRoute,
+ * @ref checkRouteSegment, @ref addRouteSegment i @ref finishRoute.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param routeId - numer drogi krajowej;
+ * @param segments - tablica kolejnych odcinków, z których każdy zaczyna się
+ * w mieście, w którym kończy się poprzedni;
+ * @param number - liczba odcinków.
+ * @return Zwraca wynik tak jak @ref getRoute.
+ */
+bool importRouteSegments(Map *map, unsigned routeId,
+                         const RouteSegment *segments, unsigned number);
+
 /**@brief Usuwa drogę krajową.
  * Usuwa z mapy dróg drogę krajową o podanym numerze, jeśli taka istnieje. Jeśli
  * nie istnieje, niczego nie zmienia.
@@ -169,4 +382,230 @@ bool getRoute(Map *map, unsigned routeId,  char **cities, unsigned *lengths,
  */
 bool removeRoute(Map *map, unsigned routeId);
 
+/**
+ * Struktura opisująca hipotetyczne zamknięcie odcinka drogi.
+ */
+typedef struct RoadClosure {
+  const char *city1; ///< Nazwa jednego z końców odcinka.
+  const char *city2; ///< Nazwa drugiego z końców odcinka.
+} RoadClosure;
+
+/**
+ * Struktura opisująca zmianę drogi krajowej po zamknięciu odcinka drogi.
+ */
+typedef struct RouteChange {
+  unsigned routeId; ///< Numer drogi krajowej.
+  unsigned oldLength; ///< Długość drogi krajowej przed zamknięciem.
+  ///Długość drogi krajowej po zamknięciu lub 0, jeśli nie można wyznaczyć
+  ///zastępczego przebiegu.
+  unsigned newLength;
+  ///Wynik wyszukiwania zastępczego przebiegu: ROUTE_FOUND, ROUTE_NOT_FOUND
+  ///lub ROUTE_AMBIGUOUS.
+  int status;
+} RouteChange;
+
+/**
+ * Struktura opisująca skutki zamknięcia odcinka drogi.
+ */
+typedef struct ClosureReport {
+  bool exists; ///< Informacja, czy odcinek drogi istnieje.
+  ///Informacja, czy @ref removeRoad usunęłoby odcinek drogi.
+  bool removable;
+  ///Zmiany dróg krajowych przechodzących przez odcinek lub NULL.
+  RouteChange *changes;
+  unsigned changesNumber; ///< Liczba dróg krajowych przechodzących przez odcinek.
+} ClosureReport;
+
+/**@brief Symuluje zamknięcia odcinków dróg bez zmieniania mapy.
+ * Dla każdego zamknięcia niezależnie wyznacza zastępcze przebiegi dróg
+ * krajowych przechodzących przez odcinek drogi tak, jak zrobiłaby to funkcja
+ * @ref removeRoad, ale nie zmienia mapy. Wyszukiwania dla wszystkich zamknięć
+ * są wykonywane równolegle na wątkach mapy (zob. @ref setSearchThreads).
+ * Tablice zmian w raportach należy zwolnić funkcją @ref freeClosureReports.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param closures - tablica zamknięć;
+ * @param number - liczba zamknięć;
+ * @param reports - tablica o rozmiarze @p number, do której zostaną zapisane
+ * raporty kolejnych zamknięć.
+ * @return Wartość @p true, jeśli raporty zostały wyznaczone. Wartość
+ * @p false, jeśli któryś z parametrów ma niepoprawną wartość lub nie udało się
+ * zaalokować pamięci; wtedy raporty nie zawierają zaalokowanej pamięci.
+ */
+bool simulateClosures(Map *map, const RoadClosure *closures, unsigned number,
+                      ClosureReport *reports);
+
+/**@brief Zwalnia pamięć raportów zamknięć odcinków dróg.
+ * @param reports - tablica raportów wypełniona przez @ref simulateClosures;
+ * @param number - liczba raportów.
+ */
+void freeClosureReports(ClosureReport *reports, unsigned number);
+
+/**@brief Wyznacza miasta osiągalne z podanego miasta.
+ * Dla każdego miasta, do którego prowadzi droga z podanego miasta, wyznacza
+ * odległość, datę remontu najstarszego odcinka na najlepszej drodze (w sensie
+ * funkcji @ref newRoute) oraz poprzednie miasto na tej drodze. Wynik jest
+ * zapisywany do podanej struktury w kolejności rosnącej odległości. Struktura
+ * może być używana wielokrotnie - pamięć jest alokowana tylko wtedy, gdy od
+ * poprzedniego wywołania przybyło miast. Przy wyszukiwaniu wielowątkowym (zob.
+ * @ref setSearchThreads) miasta o równie dobrych drogach są uporządkowane
+ * według kolejności dodania do mapy.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param city - wskaźnik na napis reprezentujący nazwę miasta początkowego;
+ * @param maxDistance - największa odległość od miasta początkowego, dla której
+ * miasto zostanie zapisane lub 0, jeśli odległość nie jest ograniczona;
+ * @param result - wskaźnik na strukturę, do której zostanie zapisany wynik.
+ * @return Wartość @p true, jeśli wynik został wyznaczony.
+ * Wartość @p false, jeśli wystąpił błąd: któryś z parametrów ma niepoprawną
+ * wartość, nie ma miasta o podanej nazwie lub nie udało się zaalokować
+ * pamięci.
+ */
+bool reachableCities(Map *map, const char *city, unsigned maxDistance,
+                     ReachableCities *result);
+
+/**@brief Wyznacza miasto drogi krajowej najbliższe podanemu miastu.
+ * Przeszukuje mapę jednocześnie ze wszystkich miast drogi krajowej
+ * i kończy, gdy zostanie osiągnięte podane miasto. Drogi są porównywane tak
+ * samo jak w funkcji @ref newRoute, ale mogą przechodzić przez dowolne miasta.
+ * Jeśli kilka miast drogi krajowej jest równie blisko, wybierane jest jedno
+ * z nich.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param routeId - numer drogi krajowej;
+ * @param city - wskaźnik na napis reprezentujący nazwę miasta;
+ * @param result - wskaźnik na strukturę, do której zostanie zapisane
+ * najbliższe miasto drogi krajowej (NULL, jeśli żadne nie jest połączone
+ * z podanym miastem), odległość i data remontu najstarszego odcinka
+ * najlepszej drogi (0, jeśli miasto należy do drogi krajowej). Pola
+ * @p previous i @p connection mają wartość NULL.
+ * @return Wartość @p true, jeśli wynik został wyznaczony.
+ * Wartość @p false, jeśli wystąpił błąd: któryś z parametrów ma niepoprawną
+ * wartość, droga krajowa lub miasto nie istnieje lub nie udało się
+ * zaalokować pamięci.
+ */
+bool nearestRouteCity(Map *map, unsigned routeId, const char *city,
+                      ReachedCity *result);
+
+/**@brief Ustawia ograniczenia wyszukiwania dróg krajowych.
+ * Ograniczenia dotyczą wyszukiwań wykonywanych przez funkcje @ref newRoute
+ * i @ref extendRoute. Wartość 0 w polu struktury oznacza brak danego
+ * ograniczenia; domyślnie wyszukiwanie nie jest ograniczone.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param limits - ograniczenia: największa odległość od początku wyznaczanego
+ * fragmentu drogi, największa liczba sprawdzonych miast i czas w
+ * mikrosekundach.
+ */
+void setSearchLimits(Map *map, SearchLimits limits);
+
+/**@brief Podaje wynik ostatniego wyszukiwania drogi krajowej.
+ * Pozwala odróżnić przekroczenie ograniczeń wyszukiwania od braku drogi lub
+ * jej niejednoznaczności po nieudanym wywołaniu @ref newRoute lub
+ * @ref extendRoute.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Zwraca jedną ze stałych ROUTE_FOUND, ROUTE_NOT_FOUND,
+ * ROUTE_AMBIGUOUS, BUDGET_EXCEEDED lub SEARCH_ERROR.
+ */
+int searchStatus(Map *map);
+
+/**@brief Ustawia liczbę wątków wyszukiwań na całej mapie.
+ * Przy co najmniej jednym wątku funkcje @ref reachableCities
+ * i @ref routeDistances korzystają z algorytmu delta-stepping wykonywanego
+ * na podanej liczbie wątków, a funkcja @ref executeRouteRequests wykonuje
+ * na nich niezależne wyszukiwania. Przy zerze (domyślnie) funkcja
+ * @ref reachableCities korzysta z algorytmu Dijkstry, a funkcja
+ * @ref routeDistances z jednowątkowego algorytmu delta-stepping.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param threads - liczba wątków.
+ * @return Wartość @p true, jeśli udało się utworzyć wątki. Wartość @p false,
+ * jeśli nie udało się zaalokować pamięci lub uruchomić wątków; wtedy
+ * poprzednie ustawienie pozostaje bez zmian.
+ */
+bool setSearchThreads(Map *map, unsigned threads);
+
+/**@brief Wyznacza najlepsze drogi między dwoma zbiorami miast.
+ * Dla każdej pary miast (@p sources[i], @p targets[j]) wyznacza długość i datę
+ * remontu najstarszego odcinka najlepszej drogi (w sensie funkcji
+ * @ref newRoute) oraz ostatni odcinek tej drogi i zapisuje je pod indeksem
+ * i * @p targetsNumber + j tablicy wyniku. Jeśli drogi nie ma, pole @p city
+ * ma wartość NULL.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param sources - tablica nazw miast początkowych;
+ * @param sourcesNumber - liczba miast początkowych;
+ * @param targets - tablica nazw miast końcowych;
+ * @param targetsNumber - liczba miast końcowych;
+ * @param result - tablica o rozmiarze @p sourcesNumber * @p targetsNumber.
+ * @return Wartość @p true, jeśli wynik został wyznaczony.
+ * Wartość @p false, jeśli wystąpił błąd: któryś z parametrów ma niepoprawną
+ * wartość, któreś z miast nie istnieje lub nie udało się zaalokować pamięci.
+ */
+bool routeDistances(Map *map, const char **sources, unsigned sourcesNumber,
+                    const char **targets, unsigned targetsNumber,
+                    ReachedCity *result);
+
+/**@brief Podaje statystyki pamięci podręcznej wyszukiwań.
+ * Wyniki wyszukiwań wykonywanych przez funkcje @ref newRoute
+ * i @ref extendRoute są zapamiętywane do czasu zmiany odcinków dróg na mapie
+ * lub zmiany przebiegu drogi krajowej, od której zależą.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Zwraca liczbę wyszukiwań, których wynik był w pamięci podręcznej,
+ * i liczbę wyszukiwań wykonanych od nowa.
+ */
+CacheStatistics cacheStatistics(Map *map);
+
+/**
+ * Struktura przechowująca liczbę wyszukań miast i odcinków dróg po nazwie.
+ */
+typedef struct LookupStatistics {
+  unsigned long long segments; ///< Liczba odcinków dodanych do dróg krajowych.
+  unsigned long long cities; ///< Liczba wyszukań miast po nazwie.
+  unsigned long long roads; ///< Liczba wyszukań odcinków dróg po nazwie.
+} LookupStatistics;
+
+/**@brief Podaje statystyki wyszukań po nazwie.
+ * Liczone są wyszukania wykonywane przy dodawaniu odcinków dróg, zmianie ich
+ * dat remontu i tworzeniu dróg krajowych o podanym przebiegu; dodanie miasta
+ * do hashmapy liczy się jako jedno wyszukanie.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Zwraca liczby wyszukań od utworzenia mapy lub same zera, jeśli
+ * wskaźnik ma wartość NULL.
+ */
+LookupStatistics lookupStatistics(Map *map);
+
+/**@brief Włącza lub wyłącza nakładkę podziału mapy.
+ * Przy włączonej nakładce funkcja @ref overlayRouteDistance dzieli mapę na
+ * komórki kilku poziomów i pamięta najlepsze drogi między miastami
+ * brzegowymi komórek (zob. overlay.h). Zmiana daty remontu lub usunięcie
+ * odcinka drogi wymaga przeliczenia tylko komórek zawierających ten odcinek,
+ * a dodanie odcinka drogi - wyznaczenia podziału od nowa.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param enabled - informacja, czy nakładka ma być włączona.
+ * @return Wartość @p true, jeśli udało się zmienić ustawienie. Wartość
+ * @p false, jeśli któryś z parametrów ma niepoprawną wartość lub nie udało
+ * się zaalokować pamięci.
+ */
+bool enableOverlay(Map *map, bool enabled);
+
+/**@brief Wyznacza najlepszą drogę między dwoma miastami za pomocą nakładki.
+ * Zapisuje długość i datę remontu najstarszego odcinka najlepszej drogi (w
+ * sensie funkcji @ref newRoute, ale bez uwzględniania dróg krajowych) tak jak
+ * funkcja @ref routeDistances, przy czym pola @p previous i @p connection
+ * mają wartość NULL.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg;
+ * @param city1 - wskaźnik na napis reprezentujący nazwę miasta początkowego;
+ * @param city2 - wskaźnik na napis reprezentujący nazwę miasta końcowego;
+ * @param result - wskaźnik na strukturę, do której zostanie zapisany wynik.
+ * @return Wartość @p true, jeśli wynik został wyznaczony.
+ * Wartość @p false, jeśli wystąpił błąd: nakładka nie jest włączona, któryś
+ * z parametrów ma niepoprawną wartość, któreś z miast nie istnieje lub nie
+ * udało się zaalokować pamięci.
+ */
+bool overlayRouteDistance(Map *map, const char *city1, const char *city2,
+                          ReachedCity *result);
+
+/**@brief Podaje statystyki nakładki podziału mapy.
+ * @param map - wskaźnik na strukturę przechowującą mapę dróg.
+ * @return Zwraca liczbę poziomów i komórek bieżącego podziału oraz liczbę
+ * jego wyznaczeń i przeliczeń komórek lub same zera, jeśli nakładka nie jest
+ * włączona.
+ */
+OverlayStatistics partitionStatistics(Map *map);
+
 #endif /* __MAP_H__ */
@@ -1,23 +1,67 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <unistd.h>
+
 #include "map.h"
 #include "input.h"
 #include "execute.h"
+#include "output.h"
+
+#define BLOCK_SIZE 1024 ///< Największa liczba komend wykonywanych naraz.
 
 int main(void) {
   Map *map = newMap();
   if (!map) {
     return 0;
   }
+  long processors = sysconf(_SC_NPROCESSORS_ONLN);
+  if (processors > 1) {
+    setSearchThreads(map, (unsigned) processors);
+  }
+  Command *block = malloc(BLOCK_SIZE * sizeof(Command));
+  if (!block || !startBlockInput() ||
+      (binaryInput() && !startBinaryOutput())) {
+    finishBlockInput();
+    free(block);
+    deleteMap(map);
+    return 0;
+  }
+  for (unsigned i = 0; i < BLOCK_SIZE; i++) {
+    initCommand(&block[i]);
+  }
   int line = 1;
-  Command command = readLine();
-  while (command.commandType != EOF_FOUND) {
-    if (!executeCommand(command, map, &line)) {
-      deleteCommand(command);
-      deleteMap(map);
-      return 0;
+  unsigned number = 0;
+  bool success = true;
+  while (success) {
+    if (number > 0 && !inputReady()) {
+      success = executeCommands(block, number, map, &line);
+      number = 0;
+      if (!success) {
+        break;
+      }
+    }
+    Command *command = &block[number];
+    readLine(command);
+    if (command->commandType == EOF_FOUND) {
+      break;
+    }
+    number++;
+    if (number == BLOCK_SIZE || !isRouteCommand(*command)) {
+      success = executeCommands(block, number, map, &line);
+      number = 0;
     }
-    deleteCommand(command);
-    command = readLine();
   }
+  if (success) {
+    executeCommands(block, number, map, &line);
+  }
+  for (unsigned i = 0; i < BLOCK_SIZE; i++) {
+    deleteCommand(&block[i]);
+  }
+  finishBlockInput();
+  finishBinaryOutput();
+  finishExecution();
+  free(block);
   deleteMap(map);
   return 0;
-}
\ No newline at end of file
+}
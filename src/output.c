@@ -1,53 +1,124 @@
 #include <stdlib.h>
+#include <stdarg.h>
 #include <string.h>
 #include <stdio.h>
 
 #include "output.h"
 #include "structures.h"
+#include "binary.h"
+
+///Początkowy rozmiar bufora opisu drogi krajowej.
+#define DESCRIPTION_SIZE 64
+
+///Zapisywany strumień odpowiedzi lub NULL, jeśli odpowiedzi są tekstowe.
+static BinaryWriter *responses = NULL;
+
+bool startBinaryOutput(void) {
+  if (!responses) {
+    responses = newBinaryWriter(stdout, RESPONSE_MAGIC);
+  }
+  return responses != NULL;
+}
+
+void finishBinaryOutput(void) {
+  deleteBinaryWriter(responses);
+  responses = NULL;
+}
+
+void printDescription(const char *description) {
+  if (responses) {
+    writeDescription(responses, description);
+  }
+  else {
+    printf("%s\n", description);
+  }
+}
 
 void executeError(int n) {
-  fprintf(stderr, "ERROR %d\n", n);
+  if (responses) {
+    writeError(responses, n);
+  }
+  else {
+    fprintf(stderr, "ERROR %d\n", n);
+  }
 }
 
-char const *getRouteDescriptionOut(Route *route, unsigned routeId) {
-  if (!route) {
-    char *str = malloc(sizeof(char));
-    if (!str) {
-      return NULL;
+/**@brief Dopisuje sformatowany fragment opisu do bufora.
+ * Powiększa bufor dwukrotnie, dopóki fragment się w nim nie zmieści.
+ * @param buffer - wskaźnik na zaalokowany bufor opisu;
+ * @param capacity - wskaźnik na rozmiar bufora;
+ * @param length - wskaźnik na długość zapisanej części opisu;
+ * @param format - format fragmentu tak jak w printf().
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+static bool appendFragment(char **buffer, size_t *capacity, size_t *length,
+                           const char *format, ...) {
+  while (true) {
+    va_list arguments;
+    va_start(arguments, format);
+    int written = vsnprintf(*buffer + *length, *capacity - *length, format,
+                            arguments);
+    va_end(arguments);
+    if (written < 0) {
+      return false;
     }
-    str[0] = '\0';
-    return str;
-  }
-  long descriptLength = snprintf(NULL, 0, "%u%c%s%c", routeId, ';',
-                                 route->city1->name, ';');
-  char *description = malloc((descriptLength + 1) * sizeof(char));
-  const char *previousCity = route->city1->name;
-  RoadList *temp = route->roads;
-  snprintf(description, descriptLength + 1, "%u%c%s%c", routeId, ';',
-           route->city1->name, ';');
-  while (temp) {
-    int fragmentLength = 0;
-    const char *cityName = NULL;
-    if (strcmp(temp->road->city1->name, previousCity) != 0) {
-      cityName = temp->road->city1->name;
+    if (*length + (size_t) written < *capacity) {
+      *length += (size_t) written;
+      return true;
     }
-    else {
-      cityName = temp->road->city2->name;
+    size_t newCapacity = 2 * *capacity;
+    while (newCapacity <= *length + (size_t) written) {
+      newCapacity *= 2;
     }
-    fragmentLength = snprintf(NULL, 0, "%u%c%d%c%s%c", temp->road->length, ';',
-                              temp->road->lastRepair, ';', cityName, ';');
-    descriptLength += fragmentLength + 1;
-    char *fragment = malloc(
-            (descriptLength) * sizeof(char));
-    snprintf(fragment, descriptLength, "%s%u%c%d%c%s%c", description,
-             temp->road->length, ';', temp->road->lastRepair, ';', cityName, ';');
+    char *newBuffer = realloc(*buffer, newCapacity);
+    if (!newBuffer) {
+      return false;
+    }
+    *buffer = newBuffer;
+    *capacity = newCapacity;
+  }
+}
+
+bool describeRoute(Route *route, unsigned routeId, char **buffer,
+                   size_t *capacity) {
+  if (*capacity == 0) {
+    char *newBuffer = malloc(DESCRIPTION_SIZE);
+    if (!newBuffer) {
+      return false;
+    }
+    *buffer = newBuffer;
+    *capacity = DESCRIPTION_SIZE;
+  }
+  (*buffer)[0] = '\0';
+  if (!route) {
+    return true;
+  }
+  size_t length = 0;
+  City *previousCity = route->city1;
+  if (!appendFragment(buffer, capacity, &length, "%u;%s", routeId,
+                      previousCity->name)) {
+    return false;
+  }
+  for (RoadList *temp = route->roads; temp; temp = temp->next) {
+    Road *road = temp->road;
+    City *city = isEqual(road->city1, previousCity) ? road->city2 :
+                 road->city1;
+    if (!appendFragment(buffer, capacity, &length, ";%u;%d;%s", road->length,
+                        road->lastRepair, city->name)) {
+      return false;
+    }
+    previousCity = city;
+  }
+  return true;
+}
+
+char const *getRouteDescriptionOut(Route *route, unsigned routeId) {
+  char *description = NULL;
+  size_t capacity = 0;
+  if (!describeRoute(route, routeId, &description, &capacity)) {
     free(description);
-    description = malloc((fragmentLength + descriptLength + 1) * sizeof(char));
-    strcpy(description, fragment);
-    free(fragment);
-    previousCity = cityName;
-    temp = temp->next;
+    return NULL;
   }
-  description[strlen(description) - 1] = '\0';
   return description;
-}
\ No newline at end of file
+}
@@ -1,12 +1,36 @@
 #ifndef DROGI_OUTPUT_H
 #define DROGI_OUTPUT_H
 
+#include <stdbool.h>
 #include "structures.h"
 
+/**@brief Przełącza wypisywanie odpowiedzi na format binarny.
+ * Zapisuje na standardowe wyjście nagłówek strumienia odpowiedzi opisanego
+ * w binary.h. Kolejne opisy dróg krajowych i informacje o błędach są zapisywane
+ * jako jego rekordy.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ * W przeciwnym razie zwraca @p true.
+ */
+bool startBinaryOutput(void);
+
+/**@brief Kończy wypisywanie odpowiedzi w formacie binarnym.
+ * Opróżnia bufor standardowego wyjścia i zwalnia pamięć.
+ */
+void finishBinaryOutput(void);
+
+/**
+ * Wypisuje na standardowe wyjście opis drogi krajowej zakończony znakiem
+ * '\n' lub zapisuje go jako rekord strumienia odpowiedzi.
+ * @param description - opis drogi krajowej utworzony przez
+ * getRouteDescription().
+ */
+void printDescription(const char *description);
+
 /**
  * Wypisuje na standardowe wyjście diagnostyczne jednoliniowy komunikat ERROR n,
  * gdzie n jest numerem linii w danych wejściowych zawierającym to polecenie.
  * Linie numerowane są od jedynki (ignorowane linie są uwzględniane).
+ * Po wywołaniu startBinaryOutput() zapisuje rekord BINARY_WRONG.
  * @param n - numer linii wejścia.
  */
 void executeError(int n);
@@ -21,4 +45,21 @@ void executeError(int n);
  */
 char const *getRouteDescriptionOut(Route *allRoutes, unsigned routeId);
 
+/**
+ * Zapisuje informacje o drodze krajowej do bufora używanego ponownie przez
+ * kolejne wywołania. Bufor jest powiększany tylko wtedy, gdy opis się w nim
+ * nie mieści.
+ * @param route - wskaźnik na drogę krajową lub NULL;
+ * @param routeId - numer drogi krajowej;
+ * @param buffer - wskaźnik na bufor zaalokowany przez wcześniejsze wywołanie
+ * lub na NULL, jeśli @p capacity wskazuje na 0;
+ * @param capacity - wskaźnik na rozmiar bufora.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci; bufor
+ * pozostaje wtedy do zwolnienia przez wywołującego. W przeciwnym razie zwraca
+ * @p true, a bufor zawiera napis taki jak zwracany przez
+ * getRouteDescriptionOut().
+ */
+bool describeRoute(Route *route, unsigned routeId, char **buffer,
+                   size_t *capacity);
+
 #endif //DROGI_OUTPUT_H
@@ -0,0 +1,581 @@
+/**@file
+ * Implementacja overlay.h.
+ *
+ * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
+ * @date 01.09.2019
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+
+#include "overlay.h"
+#include "priority_queue.h"
+
+#define NO_CELL UINT_MAX ///< Oznaczenie miasta lub komórki bez przydziału.
+#define NO_POSITION UINT_MAX ///< Oznaczenie miasta, które nie jest brzegowe.
+#define UNREACHED UINT64_MAX ///< Klucz miasta, do którego nie ma drogi.
+#define UNRESTRICTED UINT_MAX ///< Oznaczenie wyszukiwania na całej mapie.
+
+/**
+ * Struktura przechowująca komórkę podziału.
+ */
+typedef struct Cell {
+  unsigned *boundary; ///< Indeksy miast brzegowych komórki.
+  unsigned boundaryNumber; ///< Liczba miast brzegowych.
+  ///Klucze najlepszych dróg wewnątrz komórki między miastami brzegowymi:
+  ///wiersz i zawiera drogi z miasta boundary[i].
+  uint64_t *clique;
+  bool dirty; ///< Informacja, czy drogi trzeba wyznaczyć od nowa.
+} Cell;
+
+/**
+ * Struktura przechowująca jeden poziom podziału.
+ */
+typedef struct Level {
+  Cell *cells; ///< Komórki poziomu.
+  unsigned cellsNumber; ///< Liczba komórek.
+  unsigned *cellOf; ///< Numer komórki każdego miasta.
+  ///Pozycja każdego miasta wśród miast brzegowych jego komórki lub
+  ///NO_POSITION.
+  unsigned *position;
+  unsigned *members; ///< Indeksy miast uporządkowane według komórek.
+  ///Początek miast każdej komórki w tablicy @p members; ostatni element to
+  ///liczba miast.
+  unsigned *firstMember;
+  bool dirty; ///< Informacja, czy któraś komórka wymaga przeliczenia.
+} Level;
+
+/**
+ * Struktura przechowująca podział mapy i nakładkę odległości.
+ */
+struct Overlay {
+  Level levels[OVERLAY_LEVELS]; ///< Poziomy podziału od najniższego.
+  unsigned levelsNumber; ///< Liczba poziomów.
+  City **cities; ///< Miasta pod indeksami citiesArrayIndex.
+  unsigned citiesNumber; ///< Liczba miast w chwili wyznaczenia podziału.
+  bool valid; ///< Informacja, czy podział odpowiada mapie.
+  uint64_t *keys; ///< Klucze miast w bieżącym wyszukiwaniu.
+  unsigned *mark; ///< Numer wyszukiwania, w którym miasto osiągnięto.
+  unsigned search; ///< Numer bieżącego wyszukiwania.
+  unsigned *buffer; ///< Kolejka używana przy wyznaczaniu podziału.
+  PriorityQueue *queue; ///< Kolejka priorytetowa wyszukiwania.
+  OverlayStatistics statistics; ///< Statystyki.
+};
+
+Overlay *newOverlay(void) {
+  return calloc(1, sizeof(Overlay));
+}
+
+/**
+ * Zwalnia pamięć podziału, pozostawiając pustą strukturę.
+ * @param overlay - wskaźnik na strukturę nakładki.
+ */
+static void freeLevels(Overlay *overlay) {
+  for (unsigned l = 0; l < overlay->levelsNumber; l++) {
+    Level *level = &(overlay->levels[l]);
+    for (unsigned i = 0; level->cells && i < level->cellsNumber; i++) {
+      free(level->cells[i].boundary);
+      free(level->cells[i].clique);
+    }
+    free(level->cells);
+    free(level->cellOf);
+    free(level->position);
+    free(level->members);
+    free(level->firstMember);
+  }
+  overlay->levelsNumber = 0;
+  free(overlay->cities);
+  free(overlay->keys);
+  free(overlay->mark);
+  free(overlay->buffer);
+  overlay->cities = NULL;
+  overlay->keys = NULL;
+  overlay->mark = NULL;
+  overlay->buffer = NULL;
+  overlay->citiesNumber = 0;
+  overlay->valid = false;
+}
+
+void freeOverlay(Overlay *overlay) {
+  if (overlay) {
+    freeLevels(overlay);
+    if (overlay->queue) {
+      freePriorityQueue(overlay->queue);
+    }
+    free(overlay);
+  }
+}
+
+void invalidateOverlay(Overlay *overlay) {
+  if (overlay) {
+    overlay->valid = false;
+  }
+}
+
+void overlayRoadChanged(Overlay *overlay, City *city1, City *city2) {
+  if (!overlay || !overlay->valid) {
+    return;
+  }
+  unsigned index1 = city1->citiesArrayIndex;
+  unsigned index2 = city2->citiesArrayIndex;
+  if (index1 >= overlay->citiesNumber || index2 >= overlay->citiesNumber) {
+    overlay->valid = false;
+    return;
+  }
+  for (unsigned l = 0; l < overlay->levelsNumber; l++) {
+    Level *level = &(overlay->levels[l]);
+    if (level->cellOf[index1] == level->cellOf[index2]) {
+      level->cells[level->cellOf[index1]].dirty = true;
+      level->dirty = true;
+    }
+  }
+}
+
+/**
+ * Tworzy klucz z odległości i daty najstarszego remontu.
+ * @param distance - odległość od startu;
+ * @param oldestRoad - data remontu najdawniej remontowanego odcinka.
+ * @return Zwraca klucz, mniejszy dla lepszej drogi.
+ */
+static uint64_t packKey(unsigned distance, int oldestRoad) {
+  return ((uint64_t) distance << 32) |
+         (uint32_t) ((int64_t) INT_MAX - oldestRoad);
+}
+
+/**
+ * Wyznacza klucz drogi złożonej z dwóch dróg. Klucz 0 odpowiada drodze pustej.
+ * @param first - klucz pierwszej drogi;
+ * @param second - klucz drugiej drogi.
+ * @return Zwraca klucz drogi złożonej: sumę odległości i wcześniejszą
+ * z dat najstarszego remontu, lub UNREACHED, jeśli suma odległości
+ * przekracza UINT_MAX.
+ */
+static uint64_t joinKeys(uint64_t first, uint64_t second) {
+  uint64_t low1 = first & UINT32_MAX, low2 = second & UINT32_MAX;
+  uint64_t distance = (first >> 32) + (second >> 32);
+  if (distance > UINT_MAX) {
+    return UNREACHED;
+  }
+  return (distance << 32) | (low1 > low2 ? low1 : low2);
+}
+
+/**
+ * Podaje indeks drugiego końca odcinka drogi.
+ * @param city - wskaźnik na jeden z końców odcinka;
+ * @param road - wskaźnik na odcinek drogi.
+ * @return Zwraca citiesArrayIndex drugiego końca odcinka.
+ */
+static unsigned otherEnd(City *city, Road *road) {
+  return (isEqual(city, road->city1) ? road->city2 : road->city1)->
+          citiesArrayIndex;
+}
+
+/**
+ * Zapisuje miasta hashmapy pod ich indeksami i przydziela tablice
+ * indeksowane numerami miast.
+ * @param overlay - wskaźnik na strukturę nakładki;
+ * @param hashMap - hashmapa miast.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ */
+static bool collectCities(Overlay *overlay, CityHashMap *hashMap) {
+  unsigned number = numberOfCities(hashMap);
+  overlay->citiesNumber = number;
+  overlay->cities = malloc(number * sizeof(City *));
+  overlay->keys = malloc(number * sizeof(uint64_t));
+  overlay->mark = calloc(number, sizeof(unsigned));
+  overlay->buffer = malloc(number * sizeof(unsigned));
+  overlay->search = 0;
+  if (!overlay->cities || !overlay->keys || !overlay->mark ||
+      !overlay->buffer) {
+    return false;
+  }
+  if (!overlay->queue && !(overlay->queue = newPriorityQueue(number))) {
+    return false;
+  }
+  if (!reservePriorityQueue(overlay->queue, number)) {
+    return false;
+  }
+  CityList **lists = showCities(hashMap);
+  for (unsigned i = 0; i < CITIES_NUMBER; i++) {
+    for (CityList *temp = lists[i]; temp; temp = temp->next) {
+      overlay->cities[temp->city->citiesArrayIndex] = temp->city;
+    }
+  }
+  return true;
+}
+
+/**@brief Dzieli miasta lub komórki na komórki kolejnego poziomu.
+ * Komórki są wyznaczane przeszukiwaniem wszerz: od pierwszej nieprzydzielonej
+ * jednostki przydziela do nowej komórki kolejne sąsiednie jednostki, dopóki
+ * komórka nie osiągnie największego rozmiaru. Jednostkami poziomu 0 są
+ * miasta, a wyższych poziomów komórki poziomu niższego.
+ * @param overlay - wskaźnik na strukturę nakładki;
+ * @param level - numer wyznaczanego poziomu;
+ * @param group - tablica, do której zostanie zapisany numer komórki każdej
+ * jednostki.
+ * @return Zwraca liczbę wyznaczonych komórek.
+ */
+static unsigned groupUnits(Overlay *overlay, unsigned level, unsigned *group) {
+  Level *lower = level > 0 ? &(overlay->levels[level - 1]) : NULL;
+  unsigned units = lower ? lower->cellsNumber : overlay->citiesNumber;
+  unsigned limit = lower ? OVERLAY_FANOUT : OVERLAY_CELL_SIZE;
+  unsigned cells = 0;
+  for (unsigned i = 0; i < units; i++) {
+    group[i] = NO_CELL;
+  }
+  for (unsigned first = 0; first < units; first++) {
+    if (group[first] != NO_CELL) {
+      continue;
+    }
+    unsigned head = 0, tail = 0;
+    group[first] = cells;
+    overlay->buffer[tail++] = first;
+    while (head < tail && tail < limit) {
+      unsigned unit = overlay->buffer[head++];
+      unsigned begin = lower ? lower->firstMember[unit] : 0;
+      unsigned end = lower ? lower->firstMember[unit + 1] : 1;
+      for (unsigned m = begin; m < end && tail < limit; m++) {
+        City *city = overlay->cities[lower ? lower->members[m] : unit];
+        for (unsigned j = 0; j < city->degree && tail < limit; j++) {
+          unsigned next = otherEnd(city, city->adjacent[j]);
+          if (lower) {
+            next = lower->cellOf[next];
+          }
+          if (group[next] == NO_CELL) {
+            group[next] = cells;
+            overlay->buffer[tail++] = next;
+          }
+        }
+      }
+    }
+    cells++;
+  }
+  return cells;
+}
+
+/**@brief Wypełnia poziom podziału na podstawie numerów komórek miast.
+ * Wyznacza listy miast komórek, miasta brzegowe i ich pozycje oraz przydziela
+ * pamięć na drogi między miastami brzegowymi. Miasta brzegowe są najpierw
+ * oznaczane pozycją 0, a potem numerowane kolejno w ramach komórki. Wszystkie
+ * komórki są oznaczane do przeliczenia.
+ * @param overlay - wskaźnik na strukturę nakładki;
+ * @param level - wskaźnik na wypełniany poziom z wypełnionymi polami
+ * @p cellOf i @p cellsNumber.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci.
+ */
+static bool fillLevel(Overlay *overlay, Level *level) {
+  unsigned number = overlay->citiesNumber;
+  level->position = malloc(number * sizeof(unsigned));
+  level->members = malloc(number * sizeof(unsigned));
+  level->firstMember = calloc(level->cellsNumber + 1, sizeof(unsigned));
+  level->cells = calloc(level->cellsNumber, sizeof(Cell));
+  if (!level->position || !level->members || !level->firstMember ||
+      !level->cells) {
+    return false;
+  }
+  for (unsigned i = 0; i < number; i++) {
+    (level->firstMember[level->cellOf[i] + 1])++;
+  }
+  for (unsigned c = 0; c < level->cellsNumber; c++) {
+    level->firstMember[c + 1] += level->firstMember[c];
+  }
+  for (unsigned c = 0; c < level->cellsNumber; c++) {
+    overlay->buffer[c] = level->firstMember[c];
+  }
+  for (unsigned i = 0; i < number; i++) {
+    level->members[(overlay->buffer[level->cellOf[i]])++] = i;
+  }
+  for (unsigned i = 0; i < number; i++) {
+    City *city = overlay->cities[i];
+    level->position[i] = NO_POSITION;
+    for (unsigned j = 0; j < city->degree; j++) {
+      if (level->cellOf[otherEnd(city, city->adjacent[j])] !=
+          level->cellOf[i]) {
+        level->position[i] = 0;
+        break;
+      }
+    }
+  }
+  for (unsigned c = 0; c < level->cellsNumber; c++) {
+    Cell *cell = &(level->cells[c]);
+    cell->dirty = true;
+    for (unsigned m = level->firstMember[c]; m < level->firstMember[c + 1];
+         m++) {
+      cell->boundaryNumber += (level->position[level->members[m]] == 0);
+    }
+    if (cell->boundaryNumber == 0) {
+      continue;
+    }
+    cell->boundary = malloc(cell->boundaryNumber * sizeof(unsigned));
+    cell->clique = malloc((size_t) cell->boundaryNumber *
+                          cell->boundaryNumber * sizeof(uint64_t));
+    if (!cell->boundary || !cell->clique) {
+      return false;
+    }
+    unsigned position = 0;
+    for (unsigned m = level->firstMember[c]; m < level->firstMember[c + 1];
+         m++) {
+      unsigned city = level->members[m];
+      if (level->position[city] == 0) {
+        level->position[city] = position;
+        cell->boundary[position++] = city;
+      }
+    }
+  }
+  level->dirty = true;
+  return true;
+}
+
+/**@brief Wyznacza podział mapy od nowa.
+ * Wyznacza kolejne poziomy, dopóki na najwyższym jest więcej niż jedna
+ * komórka, łączenie zmniejsza liczbę komórek i nie osiągnięto największej
+ * liczby poziomów.
+ * @param overlay - wskaźnik na strukturę nakładki;
+ * @param hashMap - hashmapa miast.
+ * @return Zwraca @p false, jeśli mapa jest pusta lub nie udało się
+ * zaalokować pamięci.
+ */
+static bool buildOverlay(Overlay *overlay, CityHashMap *hashMap) {
+  freeLevels(overlay);
+  if (numberOfCities(hashMap) == 0 || !collectCities(overlay, hashMap)) {
+    return false;
+  }
+  (overlay->statistics.builds)++;
+  unsigned number = overlay->citiesNumber;
+  while (overlay->levelsNumber < OVERLAY_LEVELS) {
+    unsigned l = overlay->levelsNumber;
+    Level *level = &(overlay->levels[l]);
+    Level *lower = l > 0 ? &(overlay->levels[l - 1]) : NULL;
+    if (lower && lower->cellsNumber <= 1) {
+      break;
+    }
+    *level = (Level) {NULL, 0, NULL, NULL, NULL, NULL, false};
+    unsigned units = lower ? lower->cellsNumber : number;
+    unsigned *group = malloc(units * sizeof(unsigned));
+    if (!group) {
+      return false;
+    }
+    level->cellsNumber = groupUnits(overlay, l, group);
+    if (lower && level->cellsNumber == lower->cellsNumber) {
+      free(group);
+      break;
+    }
+    if (lower) {
+      level->cellOf = malloc(number * sizeof(unsigned));
+      if (level->cellOf) {
+        for (unsigned i = 0; i < number; i++) {
+          level->cellOf[i] = group[lower->cellOf[i]];
+        }
+      }
+      free(group);
+    }
+    else {
+      level->cellOf = group;
+    }
+    (overlay->levelsNumber)++;
+    if (!level->cellOf || !fillLevel(overlay, level)) {
+      return false;
+    }
+  }
+  overlay->valid = true;
+  return true;
+}
+
+/**
+ * Rozpoczyna nowe wyszukiwanie, unieważniając klucze wszystkich miast.
+ * @param overlay - wskaźnik na strukturę nakładki.
+ */
+static void beginSearch(Overlay *overlay) {
+  clearPriorityQueue(overlay->queue);
+  if (++overlay->search == 0) {
+    for (unsigned i = 0; i < overlay->citiesNumber; i++) {
+      overlay->mark[i] = 0;
+    }
+    overlay->search = 1;
+  }
+}
+
+/**
+ * Podaje klucz miasta w bieżącym wyszukiwaniu.
+ * @param overlay - wskaźnik na strukturę nakładki;
+ * @param city - indeks miasta.
+ * @return Zwraca klucz miasta lub UNREACHED, jeśli nie zostało osiągnięte.
+ */
+static uint64_t keyOf(Overlay *overlay, unsigned city) {
+  return overlay->mark[city] == overlay->search ? overlay->keys[city] :
+          UNREACHED;
+}
+
+/**
+ * Zapisuje klucz miasta i dodaje je do kolejki, jeśli klucz jest lepszy od
+ * dotychczasowego.
+ * @param overlay - wskaźnik na strukturę nakładki;
+ * @param city - indeks miasta;
+ * @param key - klucz drogi do miasta.
+ */
+static void reach(Overlay *overlay, unsigned city, uint64_t key) {
+  if (key < keyOf(overlay, city)) {
+    overlay->keys[city] = key;
+    overlay->mark[city] = overlay->search;
+    insert(city, key, overlay->queue);
+  }
+}
+
+/**@brief Przegląda drogi wychodzące z miasta na danym poziomie.
+ * Na poziomie 0 są to wszystkie odcinki dróg wychodzące z miasta. Na poziomie
+ * l > 0 są to zapamiętane drogi w komórce poziomu l - 1 zawierającej miasto
+ * oraz odcinki dróg prowadzące do innych komórek tego poziomu.
+ * @param overlay - wskaźnik na strukturę nakładki;
+ * @param city - indeks miasta;
+ * @param level - poziom przeglądanych dróg;
+ * @param restrictLevel - poziom komórki, z której nie wolno wyjść, lub
+ * UNRESTRICTED;
+ * @param restrictCell - numer komórki, z której nie wolno wyjść.
+ */
+static void relaxCity(Overlay *overlay, unsigned city, unsigned level,
+                      unsigned restrictLevel, unsigned restrictCell) {
+  uint64_t key = overlay->keys[city];
+  unsigned *lowerCell = NULL;
+  if (level > 0) {
+    Level *lower = &(overlay->levels[level - 1]);
+    lowerCell = lower->cellOf;
+    unsigned position = lower->position[city];
+    if (position != NO_POSITION) {
+      Cell *cell = &(lower->cells[lowerCell[city]]);
+      uint64_t *row = cell->clique + (size_t) position * cell->boundaryNumber;
+      for (unsigned j = 0; j < cell->boundaryNumber; j++) {
+        if (row[j] != UNREACHED) {
+          reach(overlay, cell->boundary[j], joinKeys(key, row[j]));
+        }
+      }
+    }
+  }
+  unsigned *restrictOf = restrictLevel != UNRESTRICTED ?
+          overlay->levels[restrictLevel].cellOf : NULL;
+  City *from = overlay->cities[city];
+  for (unsigned j = 0; j < from->degree; j++) {
+    Road *road = from->adjacent[j];
+    unsigned next = otherEnd(from, road);
+    if ((lowerCell && lowerCell[next] == lowerCell[city]) ||
+        (restrictOf && restrictOf[next] != restrictCell)) {
+      continue;
+    }
+    reach(overlay, next,
+          joinKeys(key, packKey(road->length, road->lastRepair)));
+  }
+}
+
+/**
+ * Wyznacza od nowa drogi między miastami brzegowymi komórki.
+ * @param overlay - wskaźnik na strukturę nakładki;
+ * @param level - numer poziomu komórki;
+ * @param cellNumber - numer komórki.
+ */
+static void customizeCell(Overlay *overlay, unsigned level,
+                          unsigned cellNumber) {
+  Cell *cell = &(overlay->levels[level].cells[cellNumber]);
+  for (unsigned i = 0; i < cell->boundaryNumber; i++) {
+    beginSearch(overlay);
+    reach(overlay, cell->boundary[i], 0);
+    while (!isEmpty(overlay->queue)) {
+      relaxCity(overlay, (unsigned) pop(overlay->queue), level, level,
+                cellNumber);
+    }
+    uint64_t *row = cell->clique + (size_t) i * cell->boundaryNumber;
+    for (unsigned j = 0; j < cell->boundaryNumber; j++) {
+      row[j] = keyOf(overlay, cell->boundary[j]);
+    }
+  }
+  cell->dirty = false;
+  (overlay->statistics.customized)++;
+}
+
+/**
+ * Przelicza oznaczone komórki, od najniższego poziomu.
+ * @param overlay - wskaźnik na strukturę nakładki.
+ */
+static void customize(Overlay *overlay) {
+  for (unsigned l = 0; l < overlay->levelsNumber; l++) {
+    Level *level = &(overlay->levels[l]);
+    if (!level->dirty) {
+      continue;
+    }
+    for (unsigned c = 0; c < level->cellsNumber; c++) {
+      if (level->cells[c].dirty) {
+        customizeCell(overlay, l, c);
+      }
+    }
+    level->dirty = false;
+  }
+}
+
+/**
+ * Wyznacza poziom dróg przeglądanych z miasta: najwyższy poziom, na którym
+ * miasto leży w innej komórce niż miasto początkowe i końcowe, powiększony
+ * o 1, lub 0, jeśli miasto leży w komórce poziomu 0 któregoś z nich.
+ * @param overlay - wskaźnik na strukturę nakładki;
+ * @param city - indeks miasta;
+ * @param start - indeks miasta początkowego;
+ * @param finish - indeks miasta końcowego.
+ * @return Zwraca poziom dróg.
+ */
+static unsigned queryLevel(Overlay *overlay, unsigned city, unsigned start,
+                           unsigned finish) {
+  for (unsigned l = overlay->levelsNumber; l > 0; l--) {
+    unsigned *cellOf = overlay->levels[l - 1].cellOf;
+    if (cellOf[city] != cellOf[start] && cellOf[city] != cellOf[finish]) {
+      return l;
+    }
+  }
+  return 0;
+}
+
+bool overlayDistance(Overlay *overlay, City *start, City *finish,
+                     CityHashMap *hashMap, ReachedCity *result) {
+  if (!overlay || !start || !finish || !result) {
+    return false;
+  }
+  if ((!overlay->valid || overlay->citiesNumber != numberOfCities(hashMap)) &&
+      !buildOverlay(overlay, hashMap)) {
+    freeLevels(overlay);
+    return false;
+  }
+  customize(overlay);
+  unsigned from = start->citiesArrayIndex, to = finish->citiesArrayIndex;
+  beginSearch(overlay);
+  reach(overlay, from, 0);
+  bool found = false;
+  while (!found && !isEmpty(overlay->queue)) {
+    unsigned city = (unsigned) pop(overlay->queue);
+    if (city == to) {
+      found = true;
+    }
+    else {
+      relaxCity(overlay, city, queryLevel(overlay, city, from, to),
+                UNRESTRICTED, 0);
+    }
+  }
+  uint64_t key = found ? overlay->keys[to] : 0;
+  result->city = found ? finish : NULL;
+  result->distance = (unsigned) (key >> 32);
+  result->oldestRoad = (found && from != to) ?
+          (int) ((int64_t) INT_MAX - (int64_t) (key & UINT32_MAX)) : 0;
+  result->previous = NULL;
+  result->connection = NULL;
+  return true;
+}
+
+OverlayStatistics overlayStatistics(Overlay *overlay) {
+  OverlayStatistics statistics = {0, 0, 0, 0};
+  if (!overlay) {
+    return statistics;
+  }
+  statistics = overlay->statistics;
+  statistics.levels = overlay->valid ? overlay->levelsNumber : 0;
+  statistics.cells = 0;
+  for (unsigned l = 0; overlay->valid && l < overlay->levelsNumber; l++) {
+    statistics.cells += overlay->levels[l].cellsNumber;
+  }
+  return statistics;
+}
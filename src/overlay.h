@@ -0,0 +1,104 @@
+/** @file
+ * Interfejs wielopoziomowego podziału mapy na komórki z nakładką odległości.
+ *
+ * Miasta są dzielone na spójne komórki, a komórki każdego poziomu są łączone
+ * w większe komórki następnego poziomu. Dla każdej komórki pamiętane są
+ * najlepsze drogi wewnątrz niej między jej miastami brzegowymi (miastami, z
+ * których wychodzi odcinek drogi do innej komórki tego samego poziomu).
+ * Wyszukiwanie przegląda odcinki dróg tylko w komórkach miasta początkowego
+ * i końcowego, a dalej korzysta z zapamiętanych dróg coraz wyższych poziomów.
+ *
+ * Zmiana długości lub daty remontu odcinka drogi albo jego usunięcie wymaga
+ * jedynie ponownego wyznaczenia dróg w komórkach zawierających ten odcinek,
+ * co jest wykonywane przy najbliższym wyszukiwaniu. Dodanie odcinka drogi lub
+ * miasta zmienia podział, więc nakładka jest wtedy budowana od nowa.
+ *
+ * Drogi są porównywane tak samo jak w findBestRoute(): najpierw długość,
+ * a przy równej długości późniejsza data remontu najdawniej remontowanego
+ * odcinka.
+ *
+ * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
+ * @date 01.09.2019
+ */
+
+#ifndef DROGI_OVERLAY_H
+#define DROGI_OVERLAY_H
+
+#include <stdbool.h>
+#include "structures.h"
+#include "city_hashmap.h"
+
+#define OVERLAY_CELL_SIZE 128 ///< Największa liczba miast w komórce poziomu 0.
+///Największa liczba komórek poziomu niższego w komórce kolejnego poziomu.
+#define OVERLAY_FANOUT 4
+#define OVERLAY_LEVELS 3 ///< Największa liczba poziomów podziału.
+
+/**
+ * Struktura przechowująca podział mapy i nakładkę odległości.
+ */
+typedef struct Overlay Overlay;
+
+/**
+ * Struktura przechowująca statystyki nakładki.
+ */
+typedef struct OverlayStatistics {
+  unsigned levels; ///< Liczba poziomów podziału.
+  unsigned cells; ///< Liczba komórek na wszystkich poziomach.
+  unsigned long long builds; ///< Liczba budowań nakładki od nowa.
+  unsigned long long customized; ///< Liczba ponownie przeliczonych komórek.
+} OverlayStatistics;
+
+/**@brief Tworzy nową strukturę.
+ * Podział jest wyznaczany przy pierwszym wyszukiwaniu.
+ * @return Zwraca wskaźnik na utworzoną strukturę lub NULL, jeśli nie udało się
+ * zaalokować pamięci.
+ */
+Overlay *newOverlay(void);
+
+/**@brief Usuwa strukturę.
+ * Zwalnia całą pamięć zaalokowaną przez strukturę.
+ * @param overlay - wskaźnik na usuwaną strukturę.
+ */
+void freeOverlay(Overlay *overlay);
+
+/**@brief Unieważnia podział mapy.
+ * Należy wywołać po dodaniu odcinka drogi lub miasta. Podział zostanie
+ * wyznaczony od nowa przy najbliższym wyszukiwaniu.
+ * @param overlay - wskaźnik na strukturę nakładki lub NULL.
+ */
+void invalidateOverlay(Overlay *overlay);
+
+/**@brief Oznacza komórki zawierające odcinek drogi do przeliczenia.
+ * Należy wywołać po zmianie daty remontu odcinka drogi lub przed jego
+ * usunięciem. Działa w czasie proporcjonalnym do liczby poziomów.
+ * @param overlay - wskaźnik na strukturę nakładki lub NULL;
+ * @param city1 - wskaźnik na jeden koniec odcinka;
+ * @param city2 - wskaźnik na drugi koniec odcinka.
+ */
+void overlayRoadChanged(Overlay *overlay, City *city1, City *city2);
+
+/**@brief Wyznacza najlepszą drogę między dwoma miastami.
+ * W razie potrzeby najpierw wyznacza podział mapy lub przelicza oznaczone
+ * komórki. Nie uwzględnia dróg krajowych.
+ * @param overlay - wskaźnik na strukturę nakładki;
+ * @param start - miasto początkowe;
+ * @param finish - miasto końcowe;
+ * @param hashMap - hashmapa miast;
+ * @param result - wskaźnik na strukturę, do której zostanie zapisana
+ * odległość i data remontu najstarszego odcinka najlepszej drogi. Pole
+ * @p city ma wartość @p finish lub NULL, jeśli drogi nie ma; pola
+ * @p previous i @p connection mają wartość NULL.
+ * @return Zwraca @p false, jeśli któryś z parametrów jest niepoprawny lub nie
+ * udało się zaalokować pamięci. W przeciwnym razie zwraca @p true.
+ */
+bool overlayDistance(Overlay *overlay, City *start, City *finish,
+                     CityHashMap *hashMap, ReachedCity *result);
+
+/**@brief Podaje statystyki nakładki.
+ * @param overlay - wskaźnik na strukturę nakładki.
+ * @return Zwraca rozmiar bieżącego podziału oraz liczbę budowań i przeliczeń
+ * komórek od utworzenia struktury.
+ */
+OverlayStatistics overlayStatistics(Overlay *overlay);
+
+#endif //DROGI_OVERLAY_H
@@ -3,20 +3,25 @@
 #include "priority_queue.h"
 #include "structures.h"
 
+///Wartość pozycji indeksu, który nie znajduje się w kolejce.
+#define ABSENT -1
+
 /**
- * Struktura przechowująca listę liczb całkowitych.
+ * Struktura przechowująca element kopca.
  */
-typedef struct IntList {
-  int index; ///< Liczba całkowita
-  struct IntList *next; ///< Wskaźnik na następny element listy
-} IntList;
+typedef struct HeapNode {
+  uint64_t key; ///< Klucz elementu.
+  unsigned index; ///< Indeks elementu.
+} HeapNode;
 
 /**
- * Struktura przechowująca kolejkę priorytetową.
+ * Struktura przechowująca kolejkę priorytetową w postaci kopca binarnego.
  */
 struct PriorityQueue {
-  IntList *head; ///< Początek listy przechowującej liczby.
-  unsigned maxIndex; ///< Największy możliwy indeks w kolejce.
+  HeapNode *heap; ///< Tablica przechowująca kopiec.
+  int *position; ///< Pozycja w kopcu dla każdego indeksu lub ABSENT.
+  unsigned size; ///< Liczba elementów w kopcu.
+  unsigned maxIndex; ///< Liczba możliwych indeksów w kolejce.
 };
 
 PriorityQueue *newPriorityQueue(unsigned maxIndex) {
@@ -24,121 +29,166 @@ PriorityQueue *newPriorityQueue(unsigned maxIndex) {
   if (!new) {
     return NULL;
   }
-  new->head = NULL;
-  new->maxIndex = maxIndex;
+  new->heap = NULL;
+  new->position = NULL;
+  new->size = 0;
+  new->maxIndex = 0;
+  if (!reservePriorityQueue(new, maxIndex)) {
+    free(new);
+    return NULL;
+  }
   return new;
 }
 
+bool reservePriorityQueue(PriorityQueue *queue, unsigned maxIndex) {
+  if (queue->maxIndex >= maxIndex) {
+    return true;
+  }
+  HeapNode *newHeap = realloc(queue->heap, maxIndex * sizeof(HeapNode));
+  if (!newHeap) {
+    return false;
+  }
+  queue->heap = newHeap;
+  int *newPosition = realloc(queue->position, maxIndex * sizeof(int));
+  if (!newPosition) {
+    return false;
+  }
+  for (unsigned i = queue->maxIndex; i < maxIndex; i++) {
+    newPosition[i] = ABSENT;
+  }
+  queue->position = newPosition;
+  queue->maxIndex = maxIndex;
+  return true;
+}
+
 bool isEmpty(PriorityQueue *queue) {
-  return (!queue || !(queue->head));
+  return (!queue || queue->size == 0);
 }
 
 /**
- * Usuwa pojedynczy wierzchołek listy zwalniając zaalokowaną na niego pamięć.
- * @param node - wskaźnik na usuwany wierzchołek.
+ * Umieszcza element na podanej pozycji kopca i zapamiętuje tę pozycję.
+ * @param queue - wskaźnik na strukturę kolejki;
+ * @param place - pozycja w kopcu;
+ * @param node - umieszczany element.
  */
-static void deleteNode(IntList *node) {
-  if (node) {
-    free(node);
+static void placeNode(PriorityQueue *queue, unsigned place, HeapNode node) {
+  queue->heap[place] = node;
+  queue->position[node.index] = (int) place;
+}
+
+///Przesuwa element w górę kopca, dopóki jego rodzic ma większy klucz.
+static void siftUp(PriorityQueue *queue, unsigned place) {
+  HeapNode node = queue->heap[place];
+  while (place > 0) {
+    unsigned parent = (place - 1) / 2;
+    if (queue->heap[parent].key <= node.key) {
+      break;
+    }
+    placeNode(queue, place, queue->heap[parent]);
+    place = parent;
   }
+  placeNode(queue, place, node);
 }
 
-/**Tworzy nową strukturę pojedynczego wierzchołka listy liczb całkowitych.
- * @param index - liczba
- * @return Zwraca wskaźnik na utworzony wierzchołek lub NULL jeśli nie udało się
- * zaalokować pamięci.
- */
-static IntList *newIntListNode(unsigned index) {
-  IntList *new = malloc(sizeof(IntList));
-  if (!new) {
-    return NULL;
+///Przesuwa element w dół kopca, dopóki któreś z dzieci ma mniejszy klucz.
+static void siftDown(PriorityQueue *queue, unsigned place) {
+  HeapNode node = queue->heap[place];
+  while (2 * place + 1 < queue->size) {
+    unsigned child = 2 * place + 1;
+    if (child + 1 < queue->size &&
+        queue->heap[child + 1].key < queue->heap[child].key) {
+      child++;
+    }
+    if (queue->heap[child].key >= node.key) {
+      break;
+    }
+    placeNode(queue, place, queue->heap[child]);
+    place = child;
   }
-  new->index = (int) index;
-  new->next = NULL;
-  return new;
+  placeNode(queue, place, node);
 }
 
-bool insert(unsigned index, PriorityQueue *queue, int(*comparator)(unsigned,
-                                                                   unsigned)) {
-  if (!queue) {
+bool insert(unsigned index, uint64_t key, PriorityQueue *queue) {
+  if (!queue || index >= queue->maxIndex) {
     return false;
   }
-  if (!(queue->head) || comparator(index, queue->head->index) <= 0) {
-    IntList *temp = newIntListNode(index);
-    if (!temp) {
-      return false;
-    }
-    temp->next = queue->head;
-    queue->head = temp;
+  int place = queue->position[index];
+  if (place == ABSENT) {
+    HeapNode node;
+    node.key = key;
+    node.index = index;
+    placeNode(queue, queue->size, node);
+    siftUp(queue, (queue->size)++);
     return true;
   }
-  IntList *temp = queue->head;
-  IntList *prev = NULL;
-
-  while (temp && comparator(temp->index, index) < 0) {
-    prev = temp;
-    temp = temp->next;
+  uint64_t oldKey = queue->heap[place].key;
+  queue->heap[place].key = key;
+  if (key < oldKey) {
+    siftUp(queue, (unsigned) place);
+  }
+  else {
+    siftDown(queue, (unsigned) place);
   }
+  return true;
+}
 
-  if (!prev) {
-    IntList *newNode = newIntListNode(index);
-    if (!newNode) {
-      return false;
-    }
-    newNode->next = temp->next;
-    temp->next = newNode;
-    return true;
+/**
+ * Usuwa z kopca element znajdujący się na podanej pozycji.
+ * @param queue - wskaźnik na strukturę kolejki;
+ * @param place - pozycja usuwanego elementu.
+ */
+static void removeAt(PriorityQueue *queue, unsigned place) {
+  queue->position[queue->heap[place].index] = ABSENT;
+  (queue->size)--;
+  if (place == queue->size) {
+    return;
   }
-  IntList *newNode = newIntListNode(index);
-  if (!newNode) {
-    return false;
+  uint64_t removedKey = queue->heap[place].key;
+  placeNode(queue, place, queue->heap[queue->size]);
+  if (queue->heap[place].key < removedKey) {
+    siftUp(queue, place);
+  }
+  else {
+    siftDown(queue, place);
   }
-  newNode->next = prev->next;
-  prev->next = newNode;
-  return true;
 }
 
 int pop(PriorityQueue *queue) {
-  if (queue && queue->head) {
-    unsigned value = queue->head->index;
-    IntList *temp = queue->head;
-    queue->head = queue->head->next;
-    deleteNode(temp);
-    return (int) value;
-  }
-  return EMPTY;
+  if (isEmpty(queue)) {
+    return EMPTY;
+  }
+  unsigned value = queue->heap[0].index;
+  removeAt(queue, 0);
+  return (int) value;
+}
+
+uint64_t topKey(PriorityQueue *queue) {
+  if (isEmpty(queue)) {
+    return UINT64_MAX;
+  }
+  return queue->heap[0].key;
 }
 
-///Zwalnia całą pamięć zaalokowaną na listę liczb całkowitych.
-static void freeIntList(IntList *head) {
-  if (head) {
-    freeIntList(head->next);
-    deleteNode(head);
+void clearPriorityQueue(PriorityQueue *queue) {
+  if (queue) {
+    for (unsigned i = 0; i < queue->size; i++) {
+      queue->position[queue->heap[i].index] = ABSENT;
+    }
+    queue->size = 0;
   }
 }
 
 void freePriorityQueue(PriorityQueue *queue) {
   if (queue) {
-    freeIntList(queue->head);
+    free(queue->heap);
+    free(queue->position);
     free(queue);
   }
 }
 
 void deleteIndex(int index, PriorityQueue *queue) {
-  if (queue && queue->head) {
-    if (queue->head->index == index) {
-      pop(queue);
-    }
-    else {
-      IntList *head = queue->head;
-      while (head && head->next) {
-        if (head->next->index == index) {
-          IntList *toRemoval = head->next;
-          head->next = head->next->next;
-          deleteNode(toRemoval);
-        }
-        head = head->next;
-      }
-    }
+  if (queue && index >= 0 && (unsigned) index < queue->maxIndex &&
+      queue->position[index] != ABSENT) {
+    removeAt(queue, (unsigned) queue->position[index]);
   }
-}
\ No newline at end of file
+}
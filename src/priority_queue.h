@@ -2,6 +2,7 @@
 #define DROGI_PRIORITY_QUEUE_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 ///Stała zwracana przy próbie usunięcia pierwszego indeksu z pustej kolejki.
 #define EMPTY -1
@@ -12,12 +13,24 @@
 typedef struct PriorityQueue PriorityQueue;
 
 /**@brief Tworzy nową strukturę.
- * Tworzy nową, pustą kolejkę priorytetową.
+ * Tworzy nową, pustą kolejkę priorytetową mogącą przechowywać indeksy od 0 do
+ * @p maxIndex - 1.
+ * @param maxIndex - liczba możliwych indeksów.
  * @return Zwraca wskaźnik na utworzoną strukturę lub NULL, jeśli nie uda się
  * zaalokować pamięci.
  */
 PriorityQueue *newPriorityQueue(unsigned maxIndex);
 
+/**@brief Powiększa kolejkę.
+ * Jeśli kolejka nie mieści indeksów od 0 do @p maxIndex - 1, powiększa ją.
+ * Zachowuje elementy znajdujące się w kolejce.
+ * @param queue - wskaźnik na strukturę kolejki;
+ * @param maxIndex - wymagana liczba możliwych indeksów.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci. W przeciwnym
+ * razie zwraca @p true.
+ */
+bool reservePriorityQueue(PriorityQueue *queue, unsigned maxIndex);
+
 /**@brief Sprawdza, czy kolejka jest pusta.
  * @param queue - kolejka, którą sprawdza.
  * @return @p false, jeśli w kolejce znajduje się przynajmniej 1 element;
@@ -26,23 +39,38 @@ PriorityQueue *newPriorityQueue(unsigned maxIndex);
 bool isEmpty(PriorityQueue *queue);
 
 /**@brief Dodaje element do kolejki.
- * Dodaje nowy element, tak aby został zachowany porządek kolejki.
+ * Dodaje nowy element o podanym kluczu, tak aby został zachowany porządek
+ * kolejki. Jeśli element już znajduje się w kolejce, zmienia jego klucz.
+ * Mniejszy klucz oznacza wyższy priorytet.
  * @param index - element dodawany;
- * @param head - początek kolejki.
- * @return Zwraca @p false jeśli wystąpi błąd alokacji pamięci. W przeciwnym
+ * @param key - klucz elementu;
+ * @param queue - wskaźnik na strukturę kolejki.
+ * @return Zwraca @p false, jeśli indeks nie mieści się w kolejce. W przeciwnym
  * wypadku zwraca @p true.
  */
-bool insert(unsigned index, PriorityQueue *queue, int (*comparator)(unsigned,
-        unsigned));
+bool insert(unsigned index, uint64_t key, PriorityQueue *queue);
 
 /**@brief Usuwa pierwszy element.
- * Jeśli kolejka nie jest pusta, usuwa z niej pierwszy element.
- * @param head - początek kolejki.
+ * Jeśli kolejka nie jest pusta, usuwa z niej element o najmniejszym kluczu.
+ * @param queue - wskaźnik na strukturę kolejki.
  * @return Zwraca wartość usuniętego indeksu lub EMPTY, jeśli kolejka była
  * pusta.
  */
 int pop(PriorityQueue *queue);
 
+/**@brief Podaje najmniejszy klucz.
+ * @param queue - wskaźnik na strukturę kolejki.
+ * @return Zwraca klucz pierwszego elementu kolejki lub UINT64_MAX, jeśli
+ * kolejka jest pusta.
+ */
+uint64_t topKey(PriorityQueue *queue);
+
+/**@brief Opróżnia kolejkę.
+ * Usuwa wszystkie elementy kolejki nie zwalniając zaalokowanej pamięci.
+ * @param queue - wskaźnik na strukturę kolejki.
+ */
+void clearPriorityQueue(PriorityQueue *queue);
+
 /**@brief Usuwa strukturę.
  * Zwalnia całą zaalokowaną pamięć i usuwa kolejkę.
  */
@@ -11,8 +11,6 @@
 #include <stdlib.h>
 #include <string.h>
 
-#define TABLE_LENGTH 10 ///< Długość tablicy hashującej.
-
 /**
  * Struktura przechowująca hashmapę odcinków dróg.
  */
@@ -20,36 +18,11 @@ struct RoadHashMap {
   City *owner; ///< Miasto do którego należy hashmapa.
   unsigned length; ///< Długość tablicy wskaźników na listy odcinków dróg.
   RoadList **roads; ///< Tablica wskaźników na początki list odcików dróg.
-  int *hashTable; ///< Tablica hashująca.
 };
 
-/**@brief Tworzy tablicę.
- * Tworzy nową tablicę hashującą o długości zdefiniowanej stałą TABLE_LENGTH.
- * Wypełnia kolejne jej komórki kolejnymi liczbami pierwszymi.
- * @return Zwraca wskaźnik na utworzoną strukturę lub NULL, jeśli nie udało się
- * zaalokować pamięci.
- */
-static int *createHashTable() {
-  int *array;
-  if (!(array = malloc(TABLE_LENGTH * sizeof(int)))) {
-    return NULL;
-  }
-  array[0] = 11;
-  array[1] = 13;
-  array[2] = 17;
-  array[3] = 19;
-  array[4] = 23;
-  array[5] = 29;
-  array[6] = 31;
-  array[7] = 37;
-  array[8] = 41;
-  array[9] = 43;
-  return array;
-}
-
 /**@brief Generuje indeks.
- * Na podstawie nazwy miasta i stałych ROADS_NUMBER, TABLE_LENGTH generuje nowy
- * indeks określający potencjalną pozycję miasta w hashmapie.
+ * Wyznacza funkcją cityIndex() potencjalną pozycję odcinka drogi prowadzącego
+ * do miasta o podanej nazwie w hashmapie.
  * @param cityName - wskaźnik na napis będący nazwą miasta;
  * @param hashMap - wskaźnik na hashmapę.
  * @return Zwraca wygenerowany indeks lub -1, jeśli któryś z parametrów wskazuje
@@ -59,16 +32,7 @@ static int generateIndex(const char *cityName, RoadHashMap *hashMap) {
   if (!cityName || !hashMap) {
     return -1;
   }
-  int index = 0;
-  unsigned i = 0;
-  unsigned length = strlen(cityName);
-  while (i < length) {
-    index += abs((int)(cityName[i] - '0') * hashMap->hashTable[i % TABLE_LENGTH]) %
-             ROADS_NUMBER;
-    index = abs (index % ROADS_NUMBER);
-    i++;
-  }
-  return index;
+  return (int) cityIndex(cityName, strlen(cityName));
 }
 
 RoadHashMap *newRoadHashMap(City *owner) {
@@ -84,29 +48,12 @@ RoadHashMap *newRoadHashMap(City *owner) {
   for (int i = 0; i < ROADS_NUMBER; i++) {
     new->roads[i] = NULL;
   }
-  if (!(new->hashTable = createHashTable())) {
-    free(new->roads);
-    free(new);
-    return NULL;
-  }
   new->owner = owner;
   return new;
 }
 
-Road *findRoad(const char *cityName, RoadHashMap *hashMap) {
-  if (!hashMap) {
-    return NULL;
-  }
-
-  int index = generateIndex(cityName, hashMap);
-  if (index == -1) {
-    return NULL;
-  }
+Road *findRoadAt(const char *cityName, unsigned index, RoadHashMap *hashMap) {
   RoadList *temp = hashMap->roads[index];
-
-  if (!temp) {
-    return NULL;
-  }
   while (temp != NULL && strcmp(temp->road->city1->name, cityName) != 0 &&
          strcmp(temp->road->city2->name, cityName) != 0) {
     temp = temp->next;
@@ -117,6 +64,14 @@ Road *findRoad(const char *cityName, RoadHashMap *hashMap) {
   return temp->road;
 }
 
+Road *findRoad(const char *cityName, RoadHashMap *hashMap) {
+  int index = generateIndex(cityName, hashMap);
+  if (index == -1) {
+    return NULL;
+  }
+  return findRoadAt(cityName, (unsigned) index, hashMap);
+}
+
 Road *addRoadToHashmap(Road *road, RoadHashMap *hashMap) {
   const char *name;
   if (strcmp(hashMap->owner->name, road->city1->name) == 0) {
@@ -143,9 +98,6 @@ Road *addRoadToHashmap(Road *road, RoadHashMap *hashMap) {
 
 void freeRoadHashMap(RoadHashMap *roadHashMap) {
   if (roadHashMap) {
-    if (roadHashMap->hashTable) {
-      free(roadHashMap->hashTable);
-    }
     if (roadHashMap->roads) {
       for (unsigned i = 0; i < roadHashMap->length; i++) {
         deleteRoadList(roadHashMap->roads[i]);
@@ -168,8 +120,12 @@ static RoadList *findPrevious(const char *cityName, RoadHashMap *hashMap) {
   if (!temp || !(temp->next)) {
     return NULL;
   }
-  while (temp->next && strcmp(temp->road->city1->name, cityName) != 0 &&
-        strcmp(temp->road->city2->name, cityName) != 0) {
+  if (strcmp(temp->road->city1->name, cityName) == 0 ||
+      strcmp(temp->road->city2->name, cityName) == 0) {
+    return NULL;
+  }
+  while (temp->next && strcmp(temp->next->road->city1->name, cityName) != 0 &&
+        strcmp(temp->next->road->city2->name, cityName) != 0) {
     temp = temp->next;
   }
   if (temp->next == NULL) {
@@ -205,6 +161,8 @@ void deleteRoad(Road *road) {
     RoadList *previous2 = findPrevious(road->city1->name, road->city2->roads);
     deleteHalf(road->city1, previous1, road->index1);
     deleteHalf(road->city2, previous2, road->index2);
+    removeAdjacentRoad(road->city1, road);
+    removeAdjacentRoad(road->city2, road);
     if (road->routes) {
       deleteRouteList(road->routes);
     }
@@ -8,9 +8,12 @@
 #ifndef DROGI_ROAD_HASHMAP_H
 #define DROGI_ROAD_HASHMAP_H
 
-#define ROADS_NUMBER 6113 ///< Długość tablicy odcinków dróg w hashmapie.
-
 #include "structures.h"
+#include "city_hashmap.h"
+
+///Długość tablicy odcinków dróg w hashmapie, równa długości tablicy miast, bo
+///pozycje w obu hashmapach wyznacza funkcja cityIndex().
+#define ROADS_NUMBER CITIES_NUMBER
 
 /**
  * Struktura przechowująca hashmapę odcinków dróg.
@@ -27,6 +30,16 @@ typedef struct RoadHashMap RoadHashMap;
  */
 Road *findRoad(const char *cityName, RoadHashMap *hashMap);
 
+/**@brief Szuka odcinka drogi o wyznaczonym indeksie w hashmapie.
+ * Działa tak jak findRoad(), ale nie wyznacza indeksu nazwy.
+ * @param cityName - wskaźnik na nazwę miasta;
+ * @param index - indeks nazwy wyznaczony funkcją cityIndex();
+ * @param hashMap - wskaźnik na strukturę przechowująca hashmapę odcinków dróg
+ * @return Zwraca wskaźnik na znaleziony odcinek drogi lub NULL, jeśli taki
+ * odcinek nie istnieje.
+ */
+Road *findRoadAt(const char *cityName, unsigned index, RoadHashMap *hashMap);
+
 /**@brief Dodaje drogę do hashmapy.
  * Dodaje gotową drogę do hashmapy należącej do jednego z miast. Zakłada, że
  * miasto do którego należy hashmapa jest jednym z końców dodawanej drogi, a
@@ -0,0 +1,174 @@
+/**@file
+ * Implementacja route_cache.h.
+ *
+ * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
+ * @date 01.09.2019
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "route_cache.h"
+
+/**
+ * Struktura przechowująca jeden wynik wyszukiwania.
+ */
+typedef struct CacheEntry {
+  City *start; ///< Miasto początkowe.
+  City *finish; ///< Miasto końcowe.
+  unsigned forbiddenId; ///< Numer drogi krajowej, której miasta są zabronione.
+  Road *forbiddenRoad; ///< Zabroniony odcinek drogi.
+  unsigned long long mapVersion; ///< Wersja mapy w chwili zapisania.
+  unsigned long long routeVersion; ///< Wersja drogi krajowej w chwili zapisania.
+  int status; ///< Wynik wyszukiwania.
+  Road **roads; ///< Kolejne odcinki wyznaczonej drogi.
+  unsigned length; ///< Liczba odcinków wyznaczonej drogi.
+  unsigned capacity; ///< Rozmiar tablicy odcinków.
+  bool used; ///< Informacja, czy miejsce zawiera wynik.
+} CacheEntry;
+
+/**
+ * Struktura przechowująca pamięć podręczną wyników wyszukiwania.
+ */
+struct RouteCache {
+  CacheEntry *entries; ///< Tablica wyników lub NULL przed pierwszym zapisem.
+  unsigned long long mapVersion; ///< Bieżąca wersja mapy.
+  ///Bieżące wersje dróg krajowych.
+  unsigned long long routeVersions[ROUTES_NUMBER];
+  CacheStatistics statistics; ///< Statystyki trafień.
+};
+
+RouteCache *newRouteCache(void) {
+  return calloc(1, sizeof(RouteCache));
+}
+
+void freeRouteCache(RouteCache *cache) {
+  if (cache) {
+    if (cache->entries) {
+      for (unsigned i = 0; i < ROUTE_CACHE_SIZE; i++) {
+        free(cache->entries[i].roads);
+      }
+      free(cache->entries);
+    }
+    free(cache);
+  }
+}
+
+void invalidateMap(RouteCache *cache) {
+  if (cache) {
+    (cache->mapVersion)++;
+  }
+}
+
+void invalidateRoute(RouteCache *cache, unsigned routeId) {
+  if (cache && routeId < ROUTES_NUMBER) {
+    (cache->routeVersions[routeId])++;
+  }
+}
+
+/**
+ * Wyznacza miejsce wyniku w tablicy na podstawie parametrów wyszukiwania.
+ * @param start - miasto początkowe;
+ * @param finish - miasto końcowe;
+ * @param forbiddenId - numer zabronionej drogi krajowej;
+ * @param forbiddenRoad - zabroniony odcinek drogi.
+ * @return Zwraca indeks w tablicy wyników.
+ */
+static unsigned entryIndex(City *start, City *finish, unsigned forbiddenId,
+                           Road *forbiddenRoad) {
+  uint64_t hash = (uint64_t) (uintptr_t) start;
+  hash = hash * 0x9E3779B97F4A7C15ULL ^ (uint64_t) (uintptr_t) finish;
+  hash = hash * 0x9E3779B97F4A7C15ULL ^ forbiddenId;
+  hash = hash * 0x9E3779B97F4A7C15ULL ^ (uint64_t) (uintptr_t) forbiddenRoad;
+  hash *= 0x9E3779B97F4A7C15ULL;
+  return (unsigned) (hash >> 32) % ROUTE_CACHE_SIZE;
+}
+
+/**
+ * Podaje bieżącą wersję drogi krajowej.
+ * @param cache - wskaźnik na strukturę pamięci;
+ * @param forbiddenId - numer drogi krajowej lub 0.
+ * @return Zwraca wersję drogi krajowej.
+ */
+static unsigned long long routeVersion(RouteCache *cache,
+                                       unsigned forbiddenId) {
+  return forbiddenId < ROUTES_NUMBER ? cache->routeVersions[forbiddenId] : 0;
+}
+
+bool findCachedRoute(RouteCache *cache, City *start, City *finish,
+        unsigned forbiddenId, Road *forbiddenRoad, RoadList **roadList,
+        int *status) {
+  if (!cache) {
+    return false;
+  }
+  CacheEntry *entry = NULL;
+  if (cache->entries) {
+    entry = &(cache->entries[entryIndex(start, finish, forbiddenId,
+                                        forbiddenRoad)]);
+  }
+  if (!entry || !entry->used || entry->start != start ||
+      entry->finish != finish || entry->forbiddenId != forbiddenId ||
+      entry->forbiddenRoad != forbiddenRoad ||
+      entry->mapVersion != cache->mapVersion ||
+      entry->routeVersion != routeVersion(cache, forbiddenId)) {
+    (cache->statistics.misses)++;
+    return false;
+  }
+  RoadList *list = NULL;
+  for (unsigned i = entry->length; i > 0; i--) {
+    if (!addToRoadList(entry->roads[i - 1], &list)) {
+      freeRoadList(list);
+      (cache->statistics.misses)++;
+      return false;
+    }
+  }
+  (cache->statistics.hits)++;
+  *roadList = list;
+  *status = entry->status;
+  return true;
+}
+
+void storeRoute(RouteCache *cache, City *start, City *finish,
+        unsigned forbiddenId, Road *forbiddenRoad, RoadList *roadList,
+        int status) {
+  if (!cache) {
+    return;
+  }
+  if (!cache->entries &&
+      !(cache->entries = calloc(ROUTE_CACHE_SIZE, sizeof(CacheEntry)))) {
+    return;
+  }
+  CacheEntry *entry = &(cache->entries[entryIndex(start, finish, forbiddenId,
+                                                  forbiddenRoad)]);
+  unsigned length = 0;
+  for (RoadList *temp = roadList; temp; temp = temp->next) {
+    length++;
+  }
+  if (length > entry->capacity) {
+    Road **roads = realloc(entry->roads, length * sizeof(Road *));
+    if (!roads) {
+      entry->used = false;
+      return;
+    }
+    entry->roads = roads;
+    entry->capacity = length;
+  }
+  length = 0;
+  for (RoadList *temp = roadList; temp; temp = temp->next) {
+    entry->roads[length++] = temp->road;
+  }
+  entry->length = length;
+  entry->start = start;
+  entry->finish = finish;
+  entry->forbiddenId = forbiddenId;
+  entry->forbiddenRoad = forbiddenRoad;
+  entry->mapVersion = cache->mapVersion;
+  entry->routeVersion = routeVersion(cache, forbiddenId);
+  entry->status = status;
+  entry->used = true;
+}
+
+CacheStatistics routeCacheStatistics(RouteCache *cache) {
+  CacheStatistics statistics = {0, 0};
+  return cache ? cache->statistics : statistics;
+}
@@ -0,0 +1,108 @@
+/** @file
+ * Interfejs pamięci podręcznej wyników wyszukiwania dróg krajowych.
+ *
+ * Wynik wyszukiwania zależy od odcinków dróg na mapie i od miast, przez które
+ * przechodzi droga krajowa o zabronionym numerze. Pamięć przechowuje więc
+ * numer wersji mapy, zmieniany przy każdej zmianie odcinków dróg, i numer
+ * wersji każdej drogi krajowej, zmieniany przy każdej zmianie jej przebiegu.
+ * Wynik zapisany przy innych wersjach nigdy nie jest zwracany.
+ *
+ * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
+ * @date 01.09.2019
+ */
+
+#ifndef DROGI_ROUTE_CACHE_H
+#define DROGI_ROUTE_CACHE_H
+
+#include <stdbool.h>
+#include "structures.h"
+
+///Liczba wyników przechowywanych w pamięci podręcznej.
+#define ROUTE_CACHE_SIZE 4096
+
+/**
+ * Struktura przechowująca pamięć podręczną wyników wyszukiwania.
+ */
+typedef struct RouteCache RouteCache;
+
+/**
+ * Struktura przechowująca statystyki pamięci podręcznej.
+ */
+typedef struct CacheStatistics {
+  unsigned long long hits; ///< Liczba zapytań, dla których był wynik.
+  unsigned long long misses; ///< Liczba zapytań, dla których wyniku nie było.
+} CacheStatistics;
+
+/**@brief Tworzy nową strukturę.
+ * Pamięć na wyniki jest alokowana przy zapisaniu pierwszego wyniku.
+ * @return Zwraca wskaźnik na utworzoną strukturę lub NULL, jeśli nie udało się
+ * zaalokować pamięci.
+ */
+RouteCache *newRouteCache(void);
+
+/**@brief Usuwa strukturę.
+ * Zwalnia całą pamięć zaalokowaną przez strukturę.
+ * @param cache - wskaźnik na usuwaną strukturę.
+ */
+void freeRouteCache(RouteCache *cache);
+
+/**@brief Unieważnia wszystkie wyniki.
+ * Należy wywołać po każdej zmianie odcinków dróg na mapie. Działa w czasie
+ * stałym.
+ * @param cache - wskaźnik na strukturę pamięci.
+ */
+void invalidateMap(RouteCache *cache);
+
+/**@brief Unieważnia wyniki zależne od drogi krajowej.
+ * Należy wywołać po każdej zmianie zbioru miast, przez które przechodzi droga
+ * krajowa. Działa w czasie stałym.
+ * @param cache - wskaźnik na strukturę pamięci;
+ * @param routeId - numer drogi krajowej.
+ */
+void invalidateRoute(RouteCache *cache, unsigned routeId);
+
+/**@brief Szuka wyniku wyszukiwania.
+ * Jeśli w pamięci jest aktualny wynik wyszukiwania o podanych parametrach,
+ * zapisuje go pod wskazanymi adresami. Lista odcinków dróg jest nową kopią,
+ * którą należy zwolnić lub przekazać do drogi krajowej.
+ * @param cache - wskaźnik na strukturę pamięci;
+ * @param start - miasto początkowe;
+ * @param finish - miasto końcowe;
+ * @param forbiddenId - numer drogi krajowej, której miasta były zabronione,
+ * lub 0;
+ * @param forbiddenRoad - zabroniony odcinek drogi lub NULL;
+ * @param roadList - wskaźnik, pod który zostanie zapisana lista odcinków dróg
+ * lub NULL, jeśli drogi nie wyznaczono;
+ * @param status - wskaźnik, pod który zostanie zapisany wynik wyszukiwania
+ * (zob. findBestRouteLimited()).
+ * @return Zwraca @p true, jeśli wynik został znaleziony. W przeciwnym razie
+ * zwraca @p false.
+ */
+bool findCachedRoute(RouteCache *cache, City *start, City *finish,
+        unsigned forbiddenId, Road *forbiddenRoad, RoadList **roadList,
+        int *status);
+
+/**@brief Zapisuje wynik wyszukiwania.
+ * Zapamiętuje wynik razem z bieżącymi wersjami mapy i drogi krajowej,
+ * zastępując wynik zajmujący to samo miejsce w pamięci. Jeśli nie uda się
+ * zaalokować pamięci, wynik nie jest zapisywany.
+ * @param cache - wskaźnik na strukturę pamięci;
+ * @param start - miasto początkowe;
+ * @param finish - miasto końcowe;
+ * @param forbiddenId - numer drogi krajowej, której miasta były zabronione,
+ * lub 0;
+ * @param forbiddenRoad - zabroniony odcinek drogi lub NULL;
+ * @param roadList - wyznaczona lista odcinków dróg lub NULL;
+ * @param status - wynik wyszukiwania.
+ */
+void storeRoute(RouteCache *cache, City *start, City *finish,
+        unsigned forbiddenId, Road *forbiddenRoad, RoadList *roadList,
+        int status);
+
+/**@brief Podaje statystyki pamięci podręcznej.
+ * @param cache - wskaźnik na strukturę pamięci.
+ * @return Zwraca liczbę trafień i chybień od utworzenia struktury.
+ */
+CacheStatistics routeCacheStatistics(RouteCache *cache);
+
+#endif //DROGI_ROUTE_CACHE_H
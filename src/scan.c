@@ -0,0 +1,177 @@
+/**@file
+ * Implementacja scan.h.
+ *
+ * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
+ * @date 01.09.2019
+ */
+
+#include "scan.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+///Informacja, że można zbudować wersje SSE2 i AVX2 wyznaczania masek.
+#define VECTOR_SCAN 1
+#endif
+
+///Informacja, czy można używać wersji wektorowych wyznaczania masek.
+static bool vectorScanning = true;
+
+/**@brief Wyznacza maski bloku zwykłą pętlą.
+ * @param text - wskaźnik na początek bloku;
+ * @param size - liczba znaków bloku, co najwyżej SCAN_BLOCK;
+ * @param semicolons - wskaźnik, pod który zostanie zapisana maska średników;
+ * @param controls - wskaźnik, pod który zostanie zapisana maska znaków
+ * sterujących.
+ */
+static void scalarScan(const char *text, unsigned size, uint64_t *semicolons,
+                       uint64_t *controls) {
+  uint64_t foundSemicolons = 0, foundControls = 0;
+  for (unsigned i = 0; i < size; i++) {
+    unsigned char byte = (unsigned char) text[i];
+    if (byte == ';') {
+      foundSemicolons |= (uint64_t) 1 << i;
+    }
+    else if (byte < 32 && byte != '\n') {
+      foundControls |= (uint64_t) 1 << i;
+    }
+  }
+  *semicolons = foundSemicolons;
+  *controls = foundControls;
+}
+
+#ifdef VECTOR_SCAN
+/**@brief Wyznacza maski bloku instrukcjami SSE2.
+ * Przetwarza po 16 znaków, a resztę bloku zwykłą pętlą. Wolno ją wywołać tylko
+ * na procesorze obsługującym SSE2.
+ * @param text - wskaźnik na początek bloku;
+ * @param size - liczba znaków bloku, co najwyżej SCAN_BLOCK;
+ * @param semicolons - wskaźnik, pod który zostanie zapisana maska średników;
+ * @param controls - wskaźnik, pod który zostanie zapisana maska znaków
+ * sterujących.
+ */
+__attribute__((target("sse2")))
+static void sse2Scan(const char *text, unsigned size, uint64_t *semicolons,
+                     uint64_t *controls) {
+  __m128i semicolon = _mm_set1_epi8(';');
+  __m128i newline = _mm_set1_epi8('\n');
+  __m128i lastControl = _mm_set1_epi8(31);
+  uint64_t foundSemicolons = 0, foundControls = 0;
+  unsigned i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m128i bytes = _mm_loadu_si128((const __m128i *) (text + i));
+    unsigned found = (unsigned) _mm_movemask_epi8(
+            _mm_cmpeq_epi8(bytes, semicolon));
+    unsigned control = (unsigned) _mm_movemask_epi8(
+            _mm_cmpeq_epi8(_mm_min_epu8(bytes, lastControl), bytes)) &
+            ~(unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline));
+    foundSemicolons |= (uint64_t) found << i;
+    foundControls |= (uint64_t) control << i;
+  }
+  if (i < size) {
+    uint64_t restSemicolons, restControls;
+    scalarScan(text + i, size - i, &restSemicolons, &restControls);
+    foundSemicolons |= restSemicolons << i;
+    foundControls |= restControls << i;
+  }
+  *semicolons = foundSemicolons;
+  *controls = foundControls;
+}
+
+/**@brief Wyznacza maski bloku instrukcjami AVX2.
+ * Przetwarza po 32 znaki, potem ewentualnie 16 znaków, a resztę bloku zwykłą
+ * pętlą. Nie wywołuje wersji SSE2, bo przejście od instrukcji AVX do
+ * instrukcji SSE bez kodowania VEX jest na części procesorów bardzo kosztowne.
+ * Wolno ją wywołać tylko na procesorze obsługującym AVX2.
+ * @param text - wskaźnik na początek bloku;
+ * @param size - liczba znaków bloku, co najwyżej SCAN_BLOCK;
+ * @param semicolons - wskaźnik, pod który zostanie zapisana maska średników;
+ * @param controls - wskaźnik, pod który zostanie zapisana maska znaków
+ * sterujących.
+ */
+__attribute__((target("avx2")))
+static void avx2Scan(const char *text, unsigned size, uint64_t *semicolons,
+                     uint64_t *controls) {
+  __m256i semicolon = _mm256_set1_epi8(';');
+  __m256i newline = _mm256_set1_epi8('\n');
+  __m256i lastControl = _mm256_set1_epi8(31);
+  uint64_t foundSemicolons = 0, foundControls = 0;
+  unsigned i = 0;
+  for (; i + 32 <= size; i += 32) {
+    __m256i bytes = _mm256_loadu_si256((const __m256i *) (text + i));
+    uint32_t found = (uint32_t) _mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(bytes, semicolon));
+    uint32_t control = (uint32_t) _mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(_mm256_min_epu8(bytes, lastControl), bytes)) &
+            ~(uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newline));
+    foundSemicolons |= (uint64_t) found << i;
+    foundControls |= (uint64_t) control << i;
+  }
+  if (i + 16 <= size) {
+    __m128i bytes = _mm_loadu_si128((const __m128i *) (text + i));
+    unsigned found = (unsigned) _mm_movemask_epi8(
+            _mm_cmpeq_epi8(bytes, _mm256_castsi256_si128(semicolon)));
+    unsigned control = (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(
+            _mm_min_epu8(bytes, _mm256_castsi256_si128(lastControl)), bytes)) &
+            ~(unsigned) _mm_movemask_epi8(
+            _mm_cmpeq_epi8(bytes, _mm256_castsi256_si128(newline)));
+    foundSemicolons |= (uint64_t) found << i;
+    foundControls |= (uint64_t) control << i;
+    i += 16;
+  }
+  if (i < size) {
+    uint64_t restSemicolons, restControls;
+    scalarScan(text + i, size - i, &restSemicolons, &restControls);
+    foundSemicolons |= restSemicolons << i;
+    foundControls |= restControls << i;
+  }
+  *semicolons = foundSemicolons;
+  *controls = foundControls;
+}
+#endif
+
+ScanKernel chooseScanKernel(size_t size) {
+#ifdef VECTOR_SCAN
+  if (vectorScanning && size >= VECTOR_SCAN_MIN) {
+    if (__builtin_cpu_supports("avx2")) {
+      return avx2Scan;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+      return sse2Scan;
+    }
+  }
+#else
+  (void) size;
+#endif
+  return scalarScan;
+}
+
+bool setVectorScanning(bool enabled) {
+  vectorScanning = enabled;
+  return chooseScanKernel(SIZE_MAX) != scalarScan;
+}
+
+unsigned lowestBit(uint64_t mask) {
+#ifdef __GNUC__
+  return (unsigned) __builtin_ctzll(mask);
+#else
+  unsigned bit = 0;
+  while (!(mask & 1)) {
+    mask >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+bool plainText(const char *text, size_t size) {
+  ScanKernel scan = chooseScanKernel(size);
+  for (size_t i = 0; i < size; i += SCAN_BLOCK) {
+    unsigned block = size - i < SCAN_BLOCK ? (unsigned) (size - i) : SCAN_BLOCK;
+    uint64_t semicolons, controls;
+    scan(text + i, block, &semicolons, &controls);
+    if (semicolons | controls) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,70 @@
+/** @file
+ * Interfejs przeglądania napisów po kilkadziesiąt znaków naraz.
+ *
+ * Napis jest dzielony na bloki po SCAN_BLOCK znaków, a dla każdego bloku
+ * wyznaczane są maski bitowe średników i znaków sterujących (o kodach od 0
+ * do 31, z wyjątkiem znaku '\n'). Maski napisów o długości co najmniej
+ * VECTOR_SCAN_MIN są wyznaczane instrukcjami AVX2 lub SSE2, jeśli procesor je
+ * obsługuje, a krótszych napisów - zwykłą pętlą. Wszystkie wersje dają te
+ * same wyniki.
+ *
+ * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
+ * @date 01.09.2019
+ */
+
+#ifndef DROGI_SCAN_H
+#define DROGI_SCAN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SCAN_BLOCK 64 ///< Największa liczba znaków przeglądanych naraz.
+///Najmniejsza długość napisu, dla której używane są wersje wektorowe.
+#define VECTOR_SCAN_MIN 16
+
+/**
+ * Funkcja wyznaczająca maski bloku co najwyżej SCAN_BLOCK znaków: i-ty bit
+ * maski odpowiada i-temu znakowi bloku.
+ * @param text - wskaźnik na początek bloku;
+ * @param size - liczba znaków bloku;
+ * @param semicolons - wskaźnik, pod który zostanie zapisana maska średników;
+ * @param controls - wskaźnik, pod który zostanie zapisana maska znaków
+ * sterujących.
+ */
+typedef void (*ScanKernel)(const char *text, unsigned size,
+        uint64_t *semicolons, uint64_t *controls);
+
+/**@brief Wybiera wersję wyznaczania masek dla napisu o podanej długości.
+ * Wersja wektorowa jest wybierana, jeśli procesor ją obsługuje, a napis ma
+ * co najmniej VECTOR_SCAN_MIN znaków.
+ * @param size - długość przeglądanego napisu.
+ * @return Zwraca wskaźnik na funkcję wyznaczającą maski.
+ */
+ScanKernel chooseScanKernel(size_t size);
+
+/**@brief Włącza lub wyłącza wektorowe wyznaczanie masek.
+ * Zmiana dotyczy kolejnych wywołań chooseScanKernel() i nie może być
+ * wykonywana równolegle z nimi.
+ * @param enabled - informacja, czy wolno używać wersji wektorowych.
+ * @return Zwraca @p true, jeśli kolejne wywołania będą używać wersji
+ * wektorowej dla długich napisów. W przeciwnym razie zwraca @p false.
+ */
+bool setVectorScanning(bool enabled);
+
+/**@brief Podaje numer najmłodszego ustawionego bitu maski.
+ * @param mask - niezerowa maska.
+ * @return Zwraca numer najmłodszego ustawionego bitu.
+ */
+unsigned lowestBit(uint64_t mask);
+
+/**@brief Sprawdza, czy napis nie zawiera średników ani znaków sterujących.
+ * @param text - wskaźnik na napis;
+ * @param size - długość napisu.
+ * @return Zwraca @p true, jeśli żaden ze znaków napisu nie jest średnikiem ani
+ * znakiem o kodzie od 0 do 31 innym niż '\n'. W przeciwnym razie zwraca
+ * @p false.
+ */
+bool plainText(const char *text, size_t size);
+
+#endif //DROGI_SCAN_H
@@ -97,6 +97,8 @@ Road *newRoad(int year, unsigned length) {
   new->previous1 = NULL;
   new->previous2 = NULL;
   new->routes = NULL;
+  new->adjacentIndex1 = 0;
+  new->adjacentIndex2 = 0;
   return new;
 }
 
@@ -162,6 +164,22 @@ void modifyRoute(RoadList *newRoads, City *newEnd, Route *route) {
   route->length = pair.value1;
 }
 
+void modifyRouteStart(RoadList *newRoads, City *newStart, Route *route) {
+  RoadList *reversed = NULL;
+  while (newRoads) {
+    RoadList *next = newRoads->next;
+    newRoads->next = reversed;
+    reversed = newRoads;
+    newRoads = next;
+  }
+  Pair pair = lengthAndOldestRoad(reversed, route->rotueID, route);
+  findEnd(reversed)->next = route->roads;
+  route->roads = reversed;
+  route->city1 = newStart;
+  route->oldestRoad = pair.value2;
+  route->length = pair.value1;
+}
+
 /**@brief Szuka poprzedniego elementu list.
  * Szuka element listy poprzedzający element zawierający podany odcinek drogi.
  * @param head - początek listy, w której znajduje się szukany element;
@@ -256,8 +274,78 @@ void removeRouteFromList(Route *route, RouteList **head) {
         free(temp);
         break;
       }
-      temp = temp->next;
       prev = temp;
+      temp = temp->next;
     }
   }
-}
\ No newline at end of file
+}
+
+///Początkowy rozmiar tablicy sąsiedztwa miasta.
+#define ADJACENT_INITIAL_SIZE 4
+
+bool addAdjacentRoad(City *city, Road *road) {
+  if (city->degree == city->adjacentSize) {
+    unsigned newSize = city->adjacentSize ? 2 * city->adjacentSize :
+            ADJACENT_INITIAL_SIZE;
+    Road **newAdjacent = realloc(city->adjacent, newSize * sizeof(Road *));
+    if (!newAdjacent) {
+      return false;
+    }
+    city->adjacent = newAdjacent;
+    city->adjacentSize = newSize;
+  }
+  if (road->city1 == city) {
+    road->adjacentIndex1 = city->degree;
+  }
+  else {
+    road->adjacentIndex2 = city->degree;
+  }
+  city->adjacent[(city->degree)++] = road;
+  return true;
+}
+
+void removeAdjacentRoad(City *city, Road *road) {
+  unsigned position = (road->city1 == city) ? road->adjacentIndex1 :
+          road->adjacentIndex2;
+  Road *last = city->adjacent[--(city->degree)];
+  city->adjacent[position] = last;
+  if (last->city1 == city) {
+    last->adjacentIndex1 = position;
+  }
+  else {
+    last->adjacentIndex2 = position;
+  }
+}
+
+ReachableCities *newReachableCities() {
+  ReachableCities *new = malloc(sizeof(ReachableCities));
+  if (!new) {
+    return NULL;
+  }
+  new->cities = NULL;
+  new->number = 0;
+  new->size = 0;
+  return new;
+}
+
+bool reserveReachableCities(ReachableCities *result, unsigned number) {
+  result->number = 0;
+  if (result->size >= number) {
+    return true;
+  }
+  ReachedCity *newCities = realloc(result->cities,
+          number * sizeof(ReachedCity));
+  if (!newCities) {
+    return false;
+  }
+  result->cities = newCities;
+  result->size = number;
+  return true;
+}
+
+void freeReachableCities(ReachableCities *result) {
+  if (result) {
+    free(result->cities);
+    free(result);
+  }
+}
@@ -13,6 +13,26 @@
 ///Maksymalna ilość dróg krajowych plus jeden (0 jest niepoprawnym numerem).
 #define ROUTES_NUMBER 1000
 
+/**
+ * Struktura opisująca sprawdzoną nazwę miasta: niepustą i niezawierającą
+ * znaków o kodach od 0 do 31 ani średnika.
+ */
+typedef struct CityKey {
+  const char *name; ///< Nazwa miasta zakończona znakiem '\0'.
+  unsigned length; ///< Długość nazwy.
+  unsigned index; ///< Indeks nazwy wyznaczony funkcją cityIndex().
+} CityKey;
+
+/**
+ * Struktura opisująca odcinek drogi podany w opisie drogi krajowej.
+ */
+typedef struct RouteSegment {
+  CityKey city1; ///< Nazwa miasta, z którego wychodzi odcinek.
+  CityKey city2; ///< Nazwa miasta, do którego prowadzi odcinek.
+  unsigned length; ///< Długość odcinka.
+  int lastRepair; ///< Rok budowy lub ostatniego remontu odcinka.
+} RouteSegment;
+
 /**
  * Struktura przechowująca odcinek drogi.
  */
@@ -69,6 +89,8 @@ struct Road {
   unsigned length; ///< Długość odcinka.
   int lastRepair; ///< Data ostatniego remontu odcinka.
   RouteList *routes; ///< Lista dróg krajowych zawierających odcinek.
+  unsigned adjacentIndex1; ///< Pozycja w tablicy sąsiedztwa pierwszego miasta.
+  unsigned adjacentIndex2; ///< Pozycja w tablicy sąsiedztwa drugiego miasta.
 };
 
 /**
@@ -79,9 +101,13 @@ struct City {
   const char *name; ///< Wskaźnik na napis reprezentujący nazwę miasta.
   RoadHashMap *roads; ///< Wskaźnik na hashmapę dróg wychodzących z miasta.
 
-  ///Indeks w tablicy miast używanej przy wyznaczaniu drogi krajowej.
+  ///Indeks w tablicy miast używanej przy wyznaczaniu drogi krajowej. Nadawany
+  ///przy tworzeniu miasta kolejno od 0 i niezmienny przez cały czas jego życia.
   unsigned citiesArrayIndex;
   bool *routesPassing; ///< Tablica dróg krajowych przechodzących przez miasto.
+  Road **adjacent; ///< Tablica odcinków dróg wychodzących z miasta.
+  unsigned degree; ///< Liczba odcinków dróg wychodzących z miasta.
+  unsigned adjacentSize; ///< Rozmiar zaalokowanej tablicy sąsiedztwa.
 };
 
 /**
@@ -120,6 +146,28 @@ struct RouteList {
   RouteList *next; ///< Następny element.
 };
 
+/**
+ * Struktura opisująca miasto osiągnięte podczas przeszukiwania mapy.
+ */
+typedef struct ReachedCity {
+  City *city; ///< Wskaźnik na osiągnięte miasto.
+  unsigned distance; ///< Odległość miasta od startu.
+  int oldestRoad; ///< Data remontu najstarszego odcinka na drodze od startu.
+  City *previous; ///< Poprzednie miasto na drodze od startu (NULL dla startu).
+  Road *connection; ///< Odcinek drogi łączący miasto z poprzednim.
+} ReachedCity;
+
+/**
+ * Struktura przechowująca wynik przeszukiwania mapy z jednego miasta. Pamięć
+ * jest zachowywana pomiędzy kolejnymi wyszukiwaniami i powiększana tylko wtedy,
+ * gdy mapa urosła.
+ */
+typedef struct ReachableCities {
+  ReachedCity *cities; ///< Osiągnięte miasta w kolejności rosnącej odległości.
+  unsigned number; ///< Liczba osiągniętych miast.
+  unsigned size; ///< Rozmiar zaalokowanej tablicy miast.
+} ReachableCities;
+
 /** @brief Tworzy nową strukturę.
  * Alokuje pamięć potrzebną do stworzenia pustego struktury CityList.
  * @return Zwraca wskaźnik zaalokowaną pamięć lub NULL w przypadku, gdy nie
@@ -217,6 +265,16 @@ RoadList *findEnd(RoadList *head);
  */
 void modifyRoute(RoadList *newRoads, City *newEnd, Route *route);
 
+/**@brief Modyfikuje drogę krajową od strony początku.
+ * Modyfikuje istniejącą drogę krajową wydłużając ją przed jej początkiem
+ * o podaną listę odcinków dróg. Zakłada poprawność parametrów.
+ * @param newRoads - lista odcinków dróg od początku drogi krajowej do nowego
+ * początku; kolejność elementów listy zostaje odwrócona;
+ * @param newStart - miasto będące nowym początkiem drogi krajowej;
+ * @param route - modyfikowana droga.
+ */
+void modifyRouteStart(RoadList *newRoads, City *newStart, Route *route);
+
 /**Zwalnia pamięć, która zotała zaalokowana na każdy odcinek drogi znajdujący
  * się w liście. Następnie zwalnia samą listę.
  * @param head - wskaźnik na początek listy odcinków dróg.
@@ -284,4 +342,47 @@ void deleteRouteList(RouteList *head);
  */
 void removeRouteFromList(Route *route, RouteList **head);
 
+/**@brief Dodaje odcinek drogi do tablicy sąsiedztwa.
+ * Dopisuje odcinek drogi na koniec tablicy sąsiedztwa miasta będącego jednym z
+ * jego końców, w razie potrzeby powiększając tablicę. Zapamiętuje w odcinku
+ * jego pozycję w tablicy.
+ * @param city - wskaźnik na miasto będące jednym z końców odcinka;
+ * @param road - wskaźnik na odcinek drogi.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci. W przeciwnym
+ * razie zwraca @p true.
+ */
+bool addAdjacentRoad(City *city, Road *road);
+
+/**@brief Usuwa odcinek drogi z tablicy sąsiedztwa.
+ * Na miejsce usuwanego odcinka wstawia ostatni odcinek z tablicy sąsiedztwa
+ * miasta i poprawia zapamiętaną w nim pozycję.
+ * @param city - wskaźnik na miasto będące jednym z końców odcinka;
+ * @param road - wskaźnik na usuwany odcinek drogi.
+ */
+void removeAdjacentRoad(City *city, Road *road);
+
+/**@brief Tworzy nową strukturę.
+ * Tworzy pustą strukturę wyniku przeszukiwania mapy.
+ * @return Zwraca wskaźnik na utworzoną strukturę lub NULL, jeśli nie udało się
+ * zaalokować pamięci.
+ */
+ReachableCities *newReachableCities();
+
+/**@brief Przygotowuje strukturę na podaną liczbę miast.
+ * Powiększa tablicę osiągniętych miast, jeśli jest mniejsza niż podana liczba,
+ * i zeruje liczbę osiągniętych miast.
+ * @param result - wskaźnik na strukturę wyniku;
+ * @param number - liczba miast, które mogą zostać osiągnięte.
+ * @return Zwraca @p false, jeśli nie udało się zaalokować pamięci. W przeciwnym
+ * razie zwraca @p true.
+ */
+bool reserveReachableCities(ReachableCities *result, unsigned number);
+
+/**@brief Usuwa strukturę.
+ * Zwalnia pamięć zaalokowaną na wynik przeszukiwania mapy. Nie usuwa miast ani
+ * odcinków dróg.
+ * @param result - wskaźnik na strukturę wyniku.
+ */
+void freeReachableCities(ReachableCities *result);
+
 #endif //DROGI_STRUCTURES_H
@@ -0,0 +1,181 @@
+/**@file
+ * Implementacja thread_pool.h.
+ *
+ * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
+ * @date 01.09.2019
+ */
+
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "thread_pool.h"
+
+///Liczba prób sprawdzenia bariery przed uśpieniem wątku.
+#define SPIN_LIMIT 4096
+
+/**
+ * Struktura przechowująca pulę wątków.
+ */
+struct ThreadPool {
+  pthread_t *threads; ///< Tablica wątków pomocniczych.
+  unsigned number; ///< Liczba wątków razem z wątkiem wywołującym.
+  pthread_mutex_t mutex; ///< Zamek chroniący stan puli.
+  pthread_cond_t start; ///< Zmienna warunkowa dla wątków czekających na zadanie.
+  pthread_cond_t finish; ///< Zmienna warunkowa dla oczekiwania na koniec zadania.
+  ParallelTask task; ///< Bieżące zadanie.
+  void *data; ///< Dane bieżącego zadania.
+  unsigned round; ///< Numer bieżącego zadania.
+  unsigned running; ///< Liczba wątków pomocniczych wykonujących zadanie.
+  bool stop; ///< Informacja, czy wątki mają się zakończyć.
+  atomic_uint arrived; ///< Liczba wątków, które dotarły do bariery.
+  atomic_uint generation; ///< Numer bieżącego przejścia przez barierę.
+  pthread_cond_t barrier; ///< Zmienna warunkowa dla wątków czekających w barierze.
+};
+
+/**
+ * Argument wątku pomocniczego.
+ */
+typedef struct Worker {
+  ThreadPool *pool; ///< Wskaźnik na pulę.
+  unsigned thread; ///< Numer wątku.
+} Worker;
+
+/**
+ * Główna pętla wątku pomocniczego: czeka na kolejne zadania i je wykonuje.
+ * @param argument - wskaźnik na strukturę @p Worker, którą zwalnia.
+ * @return Zwraca NULL.
+ */
+static void *workerLoop(void *argument) {
+  Worker *worker = argument;
+  ThreadPool *pool = worker->pool;
+  unsigned thread = worker->thread;
+  free(worker);
+  unsigned seen = 0;
+  pthread_mutex_lock(&(pool->mutex));
+  while (true) {
+    while (!pool->stop && pool->round == seen) {
+      pthread_cond_wait(&(pool->start), &(pool->mutex));
+    }
+    if (pool->stop) {
+      break;
+    }
+    seen = pool->round;
+    ParallelTask task = pool->task;
+    void *data = pool->data;
+    pthread_mutex_unlock(&(pool->mutex));
+    task(thread, pool->number, data);
+    pthread_mutex_lock(&(pool->mutex));
+    if (--(pool->running) == 0) {
+      pthread_cond_signal(&(pool->finish));
+    }
+  }
+  pthread_mutex_unlock(&(pool->mutex));
+  return NULL;
+}
+
+ThreadPool *newThreadPool(unsigned threads) {
+  ThreadPool *pool = malloc(sizeof(ThreadPool));
+  if (!pool) {
+    return NULL;
+  }
+  pool->number = threads > 1 ? threads : 1;
+  pool->threads = malloc(pool->number * sizeof(pthread_t));
+  if (!pool->threads) {
+    free(pool);
+    return NULL;
+  }
+  pthread_mutex_init(&(pool->mutex), NULL);
+  pthread_cond_init(&(pool->start), NULL);
+  pthread_cond_init(&(pool->finish), NULL);
+  pthread_cond_init(&(pool->barrier), NULL);
+  atomic_init(&(pool->arrived), 0);
+  atomic_init(&(pool->generation), 0);
+  pool->task = NULL;
+  pool->data = NULL;
+  pool->round = 0;
+  pool->running = 0;
+  pool->stop = false;
+  for (unsigned i = 1; i < pool->number; i++) {
+    Worker *worker = malloc(sizeof(Worker));
+    if (worker) {
+      worker->pool = pool;
+      worker->thread = i;
+    }
+    if (!worker ||
+        pthread_create(&(pool->threads[i]), NULL, workerLoop, worker) != 0) {
+      free(worker);
+      pool->number = i;
+      freeThreadPool(pool);
+      return NULL;
+    }
+  }
+  return pool;
+}
+
+void freeThreadPool(ThreadPool *pool) {
+  if (pool) {
+    pthread_mutex_lock(&(pool->mutex));
+    pool->stop = true;
+    pthread_cond_broadcast(&(pool->start));
+    pthread_mutex_unlock(&(pool->mutex));
+    for (unsigned i = 1; i < pool->number; i++) {
+      pthread_join(pool->threads[i], NULL);
+    }
+    pthread_cond_destroy(&(pool->barrier));
+    pthread_cond_destroy(&(pool->finish));
+    pthread_cond_destroy(&(pool->start));
+    pthread_mutex_destroy(&(pool->mutex));
+    free(pool->threads);
+    free(pool);
+  }
+}
+
+unsigned threadsNumber(ThreadPool *pool) {
+  return pool ? pool->number : 1;
+}
+
+void runParallel(ThreadPool *pool, ParallelTask task, void *data) {
+  if (!pool || pool->number == 1) {
+    task(0, 1, data);
+    return;
+  }
+  pthread_mutex_lock(&(pool->mutex));
+  pool->task = task;
+  pool->data = data;
+  pool->running = pool->number - 1;
+  (pool->round)++;
+  pthread_cond_broadcast(&(pool->start));
+  pthread_mutex_unlock(&(pool->mutex));
+  task(0, pool->number, data);
+  pthread_mutex_lock(&(pool->mutex));
+  while (pool->running > 0) {
+    pthread_cond_wait(&(pool->finish), &(pool->mutex));
+  }
+  pthread_mutex_unlock(&(pool->mutex));
+}
+
+void waitForThreads(ThreadPool *pool) {
+  if (!pool || pool->number == 1) {
+    return;
+  }
+  unsigned generation = atomic_load(&(pool->generation));
+  if (atomic_fetch_add(&(pool->arrived), 1) + 1 == pool->number) {
+    atomic_store(&(pool->arrived), 0);
+    pthread_mutex_lock(&(pool->mutex));
+    atomic_fetch_add(&(pool->generation), 1);
+    pthread_cond_broadcast(&(pool->barrier));
+    pthread_mutex_unlock(&(pool->mutex));
+    return;
+  }
+  for (unsigned i = 0; i < SPIN_LIMIT; i++) {
+    if (atomic_load(&(pool->generation)) != generation) {
+      return;
+    }
+  }
+  pthread_mutex_lock(&(pool->mutex));
+  while (atomic_load(&(pool->generation)) == generation) {
+    pthread_cond_wait(&(pool->barrier), &(pool->mutex));
+  }
+  pthread_mutex_unlock(&(pool->mutex));
+}
@@ -0,0 +1,67 @@
+/** @file
+ * Interfejs puli wątków wykonującej zadania w modelu SPMD: każdy wątek
+ * wykonuje tę samą funkcję dla innego numeru wątku.
+ *
+ * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
+ * @date 01.09.2019
+ */
+
+#ifndef DROGI_THREAD_POOL_H
+#define DROGI_THREAD_POOL_H
+
+#include <stdbool.h>
+
+/**
+ * Struktura przechowująca pulę wątków.
+ */
+typedef struct ThreadPool ThreadPool;
+
+/**
+ * Zadanie wykonywane równolegle przez wszystkie wątki puli.
+ * @param thread - numer wątku, od 0 do @p threads - 1;
+ * @param threads - liczba wątków wykonujących zadanie;
+ * @param data - wskaźnik na dane zadania.
+ */
+typedef void (*ParallelTask)(unsigned thread, unsigned threads, void *data);
+
+/**@brief Tworzy nową pulę wątków.
+ * Uruchamia @p threads - 1 wątków pomocniczych; wątek wywołujący funkcję
+ * @ref runParallel jest wątkiem o numerze 0.
+ * @param threads - liczba wątków; 0 jest traktowane jak 1.
+ * @return Zwraca wskaźnik na utworzoną strukturę lub NULL, jeśli nie udało się
+ * zaalokować pamięci lub uruchomić wątków.
+ */
+ThreadPool *newThreadPool(unsigned threads);
+
+/**@brief Usuwa pulę wątków.
+ * Kończy wątki pomocnicze i zwalnia całą zaalokowaną pamięć.
+ * @param pool - wskaźnik na usuwaną strukturę.
+ */
+void freeThreadPool(ThreadPool *pool);
+
+/**@brief Podaje liczbę wątków puli.
+ * @param pool - wskaźnik na strukturę puli.
+ * @return Zwraca liczbę wątków razem z wątkiem wywołującym lub 1, jeśli
+ * wskaźnik ma wartość NULL.
+ */
+unsigned threadsNumber(ThreadPool *pool);
+
+/**@brief Wykonuje zadanie na wszystkich wątkach.
+ * Wywołuje podaną funkcję w każdym wątku puli, także w wątku wywołującym,
+ * i czeka, aż wszystkie wywołania się zakończą. Jeśli pula ma wartość NULL,
+ * wykonuje zadanie jednowątkowo.
+ * @param pool - wskaźnik na strukturę puli lub NULL;
+ * @param task - wykonywane zadanie;
+ * @param data - wskaźnik na dane zadania.
+ */
+void runParallel(ThreadPool *pool, ParallelTask task, void *data);
+
+/**@brief Synchronizuje wątki wykonujące zadanie.
+ * Może być wywołana tylko wewnątrz zadania uruchomionego przez
+ * @ref runParallel i musi zostać wywołana przez wszystkie wątki. Wraca, gdy
+ * wszystkie wątki do niej dotrą.
+ * @param pool - wskaźnik na strukturę puli lub NULL.
+ */
+void waitForThreads(ThreadPool *pool);
+
+#endif //DROGI_THREAD_POOL_H
@@ -0,0 +1,198 @@
+/**@file
+ * Implementacja tree_cache.h.
+ *
+ * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
+ * @date 01.09.2019
+ */
+
+#include <stdlib.h>
+
+#include "tree_cache.h"
+#include "dijkstra.h"
+
+/**
+ * Struktura przechowująca jedno wstrzymane wyszukiwanie.
+ */
+typedef struct Tree {
+  City *start; ///< Miasto początkowe lub NULL, jeśli miejsce jest wolne.
+  SearchState *state; ///< Stan wyszukiwania lub NULL przed pierwszym użyciem.
+  unsigned long long lastUse; ///< Numer zapytania, w którym ostatnio użyto.
+  bool claimed; ///< Informacja, czy wyszukiwanie jest zarezerwowane.
+} Tree;
+
+/**
+ * Struktura przechowująca pamięć podręczną wyszukiwań.
+ */
+struct TreeCache {
+  Tree trees[TREE_CACHE_SIZE]; ///< Przechowywane wyszukiwania.
+  unsigned long long queries; ///< Liczba dotychczasowych zapytań.
+};
+
+TreeCache *newTreeCache(void) {
+  return calloc(1, sizeof(TreeCache));
+}
+
+void freeTreeCache(TreeCache *cache) {
+  if (cache) {
+    for (unsigned i = 0; i < TREE_CACHE_SIZE; i++) {
+      freeSearchState(cache->trees[i].state);
+    }
+    free(cache);
+  }
+}
+
+/**
+ * Wyznacza, ile wyszukiwań może przechowywać pamięć przy obecnej liczbie
+ * miast, i zwalnia stany wyszukiwań, które się w tej liczbie nie mieszczą.
+ * @param cache - wskaźnik na strukturę pamięci;
+ * @param hashMap - hashmapa miast.
+ * @return Zwraca liczbę dostępnych miejsc na wyszukiwania.
+ */
+static unsigned treeLimit(TreeCache *cache, CityHashMap *hashMap) {
+  unsigned cities = numberOfCities(hashMap);
+  unsigned limit = cities > 0 ? TREE_CACHE_CITIES / cities : TREE_CACHE_SIZE;
+  if (limit > TREE_CACHE_SIZE) {
+    limit = TREE_CACHE_SIZE;
+  }
+  if (limit == 0) {
+    limit = 1;
+  }
+  for (unsigned i = limit; i < TREE_CACHE_SIZE; i++) {
+    freeSearchState(cache->trees[i].state);
+    cache->trees[i].state = NULL;
+    cache->trees[i].start = NULL;
+  }
+  return limit;
+}
+
+/**
+ * Szuka wyszukiwania z podanego miasta albo miejsca na nowe wyszukiwanie.
+ * Zarezerwowane miejsca nie są zajmowane przez nowe wyszukiwania.
+ * @param cache - wskaźnik na strukturę pamięci;
+ * @param start - miasto początkowe;
+ * @param limit - liczba dostępnych miejsc.
+ * @return Zwraca wskaźnik na wyszukiwanie z podanego miasta, a jeśli go nie
+ * ma - na wolne lub najdawniej używane niezarezerwowane miejsce albo NULL,
+ * jeśli wszystkie miejsca są zarezerwowane.
+ */
+static Tree *findTree(TreeCache *cache, City *start, unsigned limit) {
+  Tree *oldest = NULL;
+  for (unsigned i = 0; i < limit; i++) {
+    Tree *tree = &(cache->trees[i]);
+    if (tree->start == start) {
+      return tree;
+    }
+    if (tree->claimed) {
+      continue;
+    }
+    if (!oldest || (!tree->start && oldest->start)) {
+      oldest = tree;
+    }
+    else if ((!tree->start) == (!oldest->start) &&
+             tree->lastUse < oldest->lastUse) {
+      oldest = tree;
+    }
+  }
+  return oldest;
+}
+
+/**
+ * Szuka wyszukiwania z podanego miasta, a jeśli go nie ma - rozpoczyna je
+ * w miejscu zwróconym przez findTree().
+ * @param cache - wskaźnik na strukturę pamięci;
+ * @param start - miasto początkowe;
+ * @param hashMap - hashmapa miast.
+ * @return Zwraca wskaźnik na wyszukiwanie lub NULL, jeśli wszystkie miejsca
+ * są zarezerwowane albo nie udało się zaalokować pamięci.
+ */
+static Tree *useTree(TreeCache *cache, City *start, CityHashMap *hashMap) {
+  Tree *tree = findTree(cache, start, treeLimit(cache, hashMap));
+  if (!tree) {
+    return NULL;
+  }
+  if (tree->start != start) {
+    tree->start = NULL;
+    if (!tree->state && !(tree->state = newSearchState())) {
+      return NULL;
+    }
+    if (!startSearch(tree->state, start, hashMap)) {
+      return NULL;
+    }
+    tree->start = start;
+  }
+  tree->lastUse = ++(cache->queries);
+  return tree;
+}
+
+/**
+ * Wznawia przechowywane wyszukiwanie do podanego miasta końcowego.
+ * @param tree - wskaźnik na wyszukiwanie;
+ * @param finish - miasto końcowe;
+ * @param hashMap - hashmapa miast;
+ * @param status - wskaźnik, pod który zostanie zapisany wynik wyszukiwania.
+ * @return Zwraca listę odcinków dróg lub NULL, jeśli drogi nie wyznaczono.
+ */
+static RoadList *resumeTree(Tree *tree, City *finish, CityHashMap *hashMap,
+                            int *status) {
+  RoadList *roadList = resumeSearch(tree->state, finish, hashMap, status);
+  if (*status == SEARCH_ERROR) {
+    tree->start = NULL;
+  }
+  return roadList;
+}
+
+RoadList *findTreeRoute(TreeCache *cache, City *start, City *finish,
+                        CityHashMap *hashMap, int *status) {
+  *status = SEARCH_ERROR;
+  if (!cache || !start || !finish) {
+    return NULL;
+  }
+  Tree *tree = useTree(cache, start, hashMap);
+  if (!tree) {
+    return NULL;
+  }
+  return resumeTree(tree, finish, hashMap, status);
+}
+
+int claimTree(TreeCache *cache, City *start, CityHashMap *hashMap) {
+  if (!cache || !start) {
+    return NO_TREE;
+  }
+  Tree *tree = useTree(cache, start, hashMap);
+  if (!tree || tree->claimed) {
+    return NO_TREE;
+  }
+  tree->claimed = true;
+  return (int) (tree - cache->trees);
+}
+
+RoadList *findClaimedRoute(TreeCache *cache, int tree, City *finish,
+                           CityHashMap *hashMap, int *status) {
+  *status = SEARCH_ERROR;
+  if (!cache || tree < 0 || tree >= TREE_CACHE_SIZE || !finish ||
+      !cache->trees[tree].start) {
+    return NULL;
+  }
+  return resumeTree(&(cache->trees[tree]), finish, hashMap, status);
+}
+
+void releaseTrees(TreeCache *cache) {
+  if (cache) {
+    for (unsigned i = 0; i < TREE_CACHE_SIZE; i++) {
+      cache->trees[i].claimed = false;
+    }
+  }
+}
+
+void invalidateTrees(TreeCache *cache, City *city1, City *city2) {
+  if (!cache) {
+    return;
+  }
+  for (unsigned i = 0; i < TREE_CACHE_SIZE; i++) {
+    Tree *tree = &(cache->trees[i]);
+    if (tree->start && (isSettled(tree->state, city1) ||
+                        isSettled(tree->state, city2))) {
+      tree->start = NULL;
+    }
+  }
+}
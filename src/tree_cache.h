@@ -0,0 +1,105 @@
+/** @file
+ * Interfejs pamięci podręcznej wstrzymanych wyszukiwań z wybranych miast.
+ *
+ * Dla kilku ostatnio używanych miast początkowych pamięć przechowuje stan
+ * wyszukiwania, które zatrzymało się po sprawdzeniu poprzedniego miasta
+ * końcowego. Kolejne zapytanie z tego samego miasta wznawia wyszukiwanie
+ * zamiast zaczynać je od nowa. Zmiana odcinka drogi usuwa tylko te
+ * wyszukiwania, które sprawdziły już któryś z jego końców.
+ *
+ * @author Anna Kalisz <ak406173@students.mimuw.edu.pl>
+ * @date 01.09.2019
+ */
+
+#ifndef DROGI_TREE_CACHE_H
+#define DROGI_TREE_CACHE_H
+
+#include <stdbool.h>
+#include "structures.h"
+#include "city_hashmap.h"
+
+///Największa liczba przechowywanych wyszukiwań.
+#define TREE_CACHE_SIZE 8
+///Największa łączna liczba miast we wszystkich przechowywanych wyszukiwaniach.
+#define TREE_CACHE_CITIES (1u << 20)
+///Numer wyszukiwania oznaczający, że żadne nie zostało zarezerwowane.
+#define NO_TREE -1
+
+/**
+ * Struktura przechowująca pamięć podręczną wyszukiwań.
+ */
+typedef struct TreeCache TreeCache;
+
+/**@brief Tworzy nową strukturę.
+ * Stany wyszukiwań są tworzone przy pierwszym użyciu.
+ * @return Zwraca wskaźnik na utworzoną strukturę lub NULL, jeśli nie udało się
+ * zaalokować pamięci.
+ */
+TreeCache *newTreeCache(void);
+
+/**@brief Usuwa strukturę.
+ * Zwalnia całą pamięć zaalokowaną przez strukturę.
+ * @param cache - wskaźnik na usuwaną strukturę.
+ */
+void freeTreeCache(TreeCache *cache);
+
+/**@brief Szuka najlepszej drogi, wznawiając wyszukiwanie z miasta początkowego.
+ * Jeśli w pamięci nie ma wyszukiwania z podanego miasta, rozpoczyna je
+ * w miejscu najdawniej używanego. Wynik jest taki sam jak wynik
+ * findBestRouteLimited() bez zabronionej drogi krajowej i bez ograniczeń.
+ * Każde wyszukiwanie zajmuje pamięć proporcjonalną do liczby miast, więc
+ * pamięć przechowuje najwyżej TREE_CACHE_CITIES / (liczba miast) wyszukiwań,
+ * ale co najmniej jedno.
+ * @param cache - wskaźnik na strukturę pamięci;
+ * @param start - miasto początkowe;
+ * @param finish - miasto końcowe;
+ * @param hashMap - hashmapa miast;
+ * @param status - wskaźnik, pod który zostanie zapisany wynik wyszukiwania.
+ * @return Zwraca listę odcinków dróg lub NULL, jeśli drogi nie wyznaczono.
+ */
+RoadList *findTreeRoute(TreeCache *cache, City *start, City *finish,
+                        CityHashMap *hashMap, int *status);
+
+/**@brief Rezerwuje wyszukiwanie z miasta początkowego.
+ * Szuka wyszukiwania z podanego miasta albo rozpoczyna je tak jak
+ * findTreeRoute(), ale nie zajmuje miejsc już zarezerwowanych. Zarezerwowane
+ * wyszukiwanie można wznowić funkcją findClaimedRoute(). Wznawianie różnych
+ * zarezerwowanych wyszukiwań może odbywać się równolegle, jeśli w tym czasie
+ * nie jest wywoływana żadna inna funkcja tej struktury.
+ * @param cache - wskaźnik na strukturę pamięci;
+ * @param start - miasto początkowe;
+ * @param hashMap - hashmapa miast.
+ * @return Zwraca numer zarezerwowanego wyszukiwania lub NO_TREE, jeśli
+ * wyszukiwanie z podanego miasta jest już zarezerwowane, wszystkie miejsca są
+ * zarezerwowane albo nie udało się zaalokować pamięci.
+ */
+int claimTree(TreeCache *cache, City *start, CityHashMap *hashMap);
+
+/**@brief Szuka najlepszej drogi, wznawiając zarezerwowane wyszukiwanie.
+ * Wynik jest taki sam jak wynik findTreeRoute() dla miasta początkowego
+ * zarezerwowanego wyszukiwania.
+ * @param cache - wskaźnik na strukturę pamięci;
+ * @param tree - numer wyszukiwania zwrócony przez claimTree();
+ * @param finish - miasto końcowe;
+ * @param hashMap - hashmapa miast;
+ * @param status - wskaźnik, pod który zostanie zapisany wynik wyszukiwania.
+ * @return Zwraca listę odcinków dróg lub NULL, jeśli drogi nie wyznaczono.
+ */
+RoadList *findClaimedRoute(TreeCache *cache, int tree, City *finish,
+                           CityHashMap *hashMap, int *status);
+
+/**@brief Zwalnia rezerwacje wszystkich wyszukiwań.
+ * @param cache - wskaźnik na strukturę pamięci.
+ */
+void releaseTrees(TreeCache *cache);
+
+/**@brief Usuwa wyszukiwania, na które wpływa zmiana odcinka drogi.
+ * Należy wywołać przed dodaniem, usunięciem lub zmianą daty remontu odcinka
+ * drogi łączącego podane miasta.
+ * @param cache - wskaźnik na strukturę pamięci;
+ * @param city1 - pierwsze miasto odcinka drogi;
+ * @param city2 - drugie miasto odcinka drogi.
+ */
+void invalidateTrees(TreeCache *cache, City *city1, City *city2);
+
+#endif //DROGI_TREE_CACHE_H
@@ -0,0 +1,11 @@
+#!/bin/sh
+# Uruchamia program map na pliku $2.in i porównuje jego standardowe wyjście
+# oraz wyjście diagnostyczne z plikami $2.out i $2.err.
+# Użycie: run_test.sh <program map> <ścieżka testu bez rozszerzenia>
+output=$(mktemp) || exit 1
+errors=$(mktemp) || exit 1
+"$1" < "$2.in" > "$output" 2> "$errors"
+diff "$2.out" "$output" && diff "$2.err" "$errors"
+result=$?
+rm -f "$output" "$errors"
+exit $result